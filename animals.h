@@ -0,0 +1,79 @@
+#ifndef EFFECTIVECPP_ANIMALS_H
+#define EFFECTIVECPP_ANIMALS_H
+
+/*
+ * The animals of the hana examples: plain Fish/Cat/Dog, and SFish/SCat/SDog that
+ * also know how to serialize() themselves (see smart_serialize.h).
+ * Fish/Cat/Dog are adapted as hana Structs, so soa_vector and friends can see their members;
+ * so are SFish/SCat/SDog, which is what lets them be fast_hash keys (memoize.h).
+ * IFish/ICat/IDog hold an interned name (istring, intern_pool.h): 4 bytes per animal,
+ * == and hashing on the name id; they print exactly like the plain ones.
+ */
+#include <boost/hana.hpp>
+#include "utils.h"
+#include "intern_pool.h"
+
+
+struct Fish { string name; };
+struct Cat  { string name; };
+struct Dog  { string name; };
+
+BOOST_HANA_ADAPT_STRUCT(Fish, name);
+BOOST_HANA_ADAPT_STRUCT(Cat, name);
+BOOST_HANA_ADAPT_STRUCT(Dog, name);
+
+struct IFish { istring name; };
+struct ICat  { istring name; };
+struct IDog  { istring name; };
+
+BOOST_HANA_ADAPT_STRUCT(IFish, name);
+BOOST_HANA_ADAPT_STRUCT(ICat, name);
+BOOST_HANA_ADAPT_STRUCT(IDog, name);
+
+inline bool operator==(const IFish& a, const IFish& b) noexcept { return a.name == b.name; }
+inline bool operator==(const ICat& a, const ICat& b) noexcept { return a.name == b.name; }
+inline bool operator==(const IDog& a, const IDog& b) noexcept { return a.name == b.name; }
+
+struct SFish : public Fish {
+    string serialize() const {
+        return "Fish-serial:" + name;
+    }
+};
+struct SCat : public Cat {
+    string serialize() const {
+        return "Cat-serial:" + name;
+    }
+};
+struct SDog : public Dog {
+    string serialize() const {
+        return "Dog-serial:" + name;
+    }
+};
+
+BOOST_HANA_ADAPT_STRUCT(SFish, name);
+BOOST_HANA_ADAPT_STRUCT(SCat, name);
+BOOST_HANA_ADAPT_STRUCT(SDog, name);
+
+
+inline ostream& operator<<(ostream& oss, const Fish& x) {
+    return oss << "Fish(" << x.name << ")";
+}
+inline ostream& operator<<(ostream& oss, const Cat& x) noexcept {
+    return oss << "Cat(" << x.name << ")";
+}
+inline ostream& operator<<(ostream& oss, const Dog& x) noexcept {
+    return oss << "Dog(" << x.name << ")";
+}
+
+inline ostream& operator<<(ostream& oss, const IFish& x) {
+    return oss << "Fish(" << x.name << ")";
+}
+inline ostream& operator<<(ostream& oss, const ICat& x) {
+    return oss << "Cat(" << x.name << ")";
+}
+inline ostream& operator<<(ostream& oss, const IDog& x) {
+    return oss << "Dog(" << x.name << ")";
+}
+
+
+#endif //EFFECTIVECPP_ANIMALS_H
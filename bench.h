@@ -0,0 +1,67 @@
+#ifndef EFFECTIVECPP_BENCH_H
+#define EFFECTIVECPP_BENCH_H
+
+/*
+ * Tiny wall-clock benchmark helpers shared by the bench_*.cpp programs.
+ * Not a replacement for google-benchmark, but good enough to compare two
+ * implementations of the same loop side by side.
+ */
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+/*
+ * Keep the optimizer from deleting a computation whose result we never use.
+ * Same trick as benchmark::DoNotOptimize.
+ */
+template<typename T>
+inline void do_not_optimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+/*
+ * assert() is compiled out in Release builds, which is the only way the
+ * benchmarks are worth running, so correctness checks go through this instead
+ */
+inline void bench_check(bool ok, const std::string& what) {
+    if (!ok) {
+        throw std::runtime_error("bench check failed: " + what);
+    }
+}
+
+// run f() `reps` times and return the best wall time in milliseconds
+template<typename F>
+double time_ms(F&& f, int reps = 3) {
+    using clock = std::chrono::steady_clock;
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        auto start = clock::now();
+        f();
+        clobber_memory();
+        std::chrono::duration<double, std::milli> elapsed = clock::now() - start;
+        if (elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+/*
+ * Print one benchmark row: name, best time and time per item.
+ * `items` is how many logical operations a single f() call performs.
+ */
+template<typename F>
+double bench(const std::string& name, size_t items, F&& f, int reps = 3) {
+    double ms = time_ms(std::forward<F>(f), reps);
+    std::printf("  %-44s %10.3f ms %10.3f ns/item\n",
+                name.c_str(), ms, items ? ms * 1e6 / items : 0.0);
+    return ms;
+}
+
+#endif //EFFECTIVECPP_BENCH_H
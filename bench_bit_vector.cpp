@@ -0,0 +1,95 @@
+/*
+ * Benchmark: bit_vector against the equivalent vector<bool> loops
+ * (set bits, count, iterate set bits, AND two vectors, rank queries).
+ */
+#include <algorithm>
+#include <random>
+#include "utils.h"
+#include "bench.h"
+#include "bit_vector.h"
+
+
+int main() {
+    constexpr size_t N = 50'000'000;
+    constexpr size_t QUERIES = 1'000'000;
+    std::mt19937_64 rng(5);
+    vector<size_t> positions(N / 8);
+    for (auto& p : positions) p = rng() % N;
+    vector<size_t> queries(QUERIES);
+    for (auto& q : queries) q = rng() % N;
+
+    vector<bool> va(N), vb(N);
+    bit_vector ba(N), bb(N);
+    for (size_t i = 0; i < N; i += 3) {
+        vb[i] = true;
+        bb.set(i);
+    }
+
+    ptitle("set " + to_string(positions.size()) + " random bits");
+    bench("vector<bool>[i] = true", positions.size(), [&] {
+        for (auto p : positions) va[p] = true;
+    });
+    bench("bit_vector::set(i)", positions.size(), [&] {
+        for (auto p : positions) ba.set(p);
+    });
+    for (size_t i = 0; i < N; i += 9973) bench_check(va[i] == ba.test(i), "same bits after set");
+
+    size_t expected = static_cast<size_t>(std::count(va.begin(), va.end(), true));
+    bench_check(ba.count() == expected, "count");
+
+    ptitle("count set bits in " + to_string(N));
+    bench("std::count(vector<bool>)", N, [&] {
+        do_not_optimize(std::count(va.begin(), va.end(), true));
+    });
+    bench("bit_vector::count()", N, [&] { do_not_optimize(ba.count()); });
+
+    ptitle("visit every set bit");
+    bench("vector<bool> index loop", N, [&] {
+        size_t sum = 0;
+        for (size_t i = 0; i < N; ++i) {
+            if (va[i]) sum += i;
+        }
+        do_not_optimize(sum);
+    });
+    bench("bit_vector find_first/find_next", N, [&] {
+        size_t sum = 0;
+        for (size_t i = ba.find_first(); i != bit_vector::npos; i = ba.find_next(i)) sum += i;
+        do_not_optimize(sum);
+    });
+
+    ptitle("a &= b over " + to_string(N) + " bits");
+    vector<bool> vc = va;
+    bit_vector bc = ba;
+    bench("vector<bool> element-wise", N, [&] {
+        for (size_t i = 0; i < N; ++i) vc[i] = vc[i] && vb[i];
+    }, 1);
+    bench("bit_vector::operator&=", N, [&] { bc &= bb; }, 1);
+    for (size_t i = 0; i < N; i += 7919) bench_check(vc[i] == bc.test(i), "same bits after and");
+
+    ptitle("rank over " + to_string(N) + " bits");
+    bit_rank_select rs(ba);
+    bench_check(rs.rank(N) == expected, "rank(size) == count");
+    for (size_t k = 0; k < expected; k += expected / 97 + 1) {
+        size_t pos = rs.select(k);
+        bench_check(ba.test(pos) && rs.rank(pos) == k, "select is the inverse of rank");
+    }
+    bench("vector<bool> prefix count, 100 queries", 100, [&] {
+        size_t sum = 0;
+        for (size_t q = 0; q < 100; ++q) {
+            sum += static_cast<size_t>(std::count(va.begin(), va.begin() + queries[q], true));
+        }
+        do_not_optimize(sum);
+    }, 1);
+    bench("bit_rank_select::rank", QUERIES, [&] {
+        size_t sum = 0;
+        for (auto q : queries) sum += rs.rank(q);
+        do_not_optimize(sum);
+    });
+    bench("bit_rank_select::select", QUERIES, [&] {
+        size_t sum = 0;
+        for (auto q : queries) sum += rs.select(q % expected);
+        do_not_optimize(sum);
+    });
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Benchmark: UserInfo records (item 10) as vector<tuple<string, string, int>>
+ * against the columnar Table<UserInfoFields, string, string, int>.
+ * Scans over the score column, filters, top-k and row-wise email access.
+ */
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include "utils.h"
+#include "bench.h"
+#include "columnar_table.h"
+
+
+using UserInfo = tuple<string, string, int>;  // name, email, score
+enum UserInfoFields {uiName, uiEmail, uiScore};
+using UserTable = Table<UserInfoFields, string, string, int>;
+
+
+int main() {
+    constexpr size_t N = 2'000'000;
+    constexpr int THRESHOLD = 900'000;
+    constexpr size_t K = 10;
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> score(0, 1'000'000), len(5, 12), ch('a', 'z');
+    vector<UserInfo> rows;
+    rows.reserve(N);
+    UserTable table;
+    table.reserve(N);
+    for (size_t i = 0; i < N; ++i) {
+        string name;
+        for (int j = len(rng); j > 0; --j) name.push_back(static_cast<char>(ch(rng)));
+        string email = name + "." + to_string(i) + "@example.com";  // past the SSO limit
+        rows.emplace_back(name, email, score(rng));
+        table.push_back(rows.back());
+    }
+    vector<size_t> order(N);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::shuffle(order.begin(), order.end(), rng);
+
+    // correctness against the tuple code
+    long long ref_sum = 0, ref_high_sum = 0;
+    size_t ref_high = 0;
+    for (auto& r : rows) {
+        ref_sum += std::get<uiScore>(r);
+        if (std::get<uiScore>(r) > THRESHOLD) {
+            ++ref_high;
+            ref_high_sum += std::get<uiScore>(r);
+        }
+    }
+    bench_check(table.sum<uiScore>() == ref_sum, "sum");
+    auto high = table.where<uiScore>([](int s) { return s > THRESHOLD; });
+    bench_check(high.count() == ref_high && table.sum<uiScore>(high) == ref_high_sum, "filter + masked sum");
+    bench_check(table.sum<uiScore>(table.where<uiScore>([](int) { return true; })) == ref_sum, "full mask sum");
+    bench_check(table.max<uiScore>() == std::get<uiScore>(*std::max_element(rows.begin(), rows.end(),
+        [](auto& a, auto& b) { return std::get<uiScore>(a) < std::get<uiScore>(b); })), "max");
+    auto top = table.top_k<uiScore>(K);
+    vector<int> ref_scores;
+    for (auto& r : rows) ref_scores.push_back(std::get<uiScore>(r));
+    std::partial_sort(ref_scores.begin(), ref_scores.begin() + K, ref_scores.end(), std::greater<>());
+    for (size_t i = 0; i < K; ++i) bench_check(table.get<uiScore>(top[i]) == ref_scores[i], "top-k");
+    for (size_t i = 0; i < N; i += 7919) {
+        bench_check(get<uiEmail>(table[i]) == std::get<uiEmail>(rows[i]) && UserInfo(table[i]) == rows[i],
+                    "row round trip");
+    }
+
+    size_t aos_bytes = rows.capacity() * sizeof(UserInfo);
+    for (auto& r : rows) {
+        for (auto* s : {&std::get<uiName>(r), &std::get<uiEmail>(r)}) {
+            if (s->size() > 15) aos_bytes += s->capacity() + 1;
+        }
+    }
+    cout << "memory: vector<tuple> " << aos_bytes / (1 << 20) << " MB, Table "
+         << table.memory_bytes() / (1 << 20) << " MB" << endl;
+
+    ptitle("sum of scores, " + to_string(N) + " rows");
+    bench("vector<tuple> loop", N, [&] {
+        long long s = 0;
+        for (auto& r : rows) s += std::get<uiScore>(r);
+        do_not_optimize(s);
+    });
+    bench("Table::sum<uiScore>", N, [&] { do_not_optimize(table.sum<uiScore>()); });
+
+    ptitle("count and sum where score > " + to_string(THRESHOLD));
+    bench("vector<tuple> loop", N, [&] {
+        long long s = 0;
+        size_t n = 0;
+        for (auto& r : rows) {
+            int v = std::get<uiScore>(r);
+            if (v > THRESHOLD) {
+                ++n;
+                s += v;
+            }
+        }
+        do_not_optimize(s);
+        do_not_optimize(n);
+    });
+    bench("Table::where + count + sum(mask)", N, [&] {
+        auto mask = table.where<uiScore>([](int s) { return s > THRESHOLD; });
+        do_not_optimize(mask.count());
+        do_not_optimize(table.sum<uiScore>(mask));
+    });
+
+    bench("  Table::where only", N, [&] {
+        do_not_optimize(table.where<uiScore>([](int s) { return s > THRESHOLD; }).data());
+    });
+    bench("  Table::sum(mask) only", N, [&] { do_not_optimize(table.sum<uiScore>(high)); });
+
+    ptitle("top-" + to_string(K) + " scores");
+    bench("vector<tuple> partial_sort of indices", N, [&] {
+        vector<size_t> idx(N);
+        std::iota(idx.begin(), idx.end(), size_t{0});
+        std::partial_sort(idx.begin(), idx.begin() + K, idx.end(), [&](size_t a, size_t b) {
+            return std::get<uiScore>(rows[a]) > std::get<uiScore>(rows[b]);
+        });
+        do_not_optimize(idx.data());
+    });
+    bench("Table::top_k<uiScore>", N, [&] { do_not_optimize(table.top_k<uiScore>(K).data()); });
+
+    ptitle("random row access, email length");
+    bench("std::get<uiEmail>(rows[i])", N, [&] {
+        size_t total = 0;
+        for (auto i : order) total += std::get<uiEmail>(rows[i]).size();
+        do_not_optimize(total);
+    });
+    bench("get<uiEmail>(table[i])", N, [&] {
+        size_t total = 0;
+        for (auto i : order) total += get<uiEmail>(table[i]).size();
+        do_not_optimize(total);
+    });
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Benchmark: compile-time lookup tables (constexpr_math.h) against the
+ * runtime computations they replace.
+ */
+#include <cmath>
+#include <random>
+#include "utils.h"
+#include "bench.h"
+#include "constexpr_math.h"
+
+
+// the old ch3_constexpr pow, with the base/exp mixup fixed: one multiply per exp
+constexpr long long linear_pow(long long base, unsigned exp) noexcept {
+    long long result = 1;
+    for (unsigned i = 0; i < exp; ++i) {
+        result *= base;
+    }
+    return result;
+}
+
+static_assert(ipow(3LL, 39) == linear_pow(3, 39));
+static_assert(ipow(-2, 31) == std::numeric_limits<int>::min());
+static_assert(*checked_pow(-2, 31) == std::numeric_limits<int>::min());
+static_assert(!checked_pow(2, 31));
+static_assert(!checked_pow(std::uint8_t{16}, 2));
+static_assert(ipow(std::uint16_t{255}, 3) == static_cast<std::uint16_t>(255u * 255u * 255u));  // wraps, no int overflow
+static_assert(ipow(std::int8_t{-3}, 5) == static_cast<std::int8_t>(-243));
+static_assert(pow_table<std::uint16_t, 255>()[2] == 65025);
+static_assert(max_exponent(10) == 9);
+static_assert(max_exponent(std::uint64_t{2}) == 63);
+
+constexpr auto POW3 = pow_table<long long, 3>();  // 3**0 ... 3**39
+constexpr auto RECIP = reciprocal_table<1024>();
+constexpr size_t SIN_N = 4096;
+constexpr auto SIN_Q15 = sin_q15_table<SIN_N>();
+
+static_assert(POW3.size() == 40 && POW3[39] == 4052555153018976267LL);
+static_assert(SIN_Q15[0] == 0 && SIN_Q15[SIN_N / 4] == 32767 && SIN_Q15[3 * SIN_N / 4] == -32767);
+
+
+int main() {
+    constexpr size_t N = 10'000'000;
+    std::mt19937 rng(42);
+
+    vector<unsigned> exps(N);
+    std::uniform_int_distribution<unsigned> exp_dist(0, POW3.size() - 1);
+    for (auto& e : exps) e = exp_dist(rng);
+
+    vector<unsigned> divisors(N);
+    vector<double> numerators(N);
+    std::uniform_int_distribution<unsigned> div_dist(1, RECIP.size() - 1);
+    std::uniform_real_distribution<double> num_dist(-1000, 1000);
+    for (size_t i = 0; i < N; ++i) {
+        divisors[i] = div_dist(rng);
+        numerators[i] = num_dist(rng);
+    }
+
+    vector<unsigned> phases(N);
+    for (auto& p : phases) p = rng();
+
+    // sanity check the trig table against <cmath>
+    int max_err = 0;
+    for (size_t i = 0; i < SIN_N; ++i) {
+        int ref = static_cast<int>(std::lround(std::sin(2 * PI * i / SIN_N) * 32767.0));
+        max_err = std::max(max_err, std::abs(ref - SIN_Q15[i]));
+    }
+    cout << "max |constexpr sin table - std::sin| in Q15 units: " << max_err << endl;
+    bench_check(max_err <= 1, "sin_q15_table accuracy");
+
+    ptitle("integer power, " + to_string(N) + " random exponents in [0, 39]");
+    bench("linear pow (exp multiplies)", N, [&] {
+        long long sum = 0;
+        for (auto e : exps) sum += linear_pow(3, e);
+        do_not_optimize(sum);
+    });
+    bench("ipow (exponentiation by squaring)", N, [&] {
+        long long sum = 0;
+        for (auto e : exps) sum += ipow(3LL, e);
+        do_not_optimize(sum);
+    });
+    bench("std::pow on double", N, [&] {
+        double sum = 0;
+        for (auto e : exps) sum += std::pow(3.0, static_cast<double>(e));
+        do_not_optimize(sum);
+    });
+    bench("pow_table<long long, 3> lookup", N, [&] {
+        long long sum = 0;
+        for (auto e : exps) sum += POW3[e];
+        do_not_optimize(sum);
+    });
+
+    ptitle("division, " + to_string(N) + " random divisors in [1, 1023]");
+    bench("x / d", N, [&] {
+        double sum = 0;
+        for (size_t i = 0; i < N; ++i) sum += numerators[i] / divisors[i];
+        do_not_optimize(sum);
+    });
+    bench("x * reciprocal_table[d]", N, [&] {
+        double sum = 0;
+        for (size_t i = 0; i < N; ++i) sum += numerators[i] * RECIP[divisors[i]];
+        do_not_optimize(sum);
+    });
+
+    ptitle("fixed-point sine, " + to_string(N) + " random phases");
+    bench("std::sin scaled to Q15", N, [&] {
+        long sum = 0;
+        for (auto p : phases) {
+            sum += std::lround(std::sin(2 * PI * (p % SIN_N) / SIN_N) * 32767.0);
+        }
+        do_not_optimize(sum);
+    });
+    bench("sin_q15_table lookup", N, [&] {
+        long sum = 0;
+        for (auto p : phases) sum += SIN_Q15[p & (SIN_N - 1)];
+        do_not_optimize(sum);
+    });
+
+    return 0;
+}
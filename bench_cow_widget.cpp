@@ -0,0 +1,164 @@
+/*
+ * Benchmark: Widget's values buffer (1M doubles, 8 MB) handed around the old way,
+ * where every copy and every get() on a temporary was a deep vector copy, against
+ * the copy-on-write Widget from widget.h.
+ */
+#include "utils.h"
+#include "bench.h"
+#include "widget.h"
+
+
+using Data = Widget::DataType;
+
+// the old item 12 Widget: plain member, const&& get() whose std::move silently copies
+class PlainWidget {
+public:
+    explicit PlainWidget(Data values)
+    : values(std::move(values))
+    {}
+    Data get() const && { return std::move(values); }
+    const Data& view() const { return values; }
+
+private:
+    Data values;
+};
+
+
+size_t copies() { return cow<Data>::deep_copies.load(); }
+
+
+// an element that counts its copies, to see what the cow does to the elements themselves
+struct counted {
+    counted() = default;
+    counted(const counted&) { ++copies; }
+    counted(counted&&) noexcept = default;
+    counted& operator=(const counted&) { ++copies; return *this; }
+    counted& operator=(counted&&) noexcept = default;
+    static inline size_t copies = 0;
+};
+
+
+int main() {
+    Widget::print_enabled = false;
+    constexpr size_t N = 1'000'000;
+    constexpr size_t ROUNDS = 50;
+    const Data source(N, 1.5);
+
+    // correctness: count the element-buffer copies each operation makes
+    {
+        size_t before = copies();
+        Widget w(source);
+        Widget w2 = w;
+        auto snap = w.snapshot();
+        bench_check(copies() == before && snap.use_count() == 3, "copies and snapshots share");
+        w.get()[0] = 2.0;
+        bench_check(copies() == before + 1 && snap.read()[0] == 1.5 && w2.view()[0] == 1.5,
+                    "writing detaches exactly once and leaves the others alone");
+        w.get()[1] = 2.0;
+        bench_check(copies() == before + 1, "a second write on a detached buffer is free");
+        auto out = std::move(w).get();
+        bench_check(copies() == before + 1 && out.size() == N && out[0] == 2.0, "&& on the sole owner moves");
+        auto out2 = std::move(w2).get();
+        bench_check(copies() == before + 2 && out2[0] == 1.5, "&& on a shared buffer copies");
+        const SubWidget cw(source);
+        auto out3 = std::move(cw).get();
+        bench_check(copies() == before + 2 && out3.size() == N && cw.view().size() == N,
+                    "const&& copies the vector without touching the cow");
+    }
+    {
+        Widget w(source);
+        auto& data = w.get();
+        size_t before = copies();
+        auto snap = w.snapshot();
+        Widget w2 = w;
+        data[0] = 3.0;
+        bench_check(copies() == before + 2 && snap.read()[0] == 1.5 && w2.view()[0] == 1.5,
+                    "after get() &, copies and snapshots clone instead of aliasing the reference");
+    }
+    {
+        cow<vector<counted>> a(vector<counted>(100));
+        counted::copies = 0;
+        cow<vector<counted>> b = a;
+        bench_check(counted::copies == 0 && b.read().size() == 100, "sharing copies no element");
+        b.write();
+        bench_check(counted::copies == 100, "a detach copies every element once");
+        b.write();
+        a.write();
+        bench_check(counted::copies == 100, "writing to a sole owner copies nothing");
+        auto out = std::move(a).take();
+        bench_check(counted::copies == 100 && out.size() == 100, "take() from a sole owner moves");
+        cow<vector<counted>> c = b;  // b handed out a T&: unshareable
+        bench_check(counted::copies == 200, "copying an unshareable handle copies the elements");
+    }
+    {
+        static_assert(std::is_nothrow_move_constructible_v<Widget> && std::is_nothrow_move_assignable_v<Widget>);
+        Widget w(source);
+        w.get()[0] = 4.0;  // unshareable from here on
+        size_t before = copies();
+        Widget moved = std::move(w);
+        Widget assigned;
+        assigned = std::move(moved);
+        bench_check(copies() == before && assigned.view().size() == N && assigned.view()[0] == 4.0,
+                    "moving a Widget never clones the buffer");
+    }
+
+    ptitle("get() on a temporary, " + to_string(N) + " doubles");
+    bench("old const&& get() (copies)", ROUNDS, [&] {
+        for (size_t r = 0; r < ROUNDS; ++r) {
+            PlainWidget w(source);  // one copy to build, same as below
+            auto out = std::move(w).get();
+            do_not_optimize(out.data());
+        }
+    }, 1);
+    bench("cow && get() (moves)", ROUNDS, [&] {
+        for (size_t r = 0; r < ROUNDS; ++r) {
+            Widget w(source);
+            auto out = std::move(w).get();
+            do_not_optimize(out.data());
+        }
+    }, 1);
+
+    ptitle("hand a Widget to 8 readers");
+    PlainWidget plain(source);
+    Widget shared(source);
+    bench("old Widget copy x8", ROUNDS, [&] {
+        for (size_t r = 0; r < ROUNDS; ++r) {
+            for (int i = 0; i < 8; ++i) {
+                PlainWidget copy = plain;
+                do_not_optimize(copy.view().data());
+            }
+        }
+    }, 1);
+    size_t before = copies();
+    bench("cow Widget copy x8", ROUNDS, [&] {
+        for (size_t r = 0; r < ROUNDS; ++r) {
+            for (int i = 0; i < 8; ++i) {
+                Widget copy = shared;
+                do_not_optimize(copy.view().data());
+            }
+        }
+    }, 1);
+    bench_check(copies() == before, "read-only copies never clone");
+
+    ptitle("snapshot, then mutate one element");
+    bench("old: copy then write", ROUNDS, [&] {
+        for (size_t r = 0; r < ROUNDS; ++r) {
+            Data snap = plain.view();
+            PlainWidget copy = plain;
+            do_not_optimize(snap.data());
+            do_not_optimize(copy.view().data());
+        }
+    }, 1);
+    before = copies();
+    bench("cow: snapshot then write", ROUNDS, [&] {
+        for (size_t r = 0; r < ROUNDS; ++r) {
+            auto snap = shared.snapshot();
+            Widget copy = shared;
+            copy.get()[0] = static_cast<double>(r);
+            do_not_optimize(snap.read().data());
+        }
+    }, 1);
+    bench_check(copies() == before + ROUNDS, "exactly one detach per round");
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * Benchmark: enum_from_string / enum_to_string against the runtime maps config and
+ * wire parsing use today, for a 40-field config enum. Random field names, one in
+ * eight of them unknown.
+ */
+#include "utils.h"
+#include "bench.h"
+#include <map>
+#include <random>
+#include <unordered_map>
+#include "enum_reflect.h"
+
+
+enum class config_key {
+    listen_address, listen_port, backlog, max_connections, read_timeout_ms, write_timeout_ms,
+    idle_timeout_ms, keepalive, tcp_nodelay, send_buffer, recv_buffer, worker_threads,
+    io_threads, queue_depth, log_level, log_file, log_rotate_mb, access_log, tls_enabled,
+    tls_cert, tls_key, tls_ciphers, tls_min_version, compression, compression_level,
+    cache_size_mb, cache_ttl_s, upstream_host, upstream_port, upstream_retries,
+    retry_backoff_ms, health_check_path, health_check_interval_s, metrics_enabled,
+    metrics_port, tracing_sample_rate, rate_limit_rps, rate_limit_burst, auth_token, user_agent
+};
+
+
+int main() {
+    using traits = enum_traits<config_key>;
+
+    // what the code does today: maps built from a hand-written name list
+    std::map<string, config_key> ordered;
+    std::unordered_map<string, config_key> hashed;
+    std::map<config_key, string> names;
+    for (auto k : traits::values) {
+        string name(enum_to_string(k));
+        ordered.emplace(name, k);
+        hashed.emplace(name, k);
+        names.emplace(k, name);
+    }
+
+    // correctness
+    {
+        bench_check(traits::count == 40, "all 40 enumerators found");
+        bench_check(enum_to_string(config_key::listen_address) == "listen_address"
+                    && enum_to_string(config_key::user_agent) == "user_agent", "names");
+        for (auto k : traits::values) {
+            bench_check(enum_from_string<config_key>(enum_to_string(k)) == k, "round trip");
+        }
+        for (string miss : {"", "listen", "listen_address_", "LISTEN_ADDRESS", "user_agenT"}) {
+            bench_check(!enum_from_string<config_key>(miss), "unknown name " + miss);
+        }
+        bench_check(enum_to_string(static_cast<config_key>(99)).empty(), "no name for a non-enumerator");
+
+        enum sparse : short { a = -100, b = 7, c = 120 };
+        bench_check(enum_traits<sparse>::count == 3 && enum_to_string(b) == "b"
+                    && enum_from_string<sparse>("a") == a, "sparse plain enum");
+        enum_array<sparse, int> per {};
+        per[c] = 3;
+        per[a] = 1;
+        bench_check(per.size() == 3 && per.data[0] == 1 && per.data[2] == 3, "enum_array slots in value order");
+
+        // same length, first and last 8 bytes: only the all-bytes hash tells these apart
+        static constexpr std::array<std::string_view, 2> alike {"prefix__A__suffix", "prefix__B__suffix"};
+        static constexpr perfect_hash<2> alike_index {alike};
+        bench_check(alike_index.hashes_all_bytes() && alike_index.find("prefix__B__suffix") == 1
+                    && alike_index.find("prefix__C__suffix") == 2, "perfect_hash falls back to all bytes");
+    }
+
+    constexpr size_t N = 1'000'000;
+    std::mt19937 rng(7);
+    vector<string> input(N);
+    vector<config_key> keys(N);
+    for (size_t i = 0; i < N; ++i) {
+        keys[i] = traits::values[rng() % traits::count];
+        input[i] = rng() % 8 == 0 ? "unknown_field" : string(enum_to_string(keys[i]));
+    }
+
+    ptitle("from_string, " + to_string(N) + " names");
+    bench("std::map<string, E>", N, [&] {
+        long s = 0;
+        for (auto& name : input) {
+            auto it = ordered.find(name);
+            s += it == ordered.end() ? -1 : static_cast<long>(it->second);
+        }
+        do_not_optimize(s);
+    });
+    bench("unordered_map<string, E>", N, [&] {
+        long s = 0;
+        for (auto& name : input) {
+            auto it = hashed.find(name);
+            s += it == hashed.end() ? -1 : static_cast<long>(it->second);
+        }
+        do_not_optimize(s);
+    });
+    bench("enum_from_string (perfect hash)", N, [&] {
+        long s = 0;
+        for (auto& name : input) {
+            auto k = enum_from_string<config_key>(name);
+            s += k ? static_cast<long>(*k) : -1;
+        }
+        do_not_optimize(s);
+    });
+
+    ptitle("to_string, " + to_string(N) + " values");
+    bench("std::map<E, string>", N, [&] {
+        size_t s = 0;
+        for (auto k : keys) s += names.find(k)->second.size();
+        do_not_optimize(s);
+    });
+    bench("enum_to_string (array)", N, [&] {
+        size_t s = 0;
+        for (auto k : keys) s += enum_to_string(k).size();
+        do_not_optimize(s);
+    });
+}
@@ -0,0 +1,143 @@
+/*
+ * Benchmark: flat_hash_map<string, int> against unordered_map<string, int>
+ * on insert, lookup (std::string, string_view, miss), erase and iteration.
+ */
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include "utils.h"
+#include "bench.h"
+#include "flat_hash_map.h"
+
+
+// short identifier-like keys, the typical config/field-name workload
+vector<string> make_keys(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> len(6, 20), ch('a', 'z');
+    vector<string> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        string k = "key_" + to_string(i) + "_";
+        for (int j = len(rng); j > 0; --j) k.push_back(static_cast<char>(ch(rng)));
+        keys.push_back(std::move(k));
+    }
+    return keys;
+}
+
+
+int main() {
+    constexpr size_t N = 1'000'000;
+    auto keys = make_keys(N, 1);
+    auto misses = make_keys(N, 2);
+    for (auto& m : misses) m[0] = 'K';  // disjoint from keys
+    vector<std::string_view> key_views(keys.begin(), keys.end());
+    vector<size_t> order(N);
+    for (size_t i = 0; i < N; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(3));
+
+    // correctness: random insert/erase against unordered_map
+    {
+        std::mt19937 rng(4);
+        unordered_map<int, int> ref;
+        flat_hash_map<int, int> flat;
+        for (int step = 0; step < 200'000; ++step) {
+            int k = static_cast<int>(rng() % 5000);
+            if (rng() % 3 == 0) {
+                bench_check(ref.erase(k) == flat.erase(k), "erase agrees");
+            }
+            else {
+                ref[k] += step;
+                flat[k] += step;
+            }
+        }
+        bench_check(ref.size() == flat.size(), "size agrees");
+        for (auto& [k, v] : ref) bench_check(flat.at(k) == v, "value agrees");
+        size_t visited = 0;
+        for (auto& kv : flat) visited += ref.count(kv.first);
+        bench_check(visited == ref.size(), "iteration visits every element once");
+
+        // the value comes from the map itself, through every rehash
+        flat_hash_map<int, string> self;
+        self.try_emplace(0, "a_value_longer_than_the_sso_buffer");
+        for (int i = 1; i < 1000; ++i) {
+            self.try_emplace(i, self.at(0));
+            self.emplace(-i, self.at(i - 1));
+        }
+        bool all_same = true;
+        for (auto& kv : self) all_same = all_same && kv.second == "a_value_longer_than_the_sso_buffer";
+        bench_check(self.size() == 1999 && all_same, "inserting a value that lives in the map");
+    }
+
+    unordered_map<string, int> umap;
+    flat_hash_map<string, int> fmap;
+
+    ptitle("insert " + to_string(N) + " string keys");
+    bench("unordered_map::try_emplace", N, [&] {
+        umap = {};
+        for (size_t i = 0; i < N; ++i) umap.try_emplace(keys[i], static_cast<int>(i));
+    }, 1);
+    bench("flat_hash_map::try_emplace", N, [&] {
+        fmap = {};
+        for (size_t i = 0; i < N; ++i) fmap.try_emplace(keys[i], static_cast<int>(i));
+    }, 1);
+    bench("flat_hash_map::try_emplace after reserve", N, [&] {
+        fmap = {};
+        fmap.reserve(N);
+        for (size_t i = 0; i < N; ++i) fmap.try_emplace(keys[i], static_cast<int>(i));
+    }, 1);
+
+    ptitle("lookup, random order");
+    bench("unordered_map::find(std::string)", N, [&] {
+        long sum = 0;
+        for (auto i : order) sum += umap.find(keys[i])->second;
+        do_not_optimize(sum);
+    });
+    bench("flat_hash_map::find(std::string)", N, [&] {
+        long sum = 0;
+        for (auto i : order) sum += fmap.find(keys[i])->second;
+        do_not_optimize(sum);
+    });
+    bench("unordered_map::find(string(string_view))", N, [&] {
+        long sum = 0;
+        for (auto i : order) sum += umap.find(string(key_views[i]))->second;
+        do_not_optimize(sum);
+    });
+    bench("flat_hash_map::find(string_view)", N, [&] {
+        long sum = 0;
+        for (auto i : order) sum += fmap.find(key_views[i])->second;
+        do_not_optimize(sum);
+    });
+    bench("unordered_map::find, miss", N, [&] {
+        size_t found = 0;
+        for (auto& k : misses) found += umap.count(k);
+        do_not_optimize(found);
+    });
+    bench("flat_hash_map::find, miss", N, [&] {
+        size_t found = 0;
+        for (auto& k : misses) found += fmap.count(k);
+        do_not_optimize(found);
+    });
+
+    ptitle("iterate all entries");
+    bench("unordered_map", N, [&] {
+        long sum = 0;
+        for (auto& [k, v] : umap) sum += v + static_cast<long>(k.size());
+        do_not_optimize(sum);
+    });
+    bench("flat_hash_map", N, [&] {
+        long sum = 0;
+        for (auto& [k, v] : fmap) sum += v + static_cast<long>(k.size());
+        do_not_optimize(sum);
+    });
+
+    ptitle("erase every other key");
+    bench("unordered_map::erase", N / 2, [&] {
+        for (size_t i = 0; i < N; i += 2) umap.erase(keys[order[i]]);
+    }, 1);
+    bench("flat_hash_map::erase", N / 2, [&] {
+        for (size_t i = 0; i < N; i += 2) fmap.erase(keys[order[i]]);
+    }, 1);
+    bench_check(umap.size() == fmap.size(), "same size after erase");
+
+    return 0;
+}
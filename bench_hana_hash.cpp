@@ -0,0 +1,178 @@
+/*
+ * Benchmark: fast_hash (hana_hash.h) against std::hash and the usual hand-written
+ * "combine the members' std::hash" functors, on realistic names and on records.
+ * Throughput, then collisions: full 64-bit, and in 2^20 buckets against what an
+ * ideal random hash would give.
+ */
+#include <cmath>
+#include <random>
+#include <unordered_set>
+#include "utils.h"
+#include "bench.h"
+#include "animals.h"
+#include "flat_hash_map.h"
+#include "hana_hash.h"
+
+
+using UserInfo = tuple<string, string, int>;  // name, email, score, as in ch3_enum
+
+struct GridCell {
+    BOOST_HANA_DEFINE_STRUCT(GridCell,
+        (int, x),
+        (int, y)
+    );
+};
+
+// what gets written by hand: boost::hash_combine over std::hash, or worse, xor
+struct UserInfoCombineHash {
+    size_t operator()(const UserInfo& u) const noexcept {
+        size_t h = std::hash<string>{}(get<0>(u));
+        h ^= std::hash<string>{}(get<1>(u)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<int>{}(get<2>(u)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+struct GridCellXorHash {
+    size_t operator()(const GridCell& c) const noexcept {
+        return std::hash<int>{}(c.x) ^ std::hash<int>{}(c.y);
+    }
+};
+struct GridCellEqual {
+    bool operator()(const GridCell& a, const GridCell& b) const noexcept { return a.x == b.x && a.y == b.y; }
+};
+
+
+vector<string> make_names(size_t n) {
+    static const char* first[] = {"james", "mary", "robert", "patricia", "john", "jennifer", "michael", "linda",
+                                  "david", "elizabeth", "william", "barbara", "richard", "susan", "joseph", "jessica"};
+    static const char* last[] = {"smith", "johnson", "williams", "brown", "jones", "garcia", "miller", "davis",
+                                 "rodriguez", "martinez", "hernandez", "lopez", "gonzalez", "wilson", "anderson"};
+    std::mt19937 rng(23);
+    vector<string> names;
+    names.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        names.push_back(string(first[rng() % 16]) + "." + last[rng() % 15] + to_string(i));
+    }
+    return names;
+}
+
+template<typename Keys, typename Hash>
+void report_collisions(const string& label, const Keys& keys, Hash hash) {
+    constexpr size_t BITS = 20, BUCKETS = size_t{1} << BITS;
+    std::unordered_set<size_t> full;
+    vector<char> used(BUCKETS);
+    size_t occupied = 0;
+    full.reserve(keys.size());
+    for (auto& k : keys) {
+        size_t h = hash(k);
+        full.insert(h);
+        // low bits: the bucket a power-of-two table without its own mixing would use
+        occupied += !used[h & (BUCKETS - 1)]++;
+    }
+    double n = static_cast<double>(keys.size());
+    double ideal = BUCKETS * (1 - std::pow(1 - 1.0 / BUCKETS, n));
+    printf("  %-34s %8zu full-width collisions, %8.0f bucket collisions (ideal %.0f)\n",
+           label.c_str(), keys.size() - full.size(), n - occupied, n - ideal);
+}
+
+
+int main() {
+    constexpr size_t N = 1'000'000;
+    auto names = make_names(N);
+    vector<UserInfo> users;
+    users.reserve(N);
+    for (size_t i = 0; i < N; ++i) {
+        users.emplace_back(names[i], names[i] + "@example.com", static_cast<int>(i % 1000));
+    }
+    vector<GridCell> cells;
+    for (int x = 0; x < 1000; ++x) {
+        for (int y = 0; y < 1000; ++y) cells.push_back(GridCell{x, y});
+    }
+
+    // correctness
+    {
+        bench_check(hash_value(string("nemo")) == hash_value(std::string_view("nemo")) &&
+                    hash_value(string("nemo")) == hash_value("nemo"), "strings hash by content");
+        bench_check(hash_value(0.0) == hash_value(-0.0), "-0.0 hashes like 0.0");
+        bench_check(hash_value(GridCell{1, 2}) != hash_value(GridCell{2, 1}), "member order matters");
+        bench_check(hash_value(std::make_pair(1, 2)) != hash_value(std::make_pair(2, 1)), "pair order matters");
+        bench_check(hash_value(vector<int>{1, 2, 3}) != hash_value(vector<int>{1, 2, 4}), "vector contents");
+        bench_check(hash_value(hana::make_tuple(1, string("a"))) == hash_value(std::make_tuple(1, string("a"))),
+                    "hana and std tuples agree");
+        bench_check(fast_equal<UserInfo>{}(users[5], users[5]) && !fast_equal<UserInfo>{}(users[5], users[6]),
+                    "tuple equality");
+        bench_check(fast_equal<Fish>{}(Fish{"a"}, Fish{"a"}) && !fast_equal<Fish>{}(Fish{"a"}, Fish{"b"}),
+                    "hana struct equality");
+        for (size_t len = 0; len < 200; ++len) {
+            string s(len, 'x');
+            uint64_t h = hash_value(s);
+            s.push_back('y');
+            bench_check(hash_value(s) != h, "every length path");
+        }
+
+        unordered_map<Fish, int, fast_hash<Fish>, fast_equal<Fish>> by_fish;
+        flat_hash_map<UserInfo, int, fast_hash<UserInfo>, fast_equal<UserInfo>> by_user;
+        for (size_t i = 0; i < 10'000; ++i) {
+            by_fish[Fish{names[i % 5000]}] += 1;
+            by_user[users[i]] = static_cast<int>(i);
+        }
+        bench_check(by_fish.size() == 5000 && by_fish[Fish{names[42]}] == 2, "unordered_map with fast_hash");
+        bench_check(by_user.size() == 10'000 && by_user[users[777]] == 777, "flat_hash_map with fast_hash");
+    }
+
+    ptitle("hash throughput, " + to_string(N) + " keys");
+    bench("std::hash<string> on names", N, [&] {
+        size_t h = 0;
+        for (auto& s : names) h += std::hash<string>{}(s);
+        do_not_optimize(h);
+    });
+    bench("fast_hash<string> on names", N, [&] {
+        size_t h = 0;
+        for (auto& s : names) h += fast_hash<string>{}(s);
+        do_not_optimize(h);
+    });
+    bench("hash_combine UserInfo", N, [&] {
+        size_t h = 0;
+        for (auto& u : users) h += UserInfoCombineHash{}(u);
+        do_not_optimize(h);
+    });
+    bench("fast_hash<UserInfo>", N, [&] {
+        size_t h = 0;
+        for (auto& u : users) h += fast_hash<UserInfo>{}(u);
+        do_not_optimize(h);
+    });
+    bench("xor GridCell", N, [&] {
+        size_t h = 0;
+        for (auto& c : cells) h += GridCellXorHash{}(c);
+        do_not_optimize(h);
+    });
+    bench("fast_hash<GridCell> (byte path)", N, [&] {
+        size_t h = 0;
+        for (auto& c : cells) h += fast_hash<GridCell>{}(c);
+        do_not_optimize(h);
+    });
+
+    ptitle("collisions, low 20 bits");
+    report_collisions("std::hash<string> names", names, std::hash<string>{});
+    report_collisions("fast_hash<string> names", names, fast_hash<string>{});
+    report_collisions("hash_combine UserInfo", users, UserInfoCombineHash{});
+    report_collisions("fast_hash<UserInfo>", users, fast_hash<UserInfo>{});
+    report_collisions("xor GridCell", cells, GridCellXorHash{});
+    report_collisions("fast_hash<GridCell>", cells, fast_hash<GridCell>{});
+
+    ptitle("unordered_set<GridCell>, 100000 inserts + lookups");
+    constexpr size_t M = 100'000;
+    bench("xor hash", M, [&] {
+        std::unordered_set<GridCell, GridCellXorHash, GridCellEqual> set(cells.begin(), cells.begin() + M);
+        size_t hits = 0;
+        for (size_t i = 0; i < M; ++i) hits += set.count(cells[i]);
+        do_not_optimize(hits);
+    });
+    bench("fast_hash", M, [&] {
+        std::unordered_set<GridCell, fast_hash<GridCell>, fast_equal<GridCell>> set(cells.begin(),
+                                                                                    cells.begin() + M);
+        size_t hits = 0;
+        for (size_t i = 0; i < M; ++i) hits += set.count(cells[i]);
+        do_not_optimize(hits);
+    });
+}
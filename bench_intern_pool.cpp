@@ -0,0 +1,135 @@
+/*
+ * Benchmark: plain Fish (own std::string) against IFish (interned istring) on
+ * memory, equality and hash-set lookups, plus intern() throughput from 1..4 threads.
+ */
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include "utils.h"
+#include "bench.h"
+#include "animals.h"
+#include "hana_hash.h"
+#include "intern_pool.h"
+
+
+// a few thousand distinct names, each repeated many times, like real object names
+vector<string> make_names(size_t n, size_t distinct) {
+    std::mt19937 rng(29);
+    vector<string> pool;
+    for (size_t i = 0; i < distinct; ++i) pool.push_back("reef_fish_species_" + to_string(i * 7919));
+    vector<string> names;
+    names.reserve(n);
+    for (size_t i = 0; i < n; ++i) names.push_back(pool[rng() % distinct]);
+    return names;
+}
+
+size_t string_heap(const string& s) {
+    return s.capacity() > 15 ? s.capacity() + 1 : 0;  // libstdc++ SSO holds 15 chars
+}
+
+
+int main() {
+    constexpr size_t N = 1'000'000;
+    constexpr size_t DISTINCT = 5000;
+    auto names = make_names(N, DISTINCT);
+
+    // correctness
+    {
+        intern_pool pool;
+        auto a = pool.intern("apple"), b = pool.intern(string("apple")), c = pool.intern("banana");
+        bench_check(a == b && a != c && pool.intern("") == 0, "same text, same id");
+        std::string_view va = pool.view(a);
+        const char* before = va.data();
+        for (int i = 0; i < 200'000; ++i) pool.intern("filler_" + to_string(i));
+        bench_check(pool.view(a).data() == before && pool.view(a) == "apple", "views never move");
+        bench_check(pool.view(pool.intern(string(100'000, 'x'))).size() == 100'000, "strings larger than a block");
+        intern_pool::id_type found;
+        bench_check(pool.find("banana", found) && found == c && !pool.find("cherry", found), "find without adding");
+
+        // four threads interning overlapping sets must agree on every id
+        intern_pool shared;
+        vector<vector<intern_pool::id_type>> ids(4);
+        vector<std::thread> threads;
+        for (size_t t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (size_t i = 0; i < 50'000; ++i) ids[t].push_back(shared.intern(names[(i * (t + 1)) % 50'000]));
+            });
+        }
+        for (auto& th : threads) th.join();
+        for (size_t t = 0; t < 4; ++t) {
+            for (size_t i = 0; i < 50'000; i += 97) {
+                bench_check(shared.view(ids[t][i]) == names[(i * (t + 1)) % 50'000], "concurrent intern");
+                bench_check(shared.intern(names[(i * (t + 1)) % 50'000]) == ids[t][i], "one id per string");
+            }
+        }
+        std::unordered_set<string> distinct(names.begin(), names.begin() + 50'000);
+        bench_check(shared.size() == distinct.size() + 1, "no duplicates under contention");
+
+        bench_check(IFish{"nemo"} == IFish{string("nemo")} && !(IFish{"nemo"} == IFish{"dory"}), "IFish ==");
+        bench_check(any_str(IFish{"nemo"}) == any_str(Fish{"nemo"}), "IFish prints like Fish");
+        bench_check(fast_hash<IFish>{}(IFish{"nemo"}) == fast_hash<IFish>{}(IFish{"nemo"}), "IFish hashes");
+    }
+
+    vector<Fish> fish;
+    vector<IFish> ifish;
+    fish.reserve(N);
+    ifish.reserve(N);
+    auto before = default_intern_pool().memory();
+    for (auto& n : names) {
+        fish.push_back(Fish{n});
+        ifish.push_back(IFish{n});
+    }
+    auto after = default_intern_pool().memory();
+
+    size_t fish_bytes = fish.capacity() * sizeof(Fish);
+    for (auto& f : fish) fish_bytes += string_heap(f.name);
+    size_t ifish_bytes = ifish.capacity() * sizeof(IFish);
+    ptitle("memory, " + to_string(N) + " fish with " + to_string(DISTINCT) + " distinct names");
+    cout << "  pool before: " << before << "\n";
+    cout << "  pool after:  " << after << "\n";
+    cout << "  vector<Fish>  " << fish_bytes / 1024 << " KB\n";
+    cout << "  vector<IFish> " << ifish_bytes / 1024 << " KB + pool growth "
+         << (after.total_bytes() - before.total_bytes()) / 1024 << " KB" << endl;
+
+    ptitle("intern() of known names, " + to_string(N) + " calls");
+    for (unsigned threads : {1u, 2u, 4u}) {
+        bench(to_string(threads) + " thread(s)", N, [&] {
+            vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    uint64_t sum = 0;
+                    for (size_t i = t; i < N; i += threads) sum += default_intern_pool().intern(names[i]);
+                    do_not_optimize(sum);
+                });
+            }
+            for (auto& w : workers) w.join();
+        });
+    }
+
+    ptitle("count fish equal to fish[0]");
+    bench("Fish (string ==)", N, [&] {
+        size_t n = 0;
+        for (auto& f : fish) n += f.name == fish[0].name;
+        do_not_optimize(n);
+    });
+    bench("IFish (id ==)", N, [&] {
+        size_t n = 0;
+        for (auto& f : ifish) n += f == ifish[0];
+        do_not_optimize(n);
+    });
+
+    ptitle("unordered_set of distinct fish, " + to_string(N) + " lookups");
+    std::unordered_set<Fish, fast_hash<Fish>, fast_equal<Fish>> fish_set(fish.begin(), fish.end());
+    std::unordered_set<IFish, fast_hash<IFish>, fast_equal<IFish>> ifish_set(ifish.begin(), ifish.end());
+    bench_check(fish_set.size() == DISTINCT && ifish_set.size() == DISTINCT, "distinct counts");
+    bench("Fish", N, [&] {
+        size_t hits = 0;
+        for (auto& f : fish) hits += fish_set.count(f);
+        do_not_optimize(hits);
+    });
+    bench("IFish", N, [&] {
+        size_t hits = 0;
+        for (auto& f : ifish) hits += ifish_set.count(f);
+        do_not_optimize(hits);
+    });
+}
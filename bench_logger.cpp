@@ -0,0 +1,136 @@
+/*
+ * Benchmark: caller-side cost of a log line, `out << ... << endl` on the calling
+ * thread against the logger from logger.h in synchronous and asynchronous mode.
+ * Lines go to /dev/null, so this is formatting + queueing + the write syscalls.
+ */
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include "utils.h"
+#include "bench.h"
+
+
+// per-call latency percentiles of f(i), i in [0, n)
+template<typename F>
+void latency(const string& name, size_t n, F&& f) {
+    using clock = std::chrono::steady_clock;
+    vector<double> ns(n);
+    auto start = clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        auto t0 = clock::now();
+        f(i);
+        ns[i] = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+    }
+    double total = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    std::sort(ns.begin(), ns.end());
+    std::printf("  %-44s %10.3f ms   p50 %7.0f ns  p99 %7.0f ns  max %9.0f ns\n",
+                name.c_str(), total, ns[n / 2], ns[n * 99 / 100], ns[n - 1]);
+}
+
+int evaluated = 0;
+string expensive() {
+    ++evaluated;
+    return string(1000, 'x');
+}
+
+
+int main() {
+    // correctness: every line arrives once, in per-thread order, before flush() returns
+    {
+        ostringstream sink;
+        logger log(sink);
+        log.set_async(true);
+        constexpr int THREADS = 4, PER_THREAD = 50'000;
+        vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&log, t] {
+                for (int i = 0; i < PER_THREAD; ++i) LOG_TO(log, log_level::info, t, " ", i);
+            });
+        }
+        for (auto& th : threads) th.join();
+        log.flush();
+        bench_check(log.lines_written() == THREADS * PER_THREAD, "all lines written before flush returns");
+        istringstream lines(sink.str());
+        vector<int> next(THREADS, 0);
+        int t, i, count = 0;
+        while (lines >> t >> i) {
+            bench_check(next[t] == i, "per-thread order");
+            ++next[t];
+            ++count;
+        }
+        bench_check(count == THREADS * PER_THREAD, "line count");
+
+        LOG_TO(log, log_level::debug, expensive());
+        bench_check(evaluated == 0, "disabled level skips argument evaluation");
+        LOG_TO(log, log_level::info, "vector ", vector<int>{1, 2, 3});
+        char scratch[] = "temporary";
+        const char* dangling = scratch;
+        LOG_TO(log, log_level::info, dangling);  // copied at the call
+        scratch[0] = 'X';
+        log.flush();
+        bench_check(sink.str().find("vector [1, 2, 3]\ntemporary\n") != string::npos, "vector and char* lines");
+    }
+    {
+        ostringstream sink;
+        {
+            logger log(sink);
+            log.set_async(true);
+            for (int i = 0; i < 10'000; ++i) LOG_TO(log, log_level::warn, "shutdown ", i);
+        }
+        string text = sink.str();
+        bench_check(std::count(text.begin(), text.end(), '\n') == 10'000, "destructor drains the queue");
+    }
+
+    constexpr size_t N = 200'000;
+    std::ofstream devnull("/dev/null");
+    string name = "apple";
+
+    ptitle("one thread, " + to_string(N) + " lines \"copy-ctor apple <i>\"");
+    latency("out << ... << endl", N, [&](size_t i) { devnull << "copy-ctor " << name << " " << i << endl; });
+    logger sync_log(devnull);
+    latency("logger, synchronous", N, [&](size_t i) {
+        LOG_TO(sync_log, log_level::info, "copy-ctor ", name, " ", i);
+    });
+    {
+        logger async_log(devnull);
+        async_log.set_async(true);
+        latency("logger, asynchronous (caller side)", N, [&](size_t i) {
+            LOG_TO(async_log, log_level::info, "copy-ctor ", name, " ", i);
+        });
+        bench("  then flush()", N, [&] { async_log.flush(); }, 1);
+    }
+    latency("disabled level, 1000-char argument", N, [&](size_t) {
+        LOG_TO(sync_log, log_level::debug, "copy-ctor ", expensive());
+    });
+    bench_check(evaluated == 0, "disabled level skips argument evaluation");
+
+    const unsigned cores = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+    ptitle(to_string(cores) + " threads, " + to_string(N) + " lines each");
+    auto threaded = [&](auto&& log_line) {
+        vector<std::thread> threads;
+        for (unsigned t = 0; t < cores; ++t) {
+            threads.emplace_back([&, t] { for (size_t i = 0; i < N; ++i) log_line(t, i); });
+        }
+        for (auto& th : threads) th.join();
+    };
+    std::mutex out_mutex;
+    bench("out << ... << endl under a mutex", N * cores, [&] {
+        threaded([&](unsigned t, size_t i) {
+            std::lock_guard<std::mutex> guard(out_mutex);
+            devnull << "thread " << t << " line " << i << endl;
+        });
+    }, 1);
+    bench("logger, synchronous", N * cores, [&] {
+        threaded([&](unsigned t, size_t i) { LOG_TO(sync_log, log_level::info, "thread ", t, " line ", i); });
+    }, 1);
+    {
+        logger async_log(devnull);
+        async_log.set_async(true);
+        bench("logger, asynchronous (callers done)", N * cores, [&] {
+            threaded([&](unsigned t, size_t i) { LOG_TO(async_log, log_level::info, "thread ", t, " line ", i); });
+        }, 1);
+        bench("  then flush()", N * cores, [&] { async_log.flush(); }, 1);
+    }
+    return 0;
+}
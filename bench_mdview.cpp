@@ -0,0 +1,96 @@
+/*
+ * Benchmark: matrix traversal through view (mdview.h) with each bounds-check
+ * policy, against the hand-written raw pointer loop it is supposed to match.
+ */
+#include <numeric>
+#include "utils.h"
+#include "bench.h"
+#include "mdview.h"
+
+
+constexpr size_t ROWS = 2048;
+constexpr size_t COLS = 2048;
+
+
+// the baseline: what you'd write in C
+double raw_sum(const double* p, size_t rows, size_t cols) {
+    double sum = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            sum += p[i * cols + j];
+        }
+    }
+    return sum;
+}
+
+template<typename View>
+double view_sum(const View& v) {
+    double sum = 0;
+    for (size_t i = 0; i < v.extent(0); ++i) {
+        for (size_t j = 0; j < v.extent(1); ++j) {
+            sum += v(i, j);
+        }
+    }
+    return sum;
+}
+
+// walk a column-major view column by column, so memory is still sequential
+template<typename View>
+double view_sum_by_column(const View& v) {
+    double sum = 0;
+    for (size_t j = 0; j < v.extent(1); ++j) {
+        for (size_t i = 0; i < v.extent(0); ++i) {
+            sum += v(i, j);
+        }
+    }
+    return sum;
+}
+
+
+int main() {
+    vector<double> buf(ROWS * COLS);
+    std::iota(buf.begin(), buf.end(), 0.0);
+    const double* p = buf.data();
+    const size_t n = buf.size();
+    // keep the extents opaque to the optimizer so dynamic views are really dynamic
+    size_t rows = ROWS, cols = COLS;
+    do_not_optimize(rows);
+    do_not_optimize(cols);
+
+    auto dyn = make_matrix_view(p, rows, cols);
+    view<const double, extents<ROWS, COLS>> fixed(p, extents<ROWS, COLS>{});
+    auto strided = view<const double, dextents<2>, layout_stride>(
+        p, layout_stride::mapping<dextents<2>>(dextents<2>(rows, cols), {cols, 1}));
+    auto col_major = make_matrix_view<layout_left>(p, cols, rows);
+
+    double expected = raw_sum(p, rows, cols);
+    bench_check(view_sum(dyn) == expected, "dynamic view sum");
+    bench_check(view_sum(fixed) == expected, "static view sum");
+    bench_check(view_sum(strided) == expected, "strided view sum");
+    bench_check(view_sum_by_column(col_major) == expected, "column-major view sum");
+    bool threw = false;
+    try {
+        dyn.with_policy<throw_checked>()(rows, 0);
+    }
+    catch (const std::out_of_range&) {
+        threw = true;
+    }
+    bench_check(threw, "throw_checked throws");
+
+    ptitle("sum of a " + to_string(ROWS) + "x" + to_string(COLS) + " row-major matrix");
+    bench("raw pointer p[i * cols + j]", n, [&] { do_not_optimize(raw_sum(p, rows, cols)); });
+    bench("view<dextents<2>>, unchecked", n, [&] { do_not_optimize(view_sum(dyn)); });
+    bench("view<extents<2048, 2048>>, unchecked", n, [&] { do_not_optimize(view_sum(fixed)); });
+    bench("view<layout_stride>, unchecked", n, [&] { do_not_optimize(view_sum(strided)); });
+    bench("view<layout_left>, column walk, unchecked", n, [&] {
+        do_not_optimize(view_sum_by_column(col_major));
+    });
+    bench("view<dextents<2>>, assert_checked", n, [&] {
+        do_not_optimize(view_sum(dyn.with_policy<assert_checked>()));
+    });
+    bench("view<dextents<2>>, throw_checked", n, [&] {
+        do_not_optimize(view_sum(dyn.with_policy<throw_checked>()));
+    });
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * Benchmark: memoize / lru_cache (memoize.h) on the formatting calls of the
+ * examples:
+ *   - hit path of smart_serialize1, tuple_str and type_str against calling them
+ *   - lookups of a hot working set from 1..8 threads, 16 shards against 1, to
+ *     show what sharding buys under contention
+ */
+#include "utils.h"
+#include "bench.h"
+#include <atomic>
+#include <limits>
+#include <random>
+#include <thread>
+#include "smart_serialize.h"
+#include "memoize.h"
+
+using namespace std::chrono_literals;
+
+
+int main() {
+    constexpr size_t N = 1'000'000;
+    constexpr size_t KEYS = 1000;
+    std::mt19937 rng(7);
+
+    vector<SFish> sfish;
+    vector<Dog> dogs;
+    vector<std::tuple<int, string, double>> tuples;
+    for (size_t i = 0; i < KEYS; ++i) {
+        sfish.push_back(SFish{{"fish-number-" + to_string(i)}});
+        dogs.push_back(Dog{"dog-" + to_string(i)});
+        tuples.emplace_back(static_cast<int>(i), "row-" + to_string(i), i * 0.25);
+    }
+    vector<uint32_t> picks(N);
+    for (auto& p : picks) p = rng() % KEYS;
+
+    // correctness
+    {
+        lru_cache<int, string> lru({0, 1});  // no room at all: nothing is kept
+        lru.put(1, "one");
+        bench_check(!lru.get(1) && lru.stats().entries == 0, "entries bigger than the shard are dropped");
+
+        // room for a few small entries in one shard: the least recently used goes first
+        lru_cache<int, int> small({400, 1});
+        for (int k = 0; k < 10; ++k) small.put(k, k * 10);
+        auto st = small.stats();
+        int room = static_cast<int>(st.entries);
+        bench_check(room >= 2 && st.evictions == static_cast<size_t>(10 - room), "evicts down to capacity");
+        bench_check(st.bytes <= 400, "stays within capacity");
+        bench_check(small.get(9) == 90 && !small.get(0), "keeps the recent, drops the old");
+        int oldest = 10 - room;
+        bench_check(small.get(oldest) == oldest * 10, "oldest still there");
+        small.put(100, 0);
+        bench_check(small.get(oldest) && !small.get(oldest + 1), "a hit makes an entry recent");
+
+        lru_cache<string, int> fresh({1 << 16, 4, 50ms});
+        fresh.put("k", 1);
+        bench_check(fresh.get("k") == 1, "fresh entry");
+        std::this_thread::sleep_for(60ms);
+        bench_check(!fresh.get("k") && fresh.stats().expirations == 1 && fresh.stats().entries == 0, "ttl");
+
+        int calls = 0;
+        auto add = memoize<int, int>([&calls](int a, int b) { ++calls; return a + b; });
+        bench_check(add(2, 3) == 5 && add(2, 3) == 5 && add(3, 2) == 5 && calls == 2, "argument order matters");
+        st = add.stats();
+        bench_check(st.hits == 1 && st.misses == 2, "counters");
+
+        struct first_letter {
+            size_t operator()(const std::tuple<string>& k) const { return std::get<0>(k).empty() ? 0 : std::get<0>(k)[0]; }
+        };
+        auto len = memoize_with<first_letter, const string&>([](const string& s) { return s.size(); });
+        bench_check(len("apple") == 5 && len("avocado") == 7 && len("apple") == 5, "custom hash, colliding keys");
+
+        // a key is "the same input": 0.0 and -0.0 are two keys, NaN finds itself
+        auto inverse = memoize<double>([](double d) { return to_string(1 / d); });
+        bench_check(inverse(0.0) == "inf" && inverse(-0.0) == "-inf", "-0.0 is not 0.0");
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        inverse(nan);
+        inverse(nan);
+        st = inverse.stats();
+        bench_check(st.hits == 1 && st.entries == 3, "NaN hits its own entry");
+        bench_check(memo_tuple_str(std::make_tuple(-0.0, 1)) == tuple_str(std::make_tuple(-0.0, 1)),
+                    "memo_tuple_str keeps the sign of zero");
+        lru_cache<vector<double>, int, memo_key_hash, memo_key_equal> by_vector;
+        by_vector.put({0.0, nan}, 1);
+        bench_check(by_vector.get(vector<double>{0.0, nan}) == 1 && !by_vector.get(vector<double>{-0.0, nan}),
+                    "memo_key_hash / memo_key_equal as lru_cache functors");
+
+        for (size_t i = 0; i < KEYS; ++i) {
+            bench_check(memo_smart_serialize(sfish[i]) == smart_serialize1(sfish[i]), "memo_smart_serialize SFish");
+            bench_check(memo_smart_serialize(dogs[i]) == smart_serialize1(dogs[i]), "memo_smart_serialize Dog");
+            bench_check(memo_tuple_str(tuples[i]) == tuple_str(tuples[i]), "memo_tuple_str");
+        }
+        bench_check(memo_type_str<decltype(tuples)>() == type_str<decltype(tuples)>(), "memo_type_str");
+
+        // threads hammering one small cache must only ever see right answers
+        auto square = memoize<int>([](int x) { return to_string(x * x); }, {8 << 10, 4});
+        vector<std::thread> threads;
+        std::atomic<int> wrong {0};
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 20000; ++i) {
+                    int x = (i * 7 + t) % 500;
+                    wrong += square(x) != to_string(x * x);
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        st = square.stats();
+        bench_check(wrong == 0, "concurrent results");
+        bench_check(st.hits + st.misses == 80000 && st.evictions > 0 && st.bytes <= 8 << 10, "concurrent counters");
+    }
+
+    // warm caches: every lookup below is a hit
+    for (size_t i = 0; i < KEYS; ++i) {
+        memo_smart_serialize(sfish[i]);
+        memo_smart_serialize(dogs[i]);
+        memo_tuple_str(tuples[i]);
+    }
+
+    ptitle("hit path, " + to_string(KEYS) + " distinct keys");
+    bench("smart_serialize1(SFish)", N, [&] {
+        size_t n = 0;
+        for (auto p : picks) n += smart_serialize1(sfish[p]).size();
+        do_not_optimize(n);
+    });
+    bench("memo_smart_serialize(SFish)", N, [&] {
+        size_t n = 0;
+        for (auto p : picks) n += memo_smart_serialize(sfish[p]).size();
+        do_not_optimize(n);
+    });
+    bench("smart_serialize1(Dog) (any_str)", N, [&] {
+        size_t n = 0;
+        for (auto p : picks) n += smart_serialize1(dogs[p]).size();
+        do_not_optimize(n);
+    });
+    bench("memo_smart_serialize(Dog)", N, [&] {
+        size_t n = 0;
+        for (auto p : picks) n += memo_smart_serialize(dogs[p]).size();
+        do_not_optimize(n);
+    });
+    bench("tuple_str", N, [&] {
+        size_t n = 0;
+        for (auto p : picks) n += tuple_str(tuples[p]).size();
+        do_not_optimize(n);
+    });
+    bench("memo_tuple_str", N, [&] {
+        size_t n = 0;
+        for (auto p : picks) n += memo_tuple_str(tuples[p]).size();
+        do_not_optimize(n);
+    });
+    bench("type_str", N, [&] {
+        size_t n = 0;
+        for (size_t i = 0; i < N; ++i) n += type_str<decltype(tuples)>().size();
+        do_not_optimize(n);
+    });
+    bench("memo_type_str", N, [&] {
+        size_t n = 0;
+        for (size_t i = 0; i < N; ++i) n += memo_type_str<decltype(tuples)>().size();
+        do_not_optimize(n);
+    });
+    cout << "  Dog cache: " << smart_serialize_memo<Dog>().stats() << endl;
+
+    // every thread looks up the same hot keys, N lookups in total
+    for (size_t shards : {size_t{16}, size_t{1}}) {
+        auto dog_str = memoize<const Dog&>([](const Dog& d) { return any_str(d); }, {1 << 20, shards});
+        for (auto& d : dogs) dog_str(d);
+        ptitle(to_string(N) + " hits from many threads, " + to_string(shards) + " shard(s)");
+        for (unsigned threads : {1u, 2u, 4u, 8u}) {
+            bench(to_string(threads) + " thread(s)", N, [&] {
+                vector<std::thread> workers;
+                for (unsigned t = 0; t < threads; ++t) {
+                    workers.emplace_back([&, t] {
+                        size_t n = 0;
+                        for (size_t i = t; i < N; i += threads) n += dog_str(dogs[picks[i]]).size();
+                        do_not_optimize(n);
+                    });
+                }
+                for (auto& w : workers) w.join();
+            });
+        }
+        cout << "  " << dog_str.stats() << endl;
+    }
+}
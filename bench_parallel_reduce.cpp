@@ -0,0 +1,122 @@
+/*
+ * Benchmark: parallel_reduce against the sequential fold, on an associative but
+ * non-commutative op (2x2 integer matrix products), string concatenation and the
+ * arithmetic lane path, scaling from 1 worker to all cores.
+ */
+#include <numeric>
+#include <random>
+#include "utils.h"
+#include "bench.h"
+#include "parallel_reduce.h"
+
+
+// 2x2 matrices mod 2^64: associative, exact, and a*b != b*a
+struct Mat2 {
+    uint64_t a, b, c, d;
+    bool operator==(const Mat2& o) const { return a == o.a && b == o.b && c == o.c && d == o.d; }
+};
+Mat2 operator*(const Mat2& x, const Mat2& y) {
+    return {x.a * y.a + x.b * y.c, x.a * y.b + x.b * y.d, x.c * y.a + x.d * y.c, x.c * y.b + x.d * y.d};
+}
+
+
+int main() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    vector<unsigned> sizes;
+    for (unsigned t = 1; t < cores; t *= 2) sizes.push_back(t);
+    sizes.push_back(cores);
+    if (cores == 1) sizes.push_back(2);
+
+    constexpr size_t N_MAT = 5'000'000, N_STR = 1'000'000, N_NUM = 50'000'000;
+    std::mt19937_64 rng(31);
+    vector<Mat2> mats(N_MAT);
+    for (auto& m : mats) m = {rng(), rng(), rng(), rng()};
+    vector<string> words(N_STR);
+    for (auto& w : words) w = to_string(rng() % 1000);
+    vector<int64_t> ints(N_NUM);
+    for (auto& x : ints) x = static_cast<int64_t>(rng() % 2001) - 1000;
+    vector<double> doubles(N_NUM);
+    for (auto& x : doubles) x = static_cast<double>(rng() % 1'000'000) / 1024;  // exactly representable sums
+
+    auto mat_mul = [](const Mat2& x, const Mat2& y) { return x * y; };
+    auto concat = [](string a, const string& b) { a += b; return a; };
+
+    // correctness: bit-identical to the sequential fold, whatever the chunking
+    {
+        thread_pool pool(4);
+        Mat2 seq = std::accumulate(mats.begin() + 1, mats.end(), mats[0], mat_mul);
+        for (size_t grain : {size_t{0}, size_t{1}, size_t{7}, size_t{1000}, N_MAT}) {
+            bench_check(parallel_reduce(pool, mats, mat_mul, grain) == seq, "matrix product keeps order");
+        }
+        string text = std::accumulate(words.begin(), words.begin() + 10'000, string{});
+        bench_check(parallel_reduce(pool, words.begin(), words.begin() + 10'000, string{}, concat, 37) == text,
+                    "concatenation keeps order");
+        bench_check(parallel_reduce(pool, ints, std::plus<>{}) == std::accumulate(ints.begin(), ints.end(), int64_t{0}),
+                    "integer lane path is exact");
+        bench_check(parallel_reduce(pool, doubles, std::plus<>{}) ==
+                    std::accumulate(doubles.begin(), doubles.end(), 0.0), "double lane path");
+        vector<int> none;
+        bench_check(parallel_reduce(pool, none, 42, std::plus<>{}) == 42, "empty range returns init");
+        bool threw = false;
+        try {
+            parallel_reduce(pool, none, std::plus<>{});
+        }
+        catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        bench_check(threw, "empty range without init throws");
+        vector<char> chars(100, 1);
+        bench_check(parallel_reduce(pool, chars, std::plus<>{}) == 100, "promoting types use the generic path");
+    }
+
+    ptitle(to_string(N_MAT) + " 2x2 matrix products, " + to_string(cores) + " cores");
+    bench("sequential accumulate", N_MAT, [&] {
+        do_not_optimize(std::accumulate(mats.begin() + 1, mats.end(), mats[0], mat_mul));
+    });
+    for (unsigned threads : sizes) {
+        thread_pool pool(threads);
+        bench("parallel_reduce pool(" + to_string(threads) + ")", N_MAT, [&] {
+            do_not_optimize(parallel_reduce(pool, mats, mat_mul));
+        });
+    }
+
+    ptitle("concatenate " + to_string(N_STR) + " strings");
+    bench("sequential accumulate (move)", N_STR, [&] {
+        string s;
+        for (auto& w : words) s += w;
+        do_not_optimize(s.data());
+    });
+    for (unsigned threads : sizes) {
+        thread_pool pool(threads);
+        bench("parallel_reduce pool(" + to_string(threads) + ")", N_STR, [&] {
+            do_not_optimize(parallel_reduce(pool, words, string{}, concat).data());
+        });
+    }
+
+    ptitle("sum of " + to_string(N_NUM) + " int64");
+    bench("sequential accumulate", N_NUM, [&] {
+        do_not_optimize(std::accumulate(ints.begin(), ints.end(), int64_t{0}));
+    });
+    auto plain_add = [](int64_t a, int64_t b) { return a + b; };
+    for (unsigned threads : sizes) {
+        thread_pool pool(threads);
+        bench("pool(" + to_string(threads) + ") generic path (lambda)", N_NUM, [&] {
+            do_not_optimize(parallel_reduce(pool, ints, plain_add));
+        });
+        bench("pool(" + to_string(threads) + ") lane path (std::plus)", N_NUM, [&] {
+            do_not_optimize(parallel_reduce(pool, ints, std::plus<>{}));
+        });
+    }
+
+    ptitle("sum of " + to_string(N_NUM) + " double");
+    bench("sequential accumulate", N_NUM, [&] {
+        do_not_optimize(std::accumulate(doubles.begin(), doubles.end(), 0.0));
+    });
+    for (unsigned threads : sizes) {
+        thread_pool pool(threads);
+        bench("pool(" + to_string(threads) + ") lane path (std::plus)", N_NUM, [&] {
+            do_not_optimize(parallel_reduce(pool, doubles, std::plus<>{}));
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Benchmark: the boost_hana_switch loop (switch_ over boost::any, one line written
+ * per item) run sequentially versus as producer -> N x dispatch -> batched sink.
+ */
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include "utils.h"
+#include "bench.h"
+#include "animals.h"
+#include "hana_switch.h"
+#include "pipeline.h"
+
+
+vector<boost::any> make_anys(size_t n) {
+    std::mt19937 rng(5);
+    vector<boost::any> anys;
+    anys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        switch (rng() % 6) {
+            case 0: anys.emplace_back(static_cast<int>(i)); break;
+            case 1: anys.emplace_back(static_cast<char>('a' + i % 26)); break;
+            case 2: anys.emplace_back(static_cast<float>(i) / 7); break;
+            case 3: anys.emplace_back(vector<int>{int(i), 1, 2, 3}); break;
+            case 4: anys.emplace_back(Fish{"fish_number_" + to_string(i)}); break;
+            default: anys.emplace_back(Dog{"dog_number_" + to_string(i)}); break;
+        }
+    }
+    return anys;
+}
+
+string describe(boost::any& a) {
+    return switch_(a)(
+        case_<int>([](auto i) { return "int: "s + std::to_string(i); }),
+        case_<char>([](auto c) { return "char: "s + string{c}; }),
+        case_<float>([](auto f) { return "float: "s + std::to_string(f); }),
+        case_<vector<int>>([](const auto& vec) { return "vector<int>: "s + any_str(vec); }),
+        case_<Fish>([](const auto& x) { return "my fish: "s + any_str(x); }),
+        default_([] { return "unknown type"s; })
+    );
+}
+
+pipeline_stats run(const vector<boost::any>& anys, std::ostream& out, pipeline_options opts) {
+    return run_pipeline<boost::any, string>(
+        [&](auto&& emit) { for (auto& a : anys) emit(a); },
+        describe,
+        [&](const vector<string>& batch) {
+            for (auto& r : batch) out << r << '\n';
+            out.flush();
+        },
+        opts
+    );
+}
+
+
+int main() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    // correctness: same lines, same order, for any replica count and tiny rings
+    {
+        auto anys = make_anys(20'000);
+        std::ostringstream expected;
+        for (auto& a : anys) expected << describe(a) << '\n';
+        for (size_t replicas : {1, 2, 3, 4}) {
+            std::ostringstream got;
+            auto stats = run(anys, got, {replicas, 4, 7});
+            bench_check(got.str() == expected.str(), "pipeline keeps input order");
+            bench_check(stats.items == anys.size(), "pipeline delivers every item");
+            bench_check(stats.stages.size() == replicas + 2, "one stage entry per thread");
+        }
+        std::ostringstream none;
+        auto stats = run({}, none, {2, 4, 4});
+        bench_check(stats.items == 0 && none.str().empty(), "empty input");
+
+        // a throw in any stage reaches the caller instead of std::terminate
+        auto fails_at = [](int stage, size_t replicas) {
+            try {
+                run_pipeline<int, int>(
+                    [&](auto&& emit) {
+                        for (int i = 0; i < 10'000; ++i) {
+                            if (stage == 0 && i == 5000) throw std::runtime_error("producer");
+                            emit(i);
+                        }
+                    },
+                    [&](int& i) {
+                        if (stage == 1 && i == 5000) throw std::runtime_error("dispatch");
+                        return i;
+                    },
+                    [&](const vector<int>& batch) {
+                        if (stage == 2 && batch.front() >= 5000) throw std::runtime_error("sink");
+                    },
+                    {replicas, 4, 7});
+            }
+            catch (const std::runtime_error& e) {
+                return string(e.what());
+            }
+            return string();
+        };
+        for (size_t replicas : {1, 3}) {
+            bench_check(fails_at(0, replicas) == "producer" && fails_at(1, replicas) == "dispatch"
+                        && fails_at(2, replicas) == "sink", "stage exceptions are rethrown by run_pipeline");
+        }
+    }
+
+    constexpr size_t N = 500'000;
+    auto anys = make_anys(N);
+    std::ofstream devnull("/dev/null");
+
+    ptitle("switch_ over " + to_string(N) + " anys, " + to_string(cores) + " cores");
+    bench("sequential loop, endl per item", N, [&] {
+        for (auto& a : anys) {
+            string r = describe(a);
+            devnull << r << endl;
+        }
+    });
+    pipeline_stats last;
+    for (size_t replicas : {1, 2, 4}) {
+        bench("pipeline, " + to_string(replicas) + " dispatch", N, [&] {
+            last = run(anys, devnull, {replicas, 1024, 256});
+        });
+    }
+    cout << "last run:\n" << last;
+}
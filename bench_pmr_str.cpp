@@ -0,0 +1,159 @@
+/*
+ * Benchmark: the std::pmr overloads of any_str / join_str / tuple_str (utils.h)
+ * against the std::string ones, formatting a small log record per request:
+ *   - one thread: the global allocator, a monotonic_buffer_resource over a stack
+ *     buffer per request, and one arena reused with release()
+ *   - 1..8 threads doing the same requests, where every std::string version goes
+ *     through the one global heap
+ * operator new is replaced below to count heap allocations per thread.
+ */
+#include "utils.h"
+#include "bench.h"
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <thread>
+
+thread_local size_t heap_allocations = 0;
+
+void* operator new(std::size_t n) {
+    ++heap_allocations;
+    if (void* p = std::malloc(n ? n : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+// these replace the global pair, so new really is malloc; GCC only sees the
+// builtin operator new at the inlined call sites and takes free() for a mismatch
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+
+struct request {
+    int id;
+    string user;
+    double score;
+    vector<int> tags;
+};
+
+// what a handler builds per request: three strings from the helpers
+size_t format_request(const request& r) {
+    string head = any_str("request ", r.id, " from ", r.user, " tags ", r.tags);
+    string line = join_str(", ", r.id, r.user, r.score);
+    string tup = tuple_str(std::tie(r.id, r.user, r.score));
+    return head.size() + line.size() + tup.size();
+}
+
+size_t format_request(std::pmr::memory_resource* mr, const request& r) {
+    std::pmr::string head = any_str(mr, "request ", r.id, " from ", r.user, " tags ", r.tags);
+    std::pmr::string line = join_str(mr, ", ", r.id, r.user, r.score);
+    std::pmr::string tup = tuple_str(mr, std::tie(r.id, r.user, r.score));
+    return head.size() + line.size() + tup.size();
+}
+
+size_t format_on_stack(const request& r) {
+    char scratch[2048];
+    std::pmr::monotonic_buffer_resource arena(scratch, sizeof(scratch));
+    return format_request(&arena, r);
+}
+
+
+int main() {
+    constexpr size_t N = 200'000;
+    std::mt19937 rng(5);
+    vector<request> requests(1000);
+    for (size_t i = 0; i < requests.size(); ++i) {
+        auto& r = requests[i];
+        r.id = static_cast<int>(rng() % 100000);
+        r.user = "user-" + to_string(rng() % 5000) + "@example.org";
+        r.score = (rng() % 10000) / 7.0;
+        r.tags.resize(rng() % 8);
+        for (auto& t : r.tags) t = static_cast<int>(rng() % 1000);
+    }
+
+    // correctness
+    {
+        auto same = [](std::string_view a, std::string_view b) { return a == b; };
+        char scratch[4096];
+        std::pmr::monotonic_buffer_resource arena(scratch, sizeof(scratch));
+        for (auto& r : requests) {
+            bench_check(same(any_str(&arena, "request ", r.id, " tags ", r.tags), any_str("request ", r.id, " tags ", r.tags)),
+                        "any_str");
+            bench_check(same(join_str(&arena, ", ", r.id, r.user, r.score), join_str(", ", r.id, r.user, r.score)), "join_str");
+            auto tup = std::make_tuple(r.id, r.user, r.score, 0.1f, 'x');
+            bench_check(same(tuple_str(&arena, tup), tuple_str(tup)), "tuple_str");
+            arena.release();
+        }
+
+        size_t before = heap_allocations;
+        size_t n = format_on_stack(requests[0]);
+        bool no_allocation = heap_allocations == before;  // before the check's own message string
+        bench_check(no_allocation && n > 0, "a request on a stack arena allocates nothing");
+
+        string big(10'000, 'x');
+        std::pmr::monotonic_buffer_resource small(scratch, 64);
+        bench_check(same(any_str(&small, big, 1), big + "1"), "output bigger than the buffer spills to the upstream resource");
+
+        pmr_ostringstream oss(&arena);
+        oss << "abc" << 1;
+        bench_check(oss.view() == "abc1" && oss.str() == "abc1" && oss.release() == "abc1" && oss.view().empty(),
+                    "pmr_ostringstream");
+        oss << vector<int>{1, 2};
+        bench_check(oss.release() == "[1, 2]", "pmr_ostringstream reused");
+    }
+
+    ptitle("one thread, " + to_string(N) + " requests");
+    bench("std::string", N, [&] {
+        size_t n = 0;
+        for (size_t i = 0; i < N; ++i) n += format_request(requests[i % requests.size()]);
+        do_not_optimize(n);
+    });
+    bench("pmr, stack arena per request", N, [&] {
+        size_t n = 0;
+        for (size_t i = 0; i < N; ++i) n += format_on_stack(requests[i % requests.size()]);
+        do_not_optimize(n);
+    });
+    bench("pmr, one arena, release() per request", N, [&] {
+        char scratch[2048];
+        std::pmr::monotonic_buffer_resource arena(scratch, sizeof(scratch));
+        size_t n = 0;
+        for (size_t i = 0; i < N; ++i) {
+            n += format_request(&arena, requests[i % requests.size()]);
+            arena.release();
+        }
+        do_not_optimize(n);
+    });
+
+    auto allocations = [&](auto format) {
+        size_t before = heap_allocations, n = 0;
+        for (auto& r : requests) n += format(r);
+        do_not_optimize(n);
+        return static_cast<double>(heap_allocations - before) / requests.size();
+    };
+    double default_allocs = allocations([](const request& r) { return format_request(r); });
+    double stack_allocs = allocations([](const request& r) { return format_on_stack(r); });
+    cout << "  heap allocations per request: " << default_allocs << " with std::string, "
+         << stack_allocs << " with the stack arena" << endl;
+
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        ptitle(to_string(threads) + " thread(s), " + to_string(N) + " requests in total");
+        auto run = [&](auto format) {
+            return [&, format] {
+                vector<std::thread> workers;
+                for (unsigned t = 0; t < threads; ++t) {
+                    workers.emplace_back([&, t] {
+                        size_t n = 0;
+                        for (size_t i = t; i < N; i += threads) n += format(requests[i % requests.size()]);
+                        do_not_optimize(n);
+                    });
+                }
+                for (auto& w : workers) w.join();
+            };
+        };
+        bench("std::string", N, run([](const request& r) { return format_request(r); }));
+        bench("pmr, stack arena per request", N, run([](const request& r) { return format_on_stack(r); }));
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * Benchmark: SoA PointCloud batch kernels against looping over vector<Point>
+ * with the constexpr midpoint/reflect from item 15.
+ */
+#include <random>
+#include "utils.h"
+#include "bench.h"
+#include "point_cloud.h"
+
+
+int main() {
+    constexpr size_t N = 4'000'000;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(-100, 100);
+    vector<Point> pa(N), pb(N), pout(N);
+    for (size_t i = 0; i < N; ++i) {
+        pa[i] = {dist(rng), dist(rng)};
+        pb[i] = {dist(rng), dist(rng)};
+    }
+    PointCloud ca(pa), cb(pb), cmid(N);
+
+    // results must match the scalar constexpr functions exactly
+    midpoint(ca, cb, cmid);
+    reflect(cmid);
+    for (size_t i = 0; i < N; i += 9973) {
+        Point expected = reflect(midpoint(pa[i], pb[i]));
+        bench_check(cmid[i].getX() == expected.getX() && cmid[i].getY() == expected.getY(),
+                    "PointCloud midpoint/reflect match Point");
+    }
+    auto round_trip = PointCloud(pa).to_points();
+    bench_check(round_trip.size() == N && round_trip[N - 1].getY() == pa[N - 1].getY(),
+                "vector<Point> round trip");
+
+    ptitle("midpoint of " + to_string(N) + " point pairs");
+    bench("AoS loop over constexpr midpoint()", N, [&] {
+        for (size_t i = 0; i < N; ++i) pout[i] = midpoint(pa[i], pb[i]);
+        do_not_optimize(pout.data());
+    });
+    bench("PointCloud midpoint, 1 thread", N, [&] {
+        midpoint(ca, cb, cmid);
+        do_not_optimize(cmid.x());
+    });
+    bench("PointCloud midpoint, " + to_string(cores) + " threads", N, [&] {
+        midpoint(ca, cb, cmid, cores);
+        do_not_optimize(cmid.x());
+    });
+
+    ptitle("reflect " + to_string(N) + " points in place");
+    bench("AoS loop over constexpr reflect()", N, [&] {
+        for (auto& p : pa) p = reflect(p);
+        do_not_optimize(pa.data());
+    });
+    bench("PointCloud reflect, 1 thread", N, [&] {
+        reflect(ca);
+        do_not_optimize(ca.x());
+    });
+    bench("PointCloud reflect, " + to_string(cores) + " threads", N, [&] {
+        reflect(ca, cores);
+        do_not_optimize(ca.x());
+    });
+
+    ptitle("translate + scale " + to_string(N) + " points");
+    bench("AoS loop with setX/setY", N, [&] {
+        for (auto& p : pa) {
+            p.setX((p.getX() + 1.5) * 0.75);
+            p.setY((p.getY() - 2.0) * 1.25);
+        }
+        do_not_optimize(pa.data());
+    });
+    bench("PointCloud translate then scale (2 passes)", N, [&] {
+        translate(ca, 1.5, -2.0);
+        scale(ca, 0.75, 1.25);
+        do_not_optimize(ca.x());
+    });
+    bench("PointCloud fused affine, 1 thread", N, [&] {
+        affine(ca, 0.75, 1.25, 1.5 * 0.75, -2.0 * 1.25);
+        do_not_optimize(ca.x());
+    });
+    bench("PointCloud fused affine, " + to_string(cores) + " threads", N, [&] {
+        affine(ca, 0.75, 1.25, 1.5 * 0.75, -2.0 * 1.25, cores);
+        do_not_optimize(ca.x());
+    });
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * Benchmark: readers of a shared, occasionally replaced Marker object, through
+ *   - rcu_cell (rcu.h): epoch-based, a reader writes only its own record
+ *   - std::atomic_load / atomic_store on a shared_ptr: libstdc++ takes a lock
+ *     from a small pool and bumps the shared refcount on every read
+ *   - plain shared_ptr copies (what ch4_smartpointers does, no writer allowed):
+ *     the refcount alone
+ * from 1 to 8 threads, without and with a writer publishing a new version
+ * every 50 us.
+ */
+#include "utils.h"
+#include "bench.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "rcu.h"
+
+using namespace std::chrono_literals;
+
+
+// a Marker-derived "current settings" object; check is poisoned on destruction
+class Config final : public Marker {
+public:
+    explicit Config(int version)
+    : Marker("config"), version(version), check(version * 3) {
+        alive.fetch_add(1, std::memory_order_relaxed);
+    }
+    Config(const Config& other)
+    : Marker(other), version(other.version), check(other.check) {
+        alive.fetch_add(1, std::memory_order_relaxed);
+    }
+    ~Config() {
+        check = -1;
+        alive.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    bool valid() const { return check == version * 3; }
+
+    int version;
+    int check;
+    static inline std::atomic<int> alive {0};
+};
+
+// published into rcu_cell<Marker>, whose destructor isn't virtual: deleted as itself
+struct Derived final : Marker {
+    Derived() : Marker("derived") {}
+    ~Derived() { ++destroyed; }
+    static inline int destroyed = 0;
+};
+
+// built before main touches the domain, destroyed after main: the domain has to outlive it
+rcu_cell<Marker> global_cell;
+
+
+// writes a new version every 50 us until stopped
+template<typename Publish>
+struct background_writer {
+    explicit background_writer(Publish publish)
+    : thread([this, publish] {
+        int version = 1;
+        while (!stop.load(std::memory_order_relaxed)) {
+            publish(++version);
+            std::this_thread::sleep_for(50us);
+        }
+    }) {}
+    ~background_writer() {
+        stop = true;
+        thread.join();
+    }
+
+    std::atomic<bool> stop {false};
+    std::thread thread;
+};
+
+
+int main() {
+    Marker::print_enabled = false;
+    constexpr size_t N = 10'000'000;
+
+    // correctness
+    {
+        rcu_cell<Config> cell(std::make_unique<Config>(1));
+        {
+            auto first = cell.read();
+            bench_check(first->version == 1, "initial object");
+            cell.store(std::make_unique<Config>(2));
+            bench_check(cell.read()->version == 2, "new readers see the new object");
+            bench_check(first->valid() && Config::alive == 2, "an old snapshot stays valid");
+            {
+                auto nested = cell.read();
+                bench_check(nested->version == 2, "nested snapshot");
+            }
+            bench_check(rcu_domain::instance().pending() == 1, "retired, not deleted, while read");
+        }
+        rcu_domain::instance().synchronize();
+        bench_check(Config::alive == 1 && rcu_domain::instance().pending() == 0, "reclaimed after the reader left");
+
+        cell.update([](const Config& c) {
+            auto next = std::make_unique<Config>(c);
+            next->version += 10;
+            next->check = next->version * 3;
+            return next;
+        });
+        bench_check(cell.read()->version == 12, "update copies and publishes");
+
+        {
+            rcu_cell<Marker> base(std::make_unique<Derived>());
+            base.store(std::make_unique<Derived>());
+        }
+        bench_check(Derived::destroyed == 2, "deleted through its own type");
+        global_cell.store(std::make_unique<Derived>());  // reclaimed at exit
+
+        // readers racing a writer never see a destroyed object, and versions only go up
+        std::atomic<bool> bad {false}, done {false};
+        vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&] {
+                int last = 0;
+                while (!done.load(std::memory_order_relaxed)) {
+                    auto snap = cell.read();
+                    if (!snap->valid() || snap->version < last) {
+                        bad = true;
+                    }
+                    last = snap->version;
+                }
+            });
+        }
+        for (int v = 100; v < 20'000; ++v) {
+            cell.store(std::make_unique<Config>(v));
+            if (v % 64 == 0) std::this_thread::yield();
+        }
+        done = true;
+        for (auto& r : readers) r.join();
+        rcu_domain::instance().synchronize();
+        bench_check(!bad, "readers saw only live objects, in order");
+        bench_check(Config::alive == 1, "every retired version was deleted");
+    }
+
+    auto read_with = [](unsigned threads, auto read_one) {
+        return [threads, read_one] {
+            vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    long sum = 0;
+                    for (size_t i = t; i < N; i += threads) sum += read_one();
+                    do_not_optimize(sum);
+                });
+            }
+            for (auto& w : workers) w.join();
+        };
+    };
+
+    rcu_cell<Config> cell(std::make_unique<Config>(1));
+    std::shared_ptr<Config> shared = std::make_shared<Config>(1);
+    auto rcu_read = [&cell] { return cell.read()->version; };
+    auto atomic_read = [&shared] { return std::atomic_load(&shared)->version; };
+    auto copy_read = [&shared] { return std::shared_ptr<Config>(shared)->version; };
+
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        ptitle(to_string(N) + " reads, " + to_string(threads) + " thread(s)");
+        bench("shared_ptr copy", N, read_with(threads, copy_read));
+        bench("atomic_load(shared_ptr)", N, read_with(threads, atomic_read));
+        bench("rcu_cell::read", N, read_with(threads, rcu_read));
+    }
+
+    for (unsigned threads : {1u, 4u}) {
+        ptitle(to_string(N) + " reads, " + to_string(threads) + " thread(s), a writer every 50 us");
+        {
+            background_writer writer([&shared](int v) { std::atomic_store(&shared, std::make_shared<Config>(v)); });
+            bench("atomic_load(shared_ptr)", N, read_with(threads, atomic_read));
+        }
+        {
+            background_writer writer([&cell](int v) { cell.store(std::make_unique<Config>(v)); });
+            bench("rcu_cell::read", N, read_with(threads, rcu_read));
+        }
+        cout << "  rcu objects waiting for readers: " << rcu_domain::instance().pending()
+             << ", Configs alive: " << Config::alive << endl;
+    }
+}
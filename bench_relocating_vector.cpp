@@ -0,0 +1,155 @@
+/*
+ * Benchmark: std::vector against relocating_vector for growth without reserve(),
+ * inserts and erases in the middle, with string-holding structs.
+ * Named holds a std::string and stays on the per-element path (libstdc++'s SSO
+ * string is not trivially relocatable), Boxed holds unique_ptr<string> and opts in.
+ */
+#include <random>
+#include "utils.h"
+#include "bench.h"
+#include "relocating_vector.h"
+#include "small_vector.h"
+
+
+struct Named {
+    string name;
+    int id;
+};
+
+struct Boxed {
+    unique_ptr<string> name;
+    int id;
+    using trivially_relocatable = std::bool_constant<all_trivially_relocatable_v<unique_ptr<string>, int>>;
+};
+
+Named make(Named*, int i) { return {"animal_" + to_string(i), i}; }
+Boxed make(Boxed*, int i) { return {make_unique<string>("animal_" + to_string(i)), i}; }
+
+template<typename T>
+T make(int i) { return make(static_cast<T*>(nullptr), i); }
+
+
+template<typename Vec>
+long checksum(const Vec& vec) {
+    long s = 0;
+    for (auto& x : vec) s = s * 31 + x.id;
+    return s;
+}
+
+// counts live objects and throws on the fifth copy, to check the constructors clean up
+struct Fragile {
+    static inline int live = 0;
+    static inline int copies = 0;
+    Fragile() { ++live; }
+    Fragile(const Fragile&) {
+        if (++copies == 5) throw runtime_error("Fragile copy");
+        ++live;
+    }
+    ~Fragile() { --live; }
+};
+
+// input iterator handing out the same Fragile n times, for the one-pass constructor path
+struct fragile_source {
+    using iterator_category = input_iterator_tag;
+    using value_type = Fragile;
+    using difference_type = ptrdiff_t;
+    using pointer = const Fragile*;
+    using reference = const Fragile&;
+    const Fragile* p;
+    int n;
+    reference operator*() const { return *p; }
+    fragile_source& operator++() { --n; return *this; }
+    bool operator==(const fragile_source& other) const { return n == other.n; }
+    bool operator!=(const fragile_source& other) const { return n != other.n; }
+};
+
+template<typename F>
+bool throws_and_cleans_up(F make_vec) {
+    int live = Fragile::live;
+    Fragile::copies = 0;
+    try {
+        make_vec();
+    }
+    catch (const runtime_error&) {
+        return Fragile::live == live;
+    }
+    return false;
+}
+
+
+template<typename Vec>
+Vec grow(size_t n) {
+    Vec vec;
+    for (size_t i = 0; i < n; ++i) vec.push_back(make<typename Vec::value_type>(static_cast<int>(i)));
+    return vec;
+}
+
+template<typename T>
+void run(const string& type, size_t n, size_t base, size_t inserts) {
+    using Std = vector<T>;
+    using Rel = relocating_vector<T>;
+
+    // same operations, same contents
+    Std a;
+    Rel b;
+    std::mt19937 rng(5);
+    for (size_t i = 0; i < base; ++i) {
+        a.push_back(make<T>(static_cast<int>(i)));
+        b.push_back(make<T>(static_cast<int>(i)));
+    }
+    for (size_t i = 0; i < 1000; ++i) {
+        size_t pos = rng() % (a.size() + 1);
+        a.insert(a.begin() + pos, make<T>(-static_cast<int>(i)));
+        b.insert(b.begin() + pos, make<T>(-static_cast<int>(i)));
+        pos = rng() % a.size();
+        a.erase(a.begin() + pos);
+        b.erase(b.begin() + pos);
+    }
+    bench_check(a.size() == b.size() && checksum(a) == checksum(b), type + " insert/erase agree");
+
+    ptitle(type + ": push_back " + to_string(n) + " without reserve");
+    bench("std::vector", n, [&] { do_not_optimize(grow<Std>(n).data()); });
+    bench("relocating_vector", n, [&] { do_not_optimize(grow<Rel>(n).data()); });
+
+    ptitle(type + ": " + to_string(inserts) + " inserts + erases in the middle of " + to_string(base));
+    auto churn = [&](auto& vec) {
+        return [&] {
+            for (size_t i = 0; i < inserts; ++i) {
+                vec.insert(vec.begin() + vec.size() / 2, make<T>(static_cast<int>(i)));
+            }
+            for (size_t i = 0; i < inserts; ++i) {
+                vec.erase(vec.begin() + vec.size() / 2);
+            }
+            do_not_optimize(vec.data());
+        };
+    };
+    bench("std::vector", inserts, churn(a));
+    bench("relocating_vector", inserts, churn(b));
+}
+
+
+int main() {
+    static_assert(!is_trivially_relocatable_v<Named> && is_trivially_relocatable_v<Boxed>);
+    static_assert(is_trivially_relocatable_v<relocating_vector<Named>>);
+
+    // small_vector's spill to the heap uses the same trait
+    small_vector<unique_ptr<int>, 2> sv;
+    for (int i = 0; i < 10; ++i) sv.push_back(make_unique<int>(i));
+    bench_check(!sv.is_inline() && *sv[9] == 9 && *sv[0] == 0, "small_vector relocating spill");
+
+    // a throw halfway through filling must not leak the buffer or what was built
+    {
+        Fragile proto;
+        vector<Fragile> src(8);
+        fragile_source first{&proto, 8}, last{&proto, 0};
+        bench_check(throws_and_cleans_up([&] { relocating_vector<Fragile> v(8, proto); }), "fill ctor throw");
+        bench_check(throws_and_cleans_up([&] { relocating_vector<Fragile> v(src.begin(), src.end()); }),
+                    "forward range ctor throw");
+        bench_check(throws_and_cleans_up([&] { relocating_vector<Fragile> v(first, last); }),
+                    "input range ctor throw");
+    }
+
+    run<Named>("Named{string, int}", 1'000'000, 100'000, 2'000);
+    run<Boxed>("Boxed{unique_ptr<string>, int}", 1'000'000, 100'000, 2'000);
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Benchmark: small_any against boost::any for the value mix of boost_hana_switch.cpp,
+ * {'x', 1000, -3.1415f, 23.09, vector<int>{...}, Fish{"tako"}, Dog{"snoopy"}}:
+ * construction, copy and switch_ dispatch.
+ */
+#include "utils.h"
+#include "bench.h"
+#include "animals.h"
+#include "hana_switch.h"
+#include "small_any.h"
+
+
+template<typename Any>
+vector<Any> make_values(size_t rounds) {
+    vector<Any> v;
+    v.reserve(rounds * 7);
+    for (size_t i = 0; i < rounds; ++i) {
+        v.emplace_back('x');
+        v.emplace_back(1000);
+        v.emplace_back(-3.1415f);
+        v.emplace_back(23.09);
+        v.emplace_back(vector<int>{4, 22, -1, 0, 1});
+        v.emplace_back(Fish{"tako"});
+        v.emplace_back(Dog{"snoopy"});
+    }
+    return v;
+}
+
+template<typename Any>
+string describe(Any& a) {
+    return switch_(a)(
+        case_<int>([](auto i) { return "int: "s + std::to_string(i); }),
+        case_<char>([](auto c) { return "char: "s + string{c}; }),
+        case_<float>([](auto f) { return "float: "s + std::to_string(f); }),
+        case_<vector<int>>([](const auto& vec) { return "vector<int>: "s + any_str(vec); }),
+        case_<Fish>([](const auto& x) { return "my fish: "s + any_str(x); }),
+        default_([] { return "unknown type"s; })
+    );
+}
+
+// the same switch_ with cheap handlers, so the type test itself dominates
+template<typename Any>
+long classify(Any& a) {
+    return switch_(a)(
+        case_<int>([](int i) { return long{i}; }),
+        case_<char>([](char c) { return long{c}; }),
+        case_<float>([](float f) { return static_cast<long>(f); }),
+        case_<vector<int>>([](const vector<int>& vec) { return static_cast<long>(vec.size()); }),
+        case_<Fish>([](const Fish& x) { return static_cast<long>(x.name.size()); }),
+        default_([] { return -1L; })
+    );
+}
+
+
+int main() {
+    // correctness
+    {
+        small_any a = 1000;
+        bench_check(a.is<int>() && any_cast<int>(a) == 1000 && a.type() == typeid(int), "int round trip");
+        bench_check(small_any::is_inline<int> && small_any::is_inline<vector<int>> && small_any::is_inline<Fish>,
+                    "the file's values fit inline");
+        bench_check(!small_any::is_inline<std::array<char, 64>>, "big values go to the heap");
+        bench_check(any_cast<float>(&a) == nullptr, "mismatch gives nullptr");
+        bool threw = false;
+        try {
+            any_cast<double>(a);
+        }
+        catch (const boost::bad_any_cast&) {
+            threw = true;
+        }
+        bench_check(threw, "bad_any_cast");
+
+        small_any v = vector<int>{1, 2, 3};
+        small_any copy = v;
+        unsafe_any_cast<vector<int>>(&copy)->push_back(4);
+        bench_check(any_cast<vector<int>&>(v).size() == 3 && any_cast<vector<int>&>(copy).size() == 4, "deep copy");
+        small_any moved = std::move(copy);
+        bench_check(copy.empty() && moved.is<vector<int>>(), "move empties the source");
+        small_any big = std::array<char, 64>{'b'};
+        small_any big_copy = big;
+        big = std::move(big_copy);
+        bench_check(any_cast<std::array<char, 64>&>(big)[0] == 'b', "heap values copy and move");
+        swap(big, moved);
+        bench_check(moved.is<std::array<char, 64>>() && big.is<vector<int>>(), "swap");
+        big = 2.5;
+        bench_check(big.is<double>() && any_cast<double>(big) == 2.5, "assign a new type");
+
+        auto boosts = make_values<boost::any>(1);
+        auto smalls = make_values<small_any>(1);
+        for (size_t i = 0; i < boosts.size(); ++i) {
+            bench_check(describe(boosts[i]) == describe(smalls[i]), "switch_ agrees with boost::any");
+        }
+    }
+
+    constexpr size_t ROUNDS = 200'000;
+    constexpr size_t N = ROUNDS * 7;
+
+    ptitle("construct " + to_string(N) + " values");
+    bench("vector<boost::any>", N, [&] { do_not_optimize(make_values<boost::any>(ROUNDS).data()); });
+    bench("vector<small_any>", N, [&] { do_not_optimize(make_values<small_any>(ROUNDS).data()); });
+
+    auto boosts = make_values<boost::any>(ROUNDS);
+    auto smalls = make_values<small_any>(ROUNDS);
+
+    ptitle("copy " + to_string(N) + " values");
+    bench("vector<boost::any>", N, [&] { auto c = boosts; do_not_optimize(c.data()); });
+    bench("vector<small_any>", N, [&] { auto c = smalls; do_not_optimize(c.data()); });
+
+    ptitle("switch_ dispatch, cheap handlers");
+    bench("boost::any", N, [&] {
+        long s = 0;
+        for (auto& a : boosts) s += classify(a);
+        do_not_optimize(s);
+    });
+    bench("small_any", N, [&] {
+        long s = 0;
+        for (auto& a : smalls) s += classify(a);
+        do_not_optimize(s);
+    });
+
+    ptitle("switch_ dispatch, the file's string handlers");
+    bench("boost::any", N, [&] {
+        size_t s = 0;
+        for (auto& a : boosts) s += describe(a).size();
+        do_not_optimize(s);
+    });
+    bench("small_any", N, [&] {
+        size_t s = 0;
+        for (auto& a : smalls) s += describe(a).size();
+        do_not_optimize(s);
+    });
+}
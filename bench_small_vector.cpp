@@ -0,0 +1,81 @@
+/*
+ * Benchmark: short-lived small collections in std::vector vs small_vector vs static_vector.
+ * Each round builds a container of K elements, iterates it once, and throws it away,
+ * which is the multi_push / make_object_with_brace usage pattern.
+ */
+#include "utils.h"
+#include "bench.h"
+#include "small_vector.h"
+
+
+template<typename Vec>
+long build_and_sum(size_t rounds, int k) {
+    long total = 0;
+    for (size_t r = 0; r < rounds; ++r) {
+        Vec vec;
+        for (int i = 0; i < k; ++i) {
+            vec.push_back(static_cast<int>(r) + i);
+        }
+        for (auto x : vec) {
+            total += x;
+        }
+        do_not_optimize(vec.data());
+    }
+    return total;
+}
+
+template<typename Vec>
+size_t build_strings(size_t rounds) {
+    size_t total = 0;
+    for (size_t r = 0; r < rounds; ++r) {
+        Vec vec {"apple", "banana", "cherry", "dory"};
+        for (auto& s : vec) {
+            total += s.size();
+        }
+        do_not_optimize(vec.data());
+    }
+    return total;
+}
+
+
+int main() {
+    // correctness: inline, spilled, moved and copied states all look like a vector
+    small_vector<int, 4> a {1, 2, 3};
+    bench_check(a.is_inline() && a.size() == 3, "small_vector starts inline");
+    for (int i = 4; i <= 10; ++i) a.push_back(i);
+    bench_check(!a.is_inline() && a.size() == 10 && a.back() == 10, "small_vector spills");
+    auto b = std::move(a);
+    bench_check(a.empty() && a.is_inline() && b.size() == 10, "move steals the heap block");
+    small_vector<int, 4> c = b;
+    c.erase(c.begin() + 1, c.begin() + 9);
+    c.insert(c.begin() + 1, 42);
+    bench_check(c == small_vector<int, 4>{1, 42, 10}, "erase/insert");
+    static_vector<string, 2> sv {"x", "y"};
+    bool threw = false;
+    try { sv.push_back("z"); } catch (const std::length_error&) { threw = true; }
+    bench_check(threw, "static_vector throws when full");
+    cout << "small_vector " << b << ", static_vector " << sv << endl;
+
+    constexpr size_t ROUNDS = 2'000'000;
+    for (int k : {4, 8, 16}) {
+        ptitle("push_back " + to_string(k) + " ints then iterate, " + to_string(ROUNDS) + " rounds");
+        bench("std::vector<int>", ROUNDS, [&] { do_not_optimize(build_and_sum<vector<int>>(ROUNDS, k)); });
+        bench("small_vector<int, 8>", ROUNDS, [&] {
+            do_not_optimize(build_and_sum<small_vector<int, 8>>(ROUNDS, k));
+        });
+        bench("static_vector<int, 16>", ROUNDS, [&] {
+            do_not_optimize(build_and_sum<static_vector<int, 16>>(ROUNDS, k));
+        });
+    }
+
+    ptitle("initializer_list of 4 strings, " + to_string(ROUNDS) + " rounds");
+    bench("std::vector<string>", ROUNDS, [&] { do_not_optimize(build_strings<vector<string>>(ROUNDS)); });
+    bench("small_vector<string, 4>", ROUNDS, [&] {
+        do_not_optimize(build_strings<small_vector<string, 4>>(ROUNDS));
+    });
+    bench("static_vector<string, 4>", ROUNDS, [&] {
+        do_not_optimize(build_strings<static_vector<string, 4>>(ROUNDS));
+    });
+
+    return 0;
+}
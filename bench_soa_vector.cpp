@@ -0,0 +1,133 @@
+/*
+ * Benchmark: a hana-reflected aggregate stored as vector<T> against soa_vector<T>.
+ * Scans that read one member, then one that needs a whole row.
+ */
+#include <random>
+#include "utils.h"
+#include "bench.h"
+#include "animals.h"
+#include "soa_vector.h"
+
+
+struct Critter {
+    BOOST_HANA_DEFINE_STRUCT(Critter,
+        (string, name),
+        (int, age),
+        (float, weight),
+        (double, x),
+        (double, y),
+        (std::uint64_t, id)
+    );
+};
+
+bool operator==(const Critter& a, const Critter& b) {
+    return hana::equal(a, b);
+}
+
+
+int main() {
+    constexpr size_t N = 2'000'000;
+
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> age(0, 20);
+    std::uniform_real_distribution<double> pos(-100, 100);
+    vector<Critter> aos;
+    aos.reserve(N);
+    soa_vector<Critter> soa;
+    soa.reserve(N);
+    for (size_t i = 0; i < N; ++i) {
+        aos.push_back(Critter{"critter_" + to_string(i), age(rng), static_cast<float>(pos(rng) + 100), pos(rng),
+                              pos(rng), i});
+        soa.push_back(aos.back());
+    }
+
+    // correctness
+    {
+        bench_check(soa.size() == N && soa.num_members == 6, "size and member count");
+        for (size_t i = 0; i < N; i += 9973) {
+            bench_check(soa.load(i) == aos[i] && Critter(soa[i]) == aos[i], "row round trip");
+        }
+        soa_vector<Critter> small;
+        Critter c {"a_name_longer_than_the_sso_buffer", 1, 2.0f, 3.0, 4.0, 5};
+        small.push_back(std::move(c));
+        bench_check(c.name.empty() && small[0].get<0>() == "a_name_longer_than_the_sso_buffer", "rvalue rows are moved");
+        small[0][BOOST_HANA_STRING("age")] += 41;
+        bench_check(get<1>(small[0]) == 42 && small.column(BOOST_HANA_STRING("age"))[0] == 42, "proxy writes through");
+        small[0] = Critter{"b", 7, 0.5f, 0, 0, 9};
+        bench_check(small.load(0) == (Critter{"b", 7, 0.5f, 0, 0, 9}), "proxy assignment");
+        small.push_back(Critter{"c", 8, 0, 0, 0, 10});
+        int sum = 0;
+        for (auto row : small) sum += row.get<1>();
+        bench_check(sum == 15, "row iteration");
+        small[0] = small[1];
+        bench_check(small.load(0) == small.load(1) && small.load(0).name == "c", "row to row assignment");
+        small[1] = std::as_const(small)[0];
+        small[0].get<1>() = 99;
+        bench_check(small.load(1).age == 8, "assigned rows stay separate");
+        vector<string> names;
+        small.for_each_column([&](const char* name, auto col) {
+            names.push_back(name);
+            bench_check(col.size() == 2, "columns have one entry per row");
+        });
+        bench_check(names == vector<string>{"name", "age", "weight", "x", "y", "id"}, "for_each_column order");
+
+        soa_vector<Fish> school;
+        school.push_back(Fish{"nemo"});
+        bench_check(school.column<0>()[0] == "nemo", "adapted animals");
+    }
+    cout << "column bytes: vector<Critter> " << aos.capacity() * sizeof(Critter) / (1 << 20) << " MB, soa_vector "
+         << soa.memory_bytes() / (1 << 20) << " MB (string contents excluded from both)" << endl;
+
+    ptitle("sum of ages, " + to_string(N) + " rows");
+    bench("vector<Critter> loop", N, [&] {
+        long long s = 0;
+        for (auto& c : aos) s += c.age;
+        do_not_optimize(s);
+    });
+    bench("soa_vector column<age>", N, [&] {
+        long long s = 0;
+        for (int a : soa.column(BOOST_HANA_STRING("age"))) s += a;
+        do_not_optimize(s);
+    });
+
+    ptitle("count weight > 150");
+    bench("vector<Critter> loop", N, [&] {
+        size_t n = 0;
+        for (auto& c : aos) n += c.weight > 150.0f;
+        do_not_optimize(n);
+    });
+    bench("soa_vector column<weight>", N, [&] {
+        size_t n = 0;
+        for (float w : soa.column<2>()) n += w > 150.0f;
+        do_not_optimize(n);
+    });
+
+    ptitle("translate x by 1.5 (read-modify-write)");
+    bench("vector<Critter> loop", N, [&] {
+        for (auto& c : aos) c.x += 1.5;
+        clobber_memory();
+    });
+    bench("soa_vector column<x>", N, [&] {
+        for (double& x : soa.column<3>()) x += 1.5;
+        clobber_memory();
+    });
+
+    ptitle("whole rows: total name length where age == 7");
+    bench("vector<Critter> loop", N, [&] {
+        size_t n = 0;
+        for (auto& c : aos) if (c.age == 7) n += c.name.size();
+        do_not_optimize(n);
+    });
+    bench("soa_vector two columns", N, [&] {
+        auto ages = soa.column<1>();
+        auto names = soa.column<0>();
+        size_t n = 0;
+        for (size_t i = 0; i < ages.size(); ++i) if (ages[i] == 7) n += names[i].size();
+        do_not_optimize(n);
+    });
+    bench("soa_vector row proxies", N, [&] {
+        size_t n = 0;
+        for (auto row : soa) if (row.get<1>() == 7) n += row.get<0>().size();
+        do_not_optimize(n);
+    });
+}
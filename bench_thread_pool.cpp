@@ -0,0 +1,98 @@
+/*
+ * Benchmark: batch smart_serialize of a mixed zoo on the work-stealing thread_pool,
+ * scaling from 1 worker to all cores, and auto-tuned against fixed chunk sizes.
+ */
+#include <numeric>
+#include <random>
+#include "utils.h"
+#include "bench.h"
+#include "smart_serialize.h"
+
+
+using Animal = std::variant<Fish, SFish, Cat, SCat, Dog, SDog>;
+
+vector<Animal> make_zoo(size_t n) {
+    std::mt19937 rng(3);
+    vector<Animal> zoo;
+    zoo.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        string name = "animal_number_" + to_string(i);  // past the SSO limit, like real names
+        switch (rng() % 6) {
+            case 0: zoo.emplace_back(Fish{name}); break;
+            case 1: zoo.emplace_back(SFish{{name}}); break;
+            case 2: zoo.emplace_back(Cat{name}); break;
+            case 3: zoo.emplace_back(SCat{{name}}); break;
+            case 4: zoo.emplace_back(Dog{name}); break;
+            default: zoo.emplace_back(SDog{{name}}); break;
+        }
+    }
+    return zoo;
+}
+
+
+int main() {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+    // correctness
+    {
+        thread_pool pool(4);
+        bench_check(pool.submit([] { return 6 * 7; }).get() == 42, "submit returns a future");
+        vector<long> squares(100'000);
+        pool.parallel_for(size_t{0}, squares.size(), [&](size_t i) { squares[i] = static_cast<long>(i * i); });
+        long expected = 0;
+        for (size_t i = 0; i < squares.size(); ++i) expected += static_cast<long>(i * i);
+        bench_check(std::accumulate(squares.begin(), squares.end(), 0L) == expected, "parallel_for covers the range");
+
+        bool threw = false;
+        try {
+            pool.parallel_for(0, 1000, [](int i) { if (i == 777) throw std::runtime_error("boom"); }, 10);
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        bench_check(threw, "exceptions reach the caller");
+
+        std::atomic<int> inner {0};
+        pool.parallel_for(0, 8, [&](int) {
+            pool.parallel_for(0, 100, [&](int) { ++inner; }, 1);  // workers help instead of blocking
+        }, 1);
+        bench_check(inner == 800, "nested parallel_for");
+
+        auto zoo = make_zoo(10'000);
+        auto serials = parallel_smart_serialize(pool, zoo);
+        for (size_t i = 0; i < zoo.size(); ++i) {
+            bench_check(serials[i] == smart_serialize1(zoo[i]), "parallel serialize matches sequential");
+        }
+    }
+
+    constexpr size_t N = 1'000'000;
+    auto zoo = make_zoo(N);
+    vector<string> out(N);
+
+    ptitle("smart_serialize " + to_string(N) + " animals, " + to_string(cores) + " cores");
+    bench("sequential loop", N, [&] {
+        for (size_t i = 0; i < N; ++i) out[i] = smart_serialize1(zoo[i]);
+    });
+    vector<unsigned> sizes;
+    for (unsigned t = 1; t < cores; t *= 2) sizes.push_back(t);
+    sizes.push_back(cores);
+    if (cores == 1) sizes.push_back(2);  // at least exercise stealing between two workers
+    for (unsigned threads : sizes) {
+        thread_pool pool(threads);
+        double ms = bench("pool(" + to_string(threads) + "), auto grain", N, [&] {
+            parallel_smart_serialize(pool, zoo.begin(), zoo.end(), out.begin());
+        });
+        std::printf("  %-44s %10zu elements per chunk\n", "", pool.last_grain());
+        do_not_optimize(ms);
+    }
+
+    ptitle("chunk size, pool(" + to_string(cores) + ")");
+    thread_pool pool(cores);
+    for (size_t grain : {size_t{1}, size_t{16}, size_t{1024}, size_t{65536}, N}) {
+        bench("grain " + to_string(grain), N, [&] {
+            parallel_smart_serialize(pool, zoo.begin(), zoo.end(), out.begin(), grain);
+        });
+    }
+    bench_check(out[N - 1] == smart_serialize1(zoo[N - 1]), "last element");
+    return 0;
+}
@@ -0,0 +1,255 @@
+/*
+ * Benchmark: value_switch against the hand-written alternatives, on random inputs
+ * with some misses mixed in:
+ *   - 12 dense opcodes (jump table) and 13 sparse HTTP status codes (binary search),
+ *     against an if / else chain and a plain switch statement
+ *   - 9 HTTP methods (perfect hash), against an if / else chain of string compares
+ *     and an unordered_map<string, function>
+ */
+#include "utils.h"
+#include "bench.h"
+#include <climits>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include "value_switch.h"
+
+using namespace value_switch_literals;
+
+
+long opcode_switch(int op) {
+    return value_switch(op)(
+        case_v<0>([] { return 3L; }),
+        case_v<1>([] { return 5L; }),
+        case_v<2>([] { return 7L; }),
+        case_v<3>([] { return 11L; }),
+        case_v<4>([] { return 13L; }),
+        case_v<5>([] { return 17L; }),
+        case_v<6>([] { return 19L; }),
+        case_v<7>([] { return 23L; }),
+        case_v<8>([] { return 29L; }),
+        case_v<9>([] { return 31L; }),
+        case_v<10>([] { return 37L; }),
+        case_v<11>([] { return 41L; }),
+        default_([] { return -1L; })
+    );
+}
+
+long opcode_chain(int op) {
+    if (op == 0) return 3;
+    else if (op == 1) return 5;
+    else if (op == 2) return 7;
+    else if (op == 3) return 11;
+    else if (op == 4) return 13;
+    else if (op == 5) return 17;
+    else if (op == 6) return 19;
+    else if (op == 7) return 23;
+    else if (op == 8) return 29;
+    else if (op == 9) return 31;
+    else if (op == 10) return 37;
+    else if (op == 11) return 41;
+    else return -1;
+}
+
+long opcode_builtin(int op) {
+    switch (op) {
+        case 0: return 3;
+        case 1: return 5;
+        case 2: return 7;
+        case 3: return 11;
+        case 4: return 13;
+        case 5: return 17;
+        case 6: return 19;
+        case 7: return 23;
+        case 8: return 29;
+        case 9: return 31;
+        case 10: return 37;
+        case 11: return 41;
+        default: return -1;
+    }
+}
+
+const int STATUS[] = {200, 201, 204, 301, 302, 304, 400, 401, 403, 404, 500, 502, 503};
+
+long status_switch(int code) {
+    return value_switch(code)(
+        case_v<200>([] { return 1L; }),
+        case_v<201>([] { return 2L; }),
+        case_v<204>([] { return 3L; }),
+        case_v<301>([] { return 4L; }),
+        case_v<302>([] { return 5L; }),
+        case_v<304>([] { return 6L; }),
+        case_v<400>([] { return 7L; }),
+        case_v<401>([] { return 8L; }),
+        case_v<403>([] { return 9L; }),
+        case_v<404>([] { return 10L; }),
+        case_v<500>([] { return 11L; }),
+        case_v<502>([] { return 12L; }),
+        case_v<503>([] { return 13L; }),
+        default_([] { return -1L; })
+    );
+}
+
+long status_chain(int code) {
+    if (code == 200) return 1;
+    else if (code == 201) return 2;
+    else if (code == 204) return 3;
+    else if (code == 301) return 4;
+    else if (code == 302) return 5;
+    else if (code == 304) return 6;
+    else if (code == 400) return 7;
+    else if (code == 401) return 8;
+    else if (code == 403) return 9;
+    else if (code == 404) return 10;
+    else if (code == 500) return 11;
+    else if (code == 502) return 12;
+    else if (code == 503) return 13;
+    else return -1;
+}
+
+long status_builtin(int code) {
+    switch (code) {
+        case 200: return 1;
+        case 201: return 2;
+        case 204: return 3;
+        case 301: return 4;
+        case 302: return 5;
+        case 304: return 6;
+        case 400: return 7;
+        case 401: return 8;
+        case 403: return 9;
+        case 404: return 10;
+        case 500: return 11;
+        case 502: return 12;
+        case 503: return 13;
+        default: return -1;
+    }
+}
+
+const char* const METHODS[] = {"GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH"};
+
+long method_switch(const string& m) {
+    return value_switch(m)(
+        case_s("GET"_s)([] { return 1L; }),
+        case_s("HEAD"_s)([] { return 2L; }),
+        case_s("POST"_s)([] { return 3L; }),
+        case_s("PUT"_s)([] { return 4L; }),
+        case_s("DELETE"_s)([] { return 5L; }),
+        case_s("CONNECT"_s)([] { return 6L; }),
+        case_s("OPTIONS"_s)([] { return 7L; }),
+        case_s("TRACE"_s)([] { return 8L; }),
+        case_s("PATCH"_s)([] { return 9L; }),
+        default_([] { return -1L; })
+    );
+}
+
+long method_chain(const string& m) {
+    if (m == "GET") return 1;
+    else if (m == "HEAD") return 2;
+    else if (m == "POST") return 3;
+    else if (m == "PUT") return 4;
+    else if (m == "DELETE") return 5;
+    else if (m == "CONNECT") return 6;
+    else if (m == "OPTIONS") return 7;
+    else if (m == "TRACE") return 8;
+    else if (m == "PATCH") return 9;
+    else return -1;
+}
+
+const std::unordered_map<string, std::function<long()>>& method_table() {
+    static const std::unordered_map<string, std::function<long()>> table {
+        {"GET", [] { return 1L; }}, {"HEAD", [] { return 2L; }}, {"POST", [] { return 3L; }},
+        {"PUT", [] { return 4L; }}, {"DELETE", [] { return 5L; }}, {"CONNECT", [] { return 6L; }},
+        {"OPTIONS", [] { return 7L; }}, {"TRACE", [] { return 8L; }}, {"PATCH", [] { return 9L; }},
+    };
+    return table;
+}
+
+long method_map(const string& m) {
+    auto& table = method_table();
+    auto it = table.find(m);
+    return it == table.end() ? -1 : it->second();
+}
+
+
+int main() {
+    constexpr size_t N = 1'000'000;
+    std::mt19937 rng(42);
+
+    // about one input in eight misses every case
+    vector<int> ops(N), codes(N);
+    vector<string> methods(N);
+    for (size_t i = 0; i < N; ++i) {
+        bool miss = rng() % 8 == 0;
+        ops[i] = miss ? 12 + static_cast<int>(rng() % 100) : static_cast<int>(rng() % 12);
+        codes[i] = miss ? 100 + static_cast<int>(rng() % 500) : STATUS[rng() % 13];
+        methods[i] = miss ? "BREW" : METHODS[rng() % 9];
+    }
+
+    // correctness
+    {
+        bench_check(value_switch_kind_for<int>(case_v<0>(0), case_v<1>(0), case_v<3>(0)) == switch_kind::jump_table,
+                    "dense ints get a jump table");
+        bench_check(value_switch_kind_for<int>(case_v<1>(0), case_v<1000>(0)) == switch_kind::binary_search,
+                    "sparse ints get a binary search");
+        bench_check(value_switch_kind_for<string>(case_s("a"_s)(0)) == switch_kind::perfect_hash,
+                    "strings get a perfect hash");
+        for (int op = -3; op < 120; ++op) {
+            bench_check(opcode_switch(op) == opcode_builtin(op), "opcode " + to_string(op));
+        }
+        for (int code = 0; code < 700; ++code) {
+            bench_check(status_switch(code) == status_builtin(code), "status " + to_string(code));
+        }
+        for (string m : {"GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH",
+                         "", "get", "GETX", "PUTT", "BREW"}) {
+            bench_check(method_switch(m) == method_chain(m) && method_map(m) == method_chain(m), "method " + m);
+        }
+        enum class color : unsigned char { red = 1, green = 2, blue = 250 };
+        auto name = [](color c) {
+            return value_switch(c)(
+                case_v<color::red>([] { return "red"s; }),
+                case_v<color::blue>([] { return "blue"s; }),
+                default_([] { return "?"s; })
+            );
+        };
+        bench_check(name(color::red) == "red" && name(color::blue) == "blue" && name(color::green) == "?",
+                    "enum cases");
+        auto sign = [](long long x) {
+            return value_switch(x)(
+                case_v<-1LL>([] { return -1; }),
+                case_v<LLONG_MIN>([] { return -2; }),
+                case_v<LLONG_MAX>([] { return 2; }),
+                default_([] { return 0; })
+            );
+        };
+        bench_check(sign(-1) == -1 && sign(LLONG_MIN) == -2 && sign(LLONG_MAX) == 2 && sign(0) == 0,
+                    "extreme 64-bit cases");
+        bench_check(value_switch(42)(default_([](int x) { return x + 1; })) == 43 &&
+                    value_switch("GET"s)(default_([] { return 7; })) == 7,
+                    "only a default");
+        bench_check(value_switch_kind_for<int>() == switch_kind::jump_table, "no cases plan");
+    }
+
+    auto run = [](const auto& inputs, auto f) {
+        return [&inputs, f] {
+            long s = 0;
+            for (auto& x : inputs) s += f(x);
+            do_not_optimize(s);
+        };
+    };
+
+    ptitle("12 dense opcodes");
+    bench("if / else chain", N, run(ops, opcode_chain));
+    bench("switch statement", N, run(ops, opcode_builtin));
+    bench("value_switch (jump table)", N, run(ops, opcode_switch));
+
+    ptitle("13 sparse status codes");
+    bench("if / else chain", N, run(codes, status_chain));
+    bench("switch statement", N, run(codes, status_builtin));
+    bench("value_switch (binary search)", N, run(codes, status_switch));
+
+    ptitle("9 method names");
+    bench("if / else chain", N, run(methods, method_chain));
+    bench("unordered_map<string, function>", N, run(methods, method_map));
+    bench("value_switch (perfect hash)", N, run(methods, method_switch));
+}
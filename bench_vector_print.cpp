@@ -0,0 +1,118 @@
+/*
+ * Benchmark: operator<< for big numeric vectors, the old element-by-element
+ * ostream loop against the to_chars chunked path in vector_like.h, and the summarized mode.
+ * Output goes to a stream that only counts bytes, so this measures formatting.
+ */
+#include <iomanip>
+#include <random>
+#include "utils.h"
+#include "bench.h"
+#include "small_vector.h"
+
+
+// the operator<< utils.h used to have
+template<typename VecT>
+void old_print(std::ostream& oss, const VecT& vec) {
+    oss << "[";
+    string delim = "";
+    for (auto& i : vec) {
+        oss << delim << i;
+        delim = ", ";
+    }
+    oss << "]";
+}
+
+template<typename VecT, typename Manip>
+void check_same(const VecT& vec, Manip manip, const string& what) {
+    ostringstream expected, actual;
+    manip(expected);
+    manip(actual);
+    old_print(expected, vec);
+    actual << vec;
+    bench_check(expected.str() == actual.str(), "byte-identical output: " + what);
+}
+
+class counting_buf : public std::streambuf {
+public:
+    size_t bytes = 0;
+protected:
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        bytes += static_cast<size_t>(n);
+        return n;
+    }
+    int_type overflow(int_type c) override {
+        ++bytes;
+        return c;
+    }
+};
+
+
+int main() {
+    std::mt19937_64 rng(9);
+    std::uniform_real_distribution<double> real(-1e6, 1e6);
+    vector<double> doubles(10'000);
+    for (auto& x : doubles) x = real(rng) * std::pow(10.0, static_cast<int>(rng() % 30) - 15);
+    doubles.push_back(0.1 + 0.2);
+    doubles.push_back(-0.0);
+    doubles.push_back(std::numeric_limits<double>::infinity());
+    doubles.push_back(std::numeric_limits<double>::quiet_NaN());
+    vector<float> floats(doubles.begin(), doubles.end());
+    vector<long long> longs(10'000);
+    for (auto& x : longs) x = static_cast<long long>(rng());
+    vector<unsigned> uints(longs.begin(), longs.end());
+    vector<unsigned char> bytes {65, 66, 67};
+    vector<string> strings {"a", "bc", ""};
+    small_vector<short, 4> shorts {1, -2, 3, -4, 5};
+
+    auto plain = [](std::ostream&) {};
+    check_same(doubles, plain, "double");
+    check_same(doubles, [](std::ostream& os) { os << std::setprecision(17); }, "double precision 17");
+    check_same(doubles, [](std::ostream& os) { os << std::setprecision(3) << std::fixed; }, "double fixed");
+    check_same(doubles, [](std::ostream& os) { os << std::scientific; }, "double scientific");
+    check_same(doubles, [](std::ostream& os) { os << std::hexfloat; }, "double hexfloat (ostream path)");
+    check_same(floats, plain, "float");
+    check_same(longs, plain, "long long");
+    check_same(longs, [](std::ostream& os) { os << std::hex; }, "hex (ostream path)");
+    check_same(uints, plain, "unsigned");
+    check_same(bytes, plain, "unsigned char");
+    check_same(strings, plain, "string");
+    check_same(shorts, plain, "small_vector<short>");
+    check_same(vector<int>{}, plain, "empty");
+
+    vector<int> hundred(100);
+    for (int i = 0; i < 100; ++i) hundred[i] = i;
+    ostringstream summary;
+    summary << vec_summary(10, 3) << hundred << " " << vector<int>{1, 2} << " "
+            << vec_shape << vec_stats << hundred << vec_no_header << vec_full << " " << vector<int>{1, 2, 3};
+    bench_check(summary.str() == "[0, 1, 2, ..., 97, 98, 99] [1, 2] "
+                                 "shape=(100,) min=0 max=99 mean=49.5 [0, 1, 2, ..., 97, 98, 99] [1, 2, 3]",
+                "summary: " + summary.str());
+    ostringstream strs;
+    strs << vec_summary(2, 1) << vector<string>{"a", "b", "c"};
+    bench_check(strs.str() == "[a, ..., c]", "summary of strings: " + strs.str());
+    cout << vec_summary(10, 3) << vec_shape << vec_stats << std::setprecision(4) << doubles << endl
+         << vec_no_header << vec_full << std::setprecision(6);
+
+    constexpr size_t N = 5'000'000;
+    vector<double> big(N);
+    for (auto& x : big) x = real(rng);
+    vector<int> big_ints(N);
+    for (auto& x : big_ints) x = static_cast<int>(rng());
+
+    counting_buf sink;
+    std::ostream out(&sink);
+    ptitle("print " + to_string(N) + " elements");
+    bench("old loop, vector<double>", N, [&] { old_print(out, big); });
+    bench("operator<<, vector<double>", N, [&] { out << big; });
+    bench("old loop, vector<int>", N, [&] { old_print(out, big_ints); });
+    bench("operator<<, vector<int>", N, [&] { out << big_ints; });
+
+    ptitle("print 50M doubles summarized");
+    vector<double> huge(50'000'000, 1.5);
+    out << vec_summary();
+    bench("operator<<, vec_summary()", 1, [&] { out << huge; });
+    out << vec_shape << vec_stats;
+    bench("operator<<, vec_summary() with stats", huge.size(), [&] { out << huge; });
+    do_not_optimize(sink.bytes);
+    return 0;
+}
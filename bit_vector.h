@@ -0,0 +1,333 @@
+#ifndef EFFECTIVECPP_BIT_VECTOR_H
+#define EFFECTIVECPP_BIT_VECTOR_H
+
+/*
+ * bit_vector: a dynamic bitset without vector<bool>'s proxy references.
+ * test() returns a plain bool, writes go through set/reset/flip, so
+ * `auto b = bits.test(3);` is always a bool (see the pitfall in ch2_auto.cpp).
+ *
+ * Bits are packed into 64-bit words, least significant bit first, and the unused
+ * tail of the last word is kept at zero so count/find/== never see garbage.
+ * Bulk &, |, ^ and and_not run on whole words, 256 bits at a time with AVX2 or
+ * 128 with SSE2 when the compiler targets them.
+ *
+ * bit_rank_select builds a small index on top of a bit_vector for O(1) rank and
+ * O(log n) select, the basic block of succinct data structures.
+ */
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <vector>
+#include "aligned_allocator.h"
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+inline unsigned popcount64(std::uint64_t w) noexcept {
+#ifdef __POPCNT__
+    return static_cast<unsigned>(__builtin_popcountll(w));
+#else
+    // without -mpopcnt the builtin is a libgcc call, the SWAR version is faster and vectorizes
+    w = w - ((w >> 1) & 0x5555555555555555ull);
+    w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+    w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<unsigned>((w * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+inline unsigned ctz64(std::uint64_t w) noexcept {
+    return static_cast<unsigned>(__builtin_ctzll(w));
+}
+
+
+class bit_vector {
+public:
+    using word_type = std::uint64_t;
+    static constexpr std::size_t WORD_BITS = 64;
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    bit_vector() = default;
+    explicit bit_vector(std::size_t n, bool value = false)
+    : words(num_words_for(n), value ? ~word_type{0} : 0), nbits(n) {
+        clear_tail();
+    }
+    bit_vector(std::initializer_list<bool> init) {
+        reserve(init.size());
+        for (bool b : init) {
+            push_back(b);
+        }
+    }
+
+    std::size_t size() const noexcept { return nbits; }
+    bool empty() const noexcept { return nbits == 0; }
+
+    void resize(std::size_t n, bool value = false) {
+        std::size_t old = nbits;
+        words.resize(num_words_for(n), value ? ~word_type{0} : 0);
+        nbits = n;
+        if (value && n > old && old % WORD_BITS) {
+            // the partial word that used to be the last one
+            words[old / WORD_BITS] |= ~word_type{0} << (old % WORD_BITS);
+        }
+        clear_tail();
+    }
+    void reserve(std::size_t n) { words.reserve(num_words_for(n)); }
+    void clear() noexcept {
+        words.clear();
+        nbits = 0;
+    }
+
+    void push_back(bool value) {
+        if (nbits % WORD_BITS == 0) {
+            words.push_back(0);
+        }
+        words.back() |= word_type{value} << (nbits % WORD_BITS);
+        ++nbits;
+    }
+
+    /***************** single bits *****************/
+    bool test(std::size_t i) const noexcept {
+        assert(i < nbits);
+        return (words[i / WORD_BITS] >> (i % WORD_BITS)) & 1u;
+    }
+    void set(std::size_t i) noexcept {
+        assert(i < nbits);
+        words[i / WORD_BITS] |= word_type{1} << (i % WORD_BITS);
+    }
+    void set(std::size_t i, bool value) noexcept {
+        assert(i < nbits);
+        word_type mask = word_type{1} << (i % WORD_BITS);
+        word_type& w = words[i / WORD_BITS];
+        w = (w & ~mask) | (-word_type{value} & mask);
+    }
+    void reset(std::size_t i) noexcept {
+        assert(i < nbits);
+        words[i / WORD_BITS] &= ~(word_type{1} << (i % WORD_BITS));
+    }
+    void flip(std::size_t i) noexcept {
+        assert(i < nbits);
+        words[i / WORD_BITS] ^= word_type{1} << (i % WORD_BITS);
+    }
+
+    /***************** all bits *****************/
+    void set() noexcept {
+        std::fill(words.begin(), words.end(), ~word_type{0});
+        clear_tail();
+    }
+    void reset() noexcept { std::fill(words.begin(), words.end(), 0); }
+    void flip() noexcept {
+        for (auto& w : words) {
+            w = ~w;
+        }
+        clear_tail();
+    }
+
+    // number of set bits
+    std::size_t count() const noexcept {
+        std::size_t n = 0;
+        for (word_type w : words) {
+            n += popcount64(w);
+        }
+        return n;
+    }
+    bool any() const noexcept {
+        return std::any_of(words.begin(), words.end(), [](word_type w) { return w != 0; });
+    }
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return count() == nbits; }
+
+    // index of the first set bit, npos if none
+    std::size_t find_first() const noexcept { return find_from_word(0); }
+
+    // index of the first set bit after i, npos if none
+    std::size_t find_next(std::size_t i) const noexcept {
+        ++i;
+        if (i >= nbits) {
+            return npos;
+        }
+        std::size_t wi = i / WORD_BITS;
+        word_type w = words[wi] & (~word_type{0} << (i % WORD_BITS));
+        if (w) {
+            return wi * WORD_BITS + ctz64(w);
+        }
+        return find_from_word(wi + 1);
+    }
+
+    /***************** word access *****************/
+    std::size_t num_words() const noexcept { return words.size(); }
+    word_type word(std::size_t wi) const noexcept { return words[wi]; }
+    // callers must keep the bits past size() zero, see clear_tail()
+    word_type* data() noexcept { return words.data(); }
+    const word_type* data() const noexcept { return words.data(); }
+    // zero the unused bits of the last word after writing through data()
+    void clear_tail() noexcept {
+        if (nbits % WORD_BITS) {
+            words.back() &= (word_type{1} << (nbits % WORD_BITS)) - 1;
+        }
+    }
+
+    /***************** bulk boolean algebra, sizes must match *****************/
+    bit_vector& operator&=(const bit_vector& other) noexcept {
+        assert(nbits == other.nbits);
+        bulk(other, [](auto a, auto b) { return a & b; });
+        return *this;
+    }
+    bit_vector& operator|=(const bit_vector& other) noexcept {
+        assert(nbits == other.nbits);
+        bulk(other, [](auto a, auto b) { return a | b; });
+        return *this;
+    }
+    bit_vector& operator^=(const bit_vector& other) noexcept {
+        assert(nbits == other.nbits);
+        bulk(other, [](auto a, auto b) { return a ^ b; });
+        return *this;
+    }
+    // this & ~other, i.e. set difference
+    bit_vector& and_not(const bit_vector& other) noexcept {
+        assert(nbits == other.nbits);
+        bulk(other, [](auto a, auto b) { return a & ~b; });
+        return *this;
+    }
+
+    friend bool operator==(const bit_vector& a, const bit_vector& b) noexcept {
+        return a.nbits == b.nbits && a.words == b.words;
+    }
+    friend bool operator!=(const bit_vector& a, const bit_vector& b) noexcept { return !(a == b); }
+
+private:
+    static std::size_t num_words_for(std::size_t n) noexcept { return (n + WORD_BITS - 1) / WORD_BITS; }
+
+    std::size_t find_from_word(std::size_t wi) const noexcept {
+        for (; wi < words.size(); ++wi) {
+            if (words[wi]) {
+                return wi * WORD_BITS + ctz64(words[wi]);
+            }
+        }
+        return npos;
+    }
+
+    /*
+     * op is written once as a generic lambda and applied to __m256i, __m128i
+     * (GCC/clang vector extensions define &, |, ^, ~ on them) and to the scalar tail.
+     */
+    template<typename Op>
+    void bulk(const bit_vector& other, Op op) noexcept {
+        word_type* dst = words.data();
+        const word_type* src = other.words.data();
+        std::size_t n = words.size();
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= n; i += 4) {
+            __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), op(a, b));
+        }
+#elif defined(__SSE2__)
+        for (; i + 2 <= n; i += 2) {
+            __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(dst + i));
+            __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_store_si128(reinterpret_cast<__m128i*>(dst + i), op(a, b));
+        }
+#endif
+        for (; i < n; ++i) {
+            dst[i] = op(dst[i], src[i]);
+        }
+        clear_tail();  // and_not can't set tail bits, but keep the invariant obvious
+    }
+
+    // 32-byte aligned so the AVX2 loads above never split a cache line
+    std::vector<word_type, aligned_allocator<word_type, 32>> words;
+    std::size_t nbits = 0;
+};
+
+
+inline bit_vector operator&(bit_vector a, const bit_vector& b) { return a &= b; }
+inline bit_vector operator|(bit_vector a, const bit_vector& b) { return a |= b; }
+inline bit_vector operator^(bit_vector a, const bit_vector& b) { return a ^= b; }
+inline bit_vector operator~(bit_vector a) {
+    a.flip();
+    return a;
+}
+
+
+/*
+ * Rank/select index over a bit_vector that must not change while the index is used.
+ * One 64-bit cumulative count per 512-bit block (8 words), i.e. 12.5% extra space.
+ *   rank(i)   = number of set bits in [0, i)                    O(1): 1 lookup + <= 8 popcounts
+ *   select(k) = position of the k-th set bit (0-based), or npos  O(log n) binary search + scan
+ */
+class bit_rank_select {
+public:
+    static constexpr std::size_t BLOCK_WORDS = 8;
+    static constexpr std::size_t BLOCK_BITS = BLOCK_WORDS * bit_vector::WORD_BITS;
+
+    explicit bit_rank_select(const bit_vector& bits)
+    : bits(bits) {
+        std::size_t nblocks = (bits.num_words() + BLOCK_WORDS - 1) / BLOCK_WORDS;
+        block_rank.reserve(nblocks + 1);
+        std::size_t total = 0;
+        for (std::size_t wi = 0; wi < bits.num_words(); ++wi) {
+            if (wi % BLOCK_WORDS == 0) {
+                block_rank.push_back(total);
+            }
+            total += popcount64(bits.word(wi));
+        }
+        block_rank.push_back(total);
+    }
+
+    std::size_t rank(std::size_t i) const noexcept {
+        assert(i <= bits.size());
+        std::size_t wi = i / bit_vector::WORD_BITS;
+        std::size_t r = block_rank[wi / BLOCK_WORDS];
+        for (std::size_t w = wi / BLOCK_WORDS * BLOCK_WORDS; w < wi; ++w) {
+            r += popcount64(bits.word(w));
+        }
+        if (i % bit_vector::WORD_BITS) {
+            r += popcount64(bits.word(wi) & ((std::uint64_t{1} << (i % bit_vector::WORD_BITS)) - 1));
+        }
+        return r;
+    }
+
+    std::size_t select(std::size_t k) const noexcept {
+        if (k >= count()) {
+            return bit_vector::npos;
+        }
+        // last block whose starting rank is <= k
+        auto it = std::upper_bound(block_rank.begin(), block_rank.end(), k);
+        std::size_t block = static_cast<std::size_t>(it - block_rank.begin()) - 1;
+        k -= block_rank[block];
+        for (std::size_t wi = block * BLOCK_WORDS; ; ++wi) {
+            std::uint64_t w = bits.word(wi);
+            unsigned c = popcount64(w);
+            if (k < c) {
+                return wi * bit_vector::WORD_BITS + select_in_word(w, static_cast<unsigned>(k));
+            }
+            k -= c;
+        }
+    }
+
+    std::size_t count() const noexcept { return block_rank.back(); }
+
+private:
+    // position of the k-th set bit of w, k < popcount(w)
+    static unsigned select_in_word(std::uint64_t w, unsigned k) noexcept {
+#ifdef __BMI2__
+        return ctz64(_pdep_u64(std::uint64_t{1} << k, w));
+#else
+        while (k--) {
+            w &= w - 1;  // drop the lowest set bit
+        }
+        return ctz64(w);
+#endif
+    }
+
+    const bit_vector& bits;
+    std::vector<std::size_t> block_rank;
+};
+
+
+#endif //EFFECTIVECPP_BIT_VECTOR_H
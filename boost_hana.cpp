@@ -6,101 +6,16 @@
 
 #include "utils.h"
 #include <boost/hana.hpp>
+#include "smart_serialize.h"
+#include "soa_vector.h"
+#include "hana_hash.h"
 
 namespace hana = boost::hana;
 
 using namespace hana::literals;
-struct Fish { string name; };
-struct Cat  { string name; };
-struct Dog  { string name; };
 struct StaticDog  { static char name[4]; };
 struct NestedDog  { struct Inner; };
 
-struct SFish : public Fish {
-    string serialize() const {
-        return "Fish-serial:" + name;
-    }
-};
-struct SCat : public Cat {
-    string serialize() const {
-        return "Cat-serial:" + name;
-    }
-};
-struct SDog : public Dog {
-    string serialize() const {
-        return "Dog-serial:" + name;
-    }
-};
-
-
-ostream& operator<<(ostream& oss, const Fish& x) {
-    return oss << "Fish(" << x.name << ")";
-}
-ostream& operator<<(ostream& oss, const Cat& x) noexcept {
-    return oss << "Cat(" << x.name << ")";
-}
-ostream& operator<<(ostream& oss, const Dog& x) noexcept {
-    return oss << "Dog(" << x.name << ")";
-}
-
-/*
- * check if serialize exists
- */
-auto is_serializable = hana::is_valid([](auto&& x) -> decltype((void) x.serialize()) { });
-
-template<typename T>
-string smart_serialize1(const T& obj) {
-    if constexpr (decltype(is_serializable(obj))::value) {
-        return obj.serialize();
-    }
-    else {
-        return any_str(obj);
-    }
-}
-
-/*
- * Equivalent, using hana::sfinae compile time optional
- */
-auto maybe_serialize = hana::sfinae([](auto&& x) -> decltype(x.serialize()) {
-    return x.serialize();
-});
-
-template<typename T>
-string smart_serialize2(const T& obj) {
-    return maybe_serialize(obj).value_or(any_str(obj));
-}
-
-template<typename T>
-string smart_serialize3(const T& obj) {
-    auto ans = maybe_serialize(obj);
-    if constexpr (hana::is_just(ans)) {
-//        return ans.value();  // must if-constexpr, otherwise .value() won't compile
-        return *ans;  // equivalent to ans.value()
-    }
-    else {  // hana::is_nothing
-        return any_str(obj);
-    }
-}
-
-template<typename T>
-string smart_serialize4(T&& obj) {
-    return hana::if_(
-        is_serializable(obj),
-        [](auto&& obj) { return obj.serialize(); },
-        [](auto&& obj) { return any_str(obj); }
-    )(std::forward<T>(obj));
-}
-
-template<typename T>
-string smart_serialize5(T&& obj) {
-    return hana::eval_if(
-        is_serializable(obj),
-        // explanation for `_` see below
-        [&](auto _) { return _(obj).serialize(); },
-        [&](auto _) { return any_str(_(obj)); }
-    );
-}
-
 template<typename T>
 string hana_str(const T& tuple) {
     ostringstream oss;
@@ -113,6 +28,17 @@ string hana_str(const T& tuple) {
     return s.substr(0, s.size()-2) + ">";
 }
 
+// the same text, allocated from mr (see pmr_ostringstream in utils.h)
+template<typename T>
+std::pmr::string hana_str(std::pmr::memory_resource* mr, const T& tuple) {
+    pmr_ostringstream oss(mr);
+    oss << "Hana<";
+    hana::for_each(tuple, [&oss](const auto& a) { oss << a << ", "; });
+    std::pmr::string s = oss.release();
+    s.resize(s.size() - 2);
+    return s += ">";
+}
+
 template<typename T>
 void hana_print(const T& tuple) {
     cout << hana_str(tuple) << endl;
@@ -204,6 +130,37 @@ int main() {
     cout << smart_serialize5(Cat {"neko"}) << endl;
     cout << smart_serialize5(SCat {"neko"}) << endl;
 
+    // a whole zoo at once, serialized in chunks on a work-stealing pool
+    thread_pool pool(2);
+    vector<std::variant<Fish, SFish, Cat, SCat, Dog, SDog>> zoo {
+        Fish{"nemo"}, SFish{"dory"}, Cat{"tom"}, SCat{"felix"}, Dog{"odie"}, SDog{"pluto"}
+    };
+    cout << parallel_smart_serialize(pool, zoo) << endl;
+
+    // the same zoo twice through the memoized version: the second pass is all hits
+    for (int pass = 0; pass < 2; ++pass) {
+        for (auto& animal : zoo) {
+            memo_smart_serialize(animal);
+        }
+    }
+    cout << memo_smart_serialize(zoo[1]) << ", SFish cache: " << smart_serialize_memo<SFish>().stats() << endl;
+    cout << memo_tuple_str(std::make_tuple(1, "two"s, 3.5)) << " " << memo_type_str<decltype(zoo)::value_type>() << endl;
+
+    // the same animals stored member by member
+    soa_vector<Fish> school;
+    school.push_back(Fish{"nemo"});
+    school.push_back(Fish{"dory"});
+    school[1][BOOST_HANA_STRING("name")] += "-the-blue";
+    school.for_each_column([](const char* name, auto column) { cout << name << ": " << column << endl; });
+    cout << school.load(1) << endl;
+
+    // and as hash keys, hash and == derived from the adapted member
+    unordered_map<Fish, int, fast_hash<Fish>, fast_equal<Fish>> sightings;
+    for (const char* name : {"nemo", "dory", "nemo"}) {
+        ++sightings[Fish{name}];
+    }
+    cout << "nemo seen " << sightings[Fish{"nemo"}] << " times" << endl;
+
     ptype<decltype(is_serializable(SFish {"me"}))>();
     cout << "SFish decltype::value" << decltype(is_serializable(SFish {"me"}))::value << endl;
 
@@ -223,6 +180,13 @@ int main() {
         hana::make_tuple('f', 'a', 'l', 's', 'e')
     );
     hana_print(tup1);
+
+    // the string helpers again, on scratch memory from the stack: no heap allocation
+    char scratch[1024];
+    std::pmr::monotonic_buffer_resource arena(scratch, sizeof(scratch));
+    std::pmr::vector<double> samples({0.5, 1.25, -3.0}, &arena);
+    cout << hana_str(&arena, tup1) << " " << any_str(&arena, "samples ", samples, " ", Fish{"nemo"}) << endl;
+    cout << join_str(&arena, " | ", 1, "two", 3.5) << " " << tuple_str(&arena, std::make_tuple(0.1, 'c', "s"s)) << endl;
     BOOST_HANA_CONSTANT_CHECK(hana::not_(hana::true_c) == hana::false_c);
 
     cout << *my_make_unique1<vector<int>>(5, 7) << endl;  // invokes ()-ctor
@@ -1,6 +1,7 @@
 /*
  * Boost.Hana template magic
- * We will implement compile time meta-switch for type selection from boost::any
+ * Compile time meta-switch for type selection from boost::any (hana_switch.h),
+ * run sequentially and through a producer -> dispatch -> sink pipeline (pipeline.h)
  * doc: http://boostorg.github.io/hana/
  * https://jguegant.github.io/blogs/tech/sfinae-introduction.html
  */
@@ -8,25 +9,17 @@
 #include "utils.h"
 #include <boost/hana.hpp>
 #include <boost/any.hpp>
+#include <typeindex>
+#include "animals.h"
+#include "hana_switch.h"
+#include "pipeline.h"
+#include "small_any.h"
+#include "value_switch.h"
 
 namespace hana = boost::hana;
 
 using namespace hana::literals;
 
-struct Fish { string name; };
-struct Cat  { string name; };
-struct Dog  { string name; };
-
-ostream& operator<<(ostream& oss, const Fish& x) {
-    return oss << "Fish(" << x.name << ")";
-}
-ostream& operator<<(ostream& oss, const Cat& x) noexcept {
-    return oss << "Cat(" << x.name << ")";
-}
-ostream& operator<<(ostream& oss, const Dog& x) noexcept {
-    return oss << "Dog(" << x.name << ")";
-}
-
 template<typename T>
 string hana_str(const T& tuple) {
     ostringstream oss;
@@ -39,65 +32,20 @@ string hana_str(const T& tuple) {
     return s.substr(0, s.size()-2) + ">";
 }
 
+// the same text, allocated from mr (see pmr_ostringstream in utils.h)
 template<typename T>
-void hana_print(const T& tuple) {
-    cout << hana_str(tuple) << endl;
-}
-
-
-/*
- * associate each type to a function
- * pair.first is type and pair.second is actual function
- */
-template<typename T>
-auto case_ = [](auto f) {
-    return hana::make_pair(hana::type_c<T>, f);
-};
-
-struct default_t;
-auto default_ = case_<default_t>;
-
-// base case: no more cases left, execute the default
-template <typename Any, typename Default>
-auto _switch_process(Any&, std::type_index const&, Default& default_) {
-    return default_();
-}
-// recursion on ...Rest
-template <typename Any, typename Default, typename Case, typename ...Rest>
-auto _switch_process(Any& a, std::type_index const& t, Default& default_,
-    Case& case_, Rest& ...rest)
-{
-    using T = typename decltype(+hana::first(case_))::type;
-    // if Any's type matches the case type (first of the tuple), execute its associated function
-    return t == typeid(T) ? hana::second(case_)(*boost::unsafe_any_cast<T>(&a))
-        : _switch_process(a, t, default_, rest...);
+std::pmr::string hana_str(std::pmr::memory_resource* mr, const T& tuple) {
+    pmr_ostringstream oss(mr);
+    oss << "Hana<";
+    hana::for_each(tuple, [&oss](const auto& a) { oss << a << ", "; });
+    std::pmr::string s = oss.release();
+    s.resize(s.size() - 2);
+    return s += ">";
 }
 
-/*
- * switch_(arg) returns a lambda function that does the type dispatching
- */
 template<typename T>
-auto switch_(T& arg) {
-    return [&arg](auto ... cases_) {
-        // put into a hana tuple to mainipulate
-        auto cases = hana::make_tuple(cases_ ...);
-        // find the default case first, returns hana::optional
-        // predicate must be generic because of heterogenous typing and must return hana IntegralConstant
-        // http://boostorg.github.io/hana/index.html#tutorial-algorithms-cross_phase
-        auto default_ = hana::find_if(cases, [](auto const& c) {
-            // recall: first of the case tuple is the type
-            return hana::first(c) == hana::type_c<default_t>;  // same as c[1_c]
-        });
-        static_assert(!hana::is_nothing(default_), "hana switch_ is missing default case!");
-        // remove the default case first
-        auto rest = hana::filter(cases, [](auto const& c) {
-            return hana::first(c) != hana::type_c<default_t>;
-        });
-        // unpack(args, f) is similar to python unpacking call f(*args)
-        return hana::unpack(rest, [&](auto& ...rest) {
-            return _switch_process(arg, arg.type(), hana::second(*default_), rest...);
-        });
-    };
+void hana_print(const T& tuple) {
+    cout << hana_str(tuple) << endl;
 }
 
 
@@ -108,8 +56,8 @@ int main() {
         'x', 1000, -3.1415f, 23.09, vector<int>{4, 22, -1, 0, 1}, Fish{"tako"}, Dog{"snoopy"}
     };
 
-    for (auto& a : anys) {
-        string r = switch_(a)(
+    auto describe = [](auto& a) {
+        return switch_(a)(
             case_<int>([](auto i) { return "int: "s + std::to_string(i); }),
             case_<char>([](auto c) { return "char: "s + string{c}; }),
             case_<float>([](auto f) { return "float: "s + std::to_string(f); }),
@@ -117,7 +65,51 @@ int main() {
             case_<Fish>([](const auto& x) { return "my fish: "s + any_str(x); }),
             default_([] { return "unknown type"s; })
         );
+    };
+
+    for (auto& a : anys) {
+        string r = describe(a);
         cout << r << endl;
     }
-}
 
+    // the same dispatch split over threads: producer -> 2 x switch_ -> batched output, in input order
+    ptitle("pipeline");
+    auto stats = run_pipeline<boost::any, string>(
+        [&](auto&& emit) { for (auto& a : anys) emit(a); },
+        describe,
+        [](const vector<string>& batch) { for (auto& r : batch) cout << r << '\n'; },
+        {2, 16, 4}
+    );
+    cout << stats.items << " items through " << stats.stages.size() << " stages" << endl;
+
+    // the same values stored inline, each case checked with one pointer compare
+    ptitle("small_any");
+    vector<small_any> smalls {'x', 1000, -3.1415f, 23.09, vector<int>{4, 22, -1, 0, 1}, Fish{"tako"}, Dog{"snoopy"}};
+    for (auto& a : smalls) {
+        cout << describe(a) << endl;
+    }
+
+    // switching on values: the case set becomes a jump table, a binary search or a perfect hash
+    ptitle("value_switch");
+    using namespace value_switch_literals;
+    for (int code : {200, 204, 404, 418, 500}) {
+        string r = value_switch(code)(
+            case_v<200>([] { return "ok"s; }),
+            case_v<204>([] { return "no content"s; }),
+            case_v<404>([](int c) { return "not found ("s + std::to_string(c) + ")"; }),
+            case_v<500>([] { return "server error"s; }),
+            default_([] { return "unknown status"s; })
+        );
+        cout << code << ": " << r << endl;
+    }
+    for (string method : {"GET", "POST", "DELETE", "BREW"}) {
+        string r = value_switch(method)(
+            case_s("GET"_s)([] { return "read"s; }),
+            case_s("POST"_s)([] { return "create"s; }),
+            case_s("PUT"_s)([] { return "replace"s; }),
+            case_s("DELETE"_s)([] { return "remove"s; }),
+            default_([](const string& m) { return "no method " + m; })
+        );
+        cout << method << ": " << r << endl;
+    }
+}
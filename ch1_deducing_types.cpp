@@ -8,6 +8,8 @@
 #include <iostream>
 #include <vector>
 #include <boost/type_index.hpp>
+#include "logger.h"
+#include "mdview.h"
 
 using namespace std;
 
@@ -25,21 +27,16 @@ void ptype(const T& param) { // universal reference
 }
 
 
-/*
- * very cool hack to get array size at compile time
- */
-template<typename T, int N>
-constexpr int array_size(const T (&)[N]) noexcept {
-    return N;
-};
+// array_size, the very cool hack to get array size at compile time, lives in mdview.h
 
 /*
  * practice decltype
  * Container&& is universal reference
+ * prints on every call, so keep it out of hot loops: see view in mdview.h
  */
 template<typename Container, typename Index>
 decltype(auto) access_element(Container&& c, Index i) {
-    cout << "accessing element " << i << endl;
+    LOG_INFO("accessing element ", i);
     return forward<Container>(c)[i];  // perfect forwarding
 };
 
@@ -65,6 +62,21 @@ int main() {
     access_element(vec, 2) = 1000;
     cout << vec[1] << ", " << vec[2] << endl;
 
+    // the multidimensional, zero-overhead version of access_element
+    int grid[3][4] = {{0, 1, 2, 3}, {10, 11, 12, 13}, {20, 21, 22, 23}};
+    auto grid_view = make_view(grid);  // extents<3, 4> deduced from the array type
+    grid_view(2, 1) = -21;
+    cout << "grid " << grid_view.extent(0) << "x" << grid_view.extent(1)
+         << ", grid[2][1] = " << grid[2][1] << endl;
+    auto col_major = make_matrix_view<layout_left>(&grid[0][0], 4, 3);  // same memory, transposed
+    cout << "transposed (1, 2) = " << col_major(1, 2) << endl;
+    try {
+        grid_view.with_policy<throw_checked>()(3, 0);
+    }
+    catch (const std::out_of_range& e) {
+        cout << "caught: " << e.what() << endl;
+    }
+
     return 0;
 }
 #pragma clang diagnostic pop
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include <unordered_map>
 #include <boost/type_index.hpp>
 #include "utils.h"
+#include "flat_hash_map.h"
+#include "bit_vector.h"
 
 using namespace std;
 
@@ -53,11 +55,30 @@ int main() {
         cout << key << "->" << value << endl;
     }
 
+    cout << "flat_hash_map: try_emplace builds Dummy in place, no copy ctor" << endl;
+    flat_hash_map<string, Dummy> flat;
+    flat.try_emplace("a", 10);
+    flat.try_emplace("b", 20);
+    flat.try_emplace("c", 30);
+    // the element type is kv_pair, not std::pair: the "wrong" loop above won't even compile
+//    for (const pair<string, Dummy>& p: flat) {}
+    for (const auto& [key, value]: flat) {
+        cout << key << "->" << value << endl;
+    }
+    // lookup with a string_view or const char*, no temporary std::string
+    cout << "b->" << flat.at("b"sv) << endl;
+
     // vector<bool> is a specialization of vector, has special behavior
     vector<bool> mybools {true, true, false, false, true};
     auto wrong_bool = mybools[3]; // proxy object
     auto right_bool = static_cast<bool>(mybools[3]);
     ptype(right_bool);
+    // bit_vector has no proxy: test() is a plain bool and writes are explicit
+    bit_vector bits {true, true, false, false, true};
+    auto also_right_bool = bits.test(3);
+    ptype(also_right_bool);
+    bits.set(3);
+    cout << "count= " << bits.count() << ", first clear bit after 0: " << (~bits).find_first() << endl;
 
     return 0;
 }
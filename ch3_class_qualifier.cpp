@@ -6,45 +6,11 @@
 #include <vector>
 #include <unordered_map>
 #include "utils.h"
+#include "widget.h"
 
 using namespace std;
 
 
-class Widget {
-public:
-    using DataType = vector<double>;
-
-    // lvalue reference qualifier
-    virtual DataType& get() & {
-        cout << "lvalue function" << endl;
-        return values;
-    }
-    // rvalue reference qualifier
-    virtual DataType get() const && {
-        cout << "rvalue function" << endl;
-        return std::move(values);
-    }
-
-protected:
-    DataType values;
-};
-
-
-class SubWidget : public Widget {
-public:
-    // lvalue reference qualifier
-    DataType& get() & override {
-        cout << "sub lvalue function" << endl;
-        return values;
-    }
-    // rvalue reference qualifier
-    DataType get() const && override {  // const qualifier must match superclass
-        cout << "sub rvalue function" << endl;
-        return std::move(values);
-    }
-};
-
-
 int main() {
     auto w = Widget();
     w.get();
@@ -54,5 +20,26 @@ int main() {
     ws.get();
     SubWidget().get();
 
+    const SubWidget const_ws;
+    std::move(const_ws).get();  // const&&: nothing to steal from, copies
+
+    // copy-on-write: copies and snapshots share the buffer until a write
+    Widget big(Widget::DataType(1'000'000, 1.0));
+    Widget big_copy = big;
+    auto snap = big.snapshot();
+    cout << "shared by " << snap.use_count() << " handles, deep copies so far: "
+         << cow<Widget::DataType>::deep_copies << endl;
+    big_copy.get()[0] = 42;  // detaches big_copy only
+    cout << "after write: big[0]= " << big.view()[0] << ", big_copy[0]= " << big_copy.view()[0]
+         << ", deep copies: " << cow<Widget::DataType>::deep_copies << endl;
+    auto moved_out = std::move(big_copy).get();  // sole owner, moved out
+    cout << "moved out " << moved_out.size() << " values, deep copies: "
+         << cow<Widget::DataType>::deep_copies << endl;
+    auto& values = big.get();  // a live reference: big's buffer is never shared again
+    auto later = big.snapshot();
+    values[0] = 7;
+    cout << "snapshot after get(): " << later.read()[0] << ", big[0]= " << big.view()[0]
+         << ", deep copies: " << cow<Widget::DataType>::deep_copies << endl;
+
     return 0;
 }
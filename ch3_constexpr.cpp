@@ -6,50 +6,19 @@
 #include <vector>
 #include <unordered_map>
 #include "utils.h"
+#include "constexpr_math.h"
+#include "point.h"
+#include "fixed_string.h"
 
 using namespace std;
 
 
+// exponentiation by squaring, see constexpr_math.h for checked_pow and lookup tables
 constexpr int pow(int base, int exp) noexcept {
-    int result = 1;
-    for (int i = 0; i<exp; ++i) {
-        result *= exp;
-    }
-    return result;
-}
-
-
-class Point {
-public:
-    constexpr Point(double x = 0, double y = 0) noexcept
-    : x(x), y(y)
-    {}
-
-    constexpr double getX() const noexcept { return x; }
-    constexpr double getY() const noexcept { return y; }
-    constexpr void setX(double newx) { x = newx; }
-    constexpr void setY(double newy) { y = newy; }
-
-private:
-    double x, y;
-};
-
-
-constexpr Point midpoint(const Point& p1, const Point& p2) noexcept {
-    return {
-        (p1.getX() + p2.getX()) / 2,
-        (p1.getY() + p2.getY()) / 2
-    };
+    return ipow(base, static_cast<unsigned>(exp));
 }
 
 
-constexpr Point reflect(const Point& p) {
-    Point ans;
-    ans.setX(-p.getX());
-    ans.setY(-p.getY());
-    return ans;
-}
-
 /**
  * COOL: use if constexpr to avoid SFINAE or clever meta-template hacks
  */
@@ -67,27 +36,26 @@ auto variadic_get(T x, Ts ... xs) {
 }
 
 
-// we print a compile-time double number up to two decimal points
-template<int int_part, int decimal_part>
-constexpr void _compile_print() {
-    
-    cout << int_part << "." << decimal_part << endl;
-}
-
-constexpr int _get_decimal(double x) {
-    if (x < 0) {
-        x *= -1;
-    }
-    int int_part = static_cast<int>(x);
-    return static_cast<int>((x - int_part)*100);
-}
-
-
-#define compile_print(x) _compile_print<static_cast<int>(x), _get_decimal(x)>()
+/*
+ * we print a compile-time double number up to two decimal points
+ * the text itself (newline included) is rendered by the compiler, see fixed_string.h
+ */
+#define compile_print(x) do { \
+        constexpr auto _compiled_str = format_fixed<2>(x) + "\n"; \
+        cout << _compiled_str; \
+    } while (0)
 
 
 int main() {
     cout << "7**5 = " << pow(7, 5) << endl;
+    static_assert(pow(7, 5) == 16807);
+    static_assert(!checked_pow(7, 12));  // 7**12 overflows int
+
+    // the whole table is computed by the compiler
+    constexpr auto pow3 = pow_table<int, 3>();
+    cout << "3**k fits in int for k <= " << pow3.size() - 1 << ", 3**19 = " << pow3[19] << endl;
+    constexpr auto sin_q15 = sin_q15_table<256>();
+    cout << "sin(pi/2) in Q15 = " << sin_q15[64] << endl;
 
     constexpr Point p1(9.42, -21.3);
     constexpr Point p2(-6.5, 11.78);
@@ -98,6 +66,13 @@ int main() {
     compile_print(pmid.getY());
     compile_print(pref.getX());
     compile_print(pref.getY());
+    compile_print(-0.25);  // sign survives a zero integer part
+
+    constexpr auto label = "midpoint = (" + format_fixed<3>(pmid.getX()) + ", "
+                           + format_fixed<3>(pmid.getY()) + ")\n";
+    static_assert(format_int(-9000000000LL) == "-9000000000"sv);
+    static_assert(label == "midpoint = (1.460, -4.760)\n"sv);
+    cout << label;
 
     cout << "Variadic hacking with if constexpr" << endl;
     ptype(variadic_get<0>(nullptr, "const char", 35, "my string"s, 4.556));
@@ -3,6 +3,8 @@
  * item 10 enum
  */
 #include "utils.h"
+#include "columnar_table.h"
+#include "enum_reflect.h"
 
 
 /* Use unscoped enum to index tuples */
@@ -23,5 +25,41 @@ int main() {
     UserInfo myinfo {"DrFord", "yoyo@gmail.com", 777};
     cout << std::get<uiEmail>(myinfo) << endl;
     cout << std::get<getEtype(uiScore)>(myinfo) << endl;
+
+    /* the same enum indexes a columnar table: one contiguous vector per field */
+    Table<UserInfoFields, string, string, int> users;
+    users.push_back(myinfo);
+    users.emplace_back("Dolores", "dolores@sweetwater.com", 912);
+    users.emplace_back("Teddy", "teddy@sweetwater.com", 404);
+    cout << get<uiEmail>(users[1]) << endl;  // tuple-style access to a row
+    auto [name, email, score] = users[2];
+    cout << name << " " << email << " " << score << endl;
+    UserInfo copied = users[0];  // back to the tuple
+    cout << std::get<uiName>(copied) << endl;
+
+    auto high = users.where<uiScore>([](int s) { return s > 500; });
+    cout << "high scorers: " << high.count() << ", their total: " << users.sum<uiScore>(high)
+         << ", best: " << users.get<uiName>(users.top_k<uiScore>(1)[0]) << endl;
+
+    // scoped enums work as column names too, rows still need getEtype
+    Table<CUserInfoFields, string, string, int> cusers;
+    cusers.push_back(myinfo);
+    cout << cusers.column<CUserInfoFields::uiScore>()[0] << " "
+         << get<getEtype(CUserInfoFields::uiEmail)>(cusers[0]) << endl;
+
+    /* the enumerators' names, read back at compile time */
+    for (auto f : enum_traits<CUserInfoFields>::values) {
+        cout << getEtype(f) << ":" << enum_to_string(f) << " ";
+    }
+    cout << endl;
+    if (auto f = enum_from_string<UserInfoFields>("uiEmail")) {
+        cout << "uiEmail is field " << *f << endl;
+    }
+    cout << "uiPhone is " << (enum_from_string<UserInfoFields>("uiPhone") ? "a field" : "no field") << endl;
+    enum_array<CUserInfoFields, size_t> widths {};
+    for (auto f : widths.keys()) {
+        widths[f] = cusers.column<CUserInfoFields::uiName>()[0].size() + enum_to_string(f).size();
+    }
+    cout << "widths: " << widths[CUserInfoFields::uiName] << " " << widths[CUserInfoFields::uiScore] << endl;
     return 0;
 }
@@ -8,6 +8,7 @@
 #include <boost/type_index.hpp>
 #include <type_traits>
 #include "utils.h"
+#include "small_vector.h"
 
 
 class Dummy {
@@ -22,6 +23,19 @@ ostream& operator<<(ostream& oss, const Dummy& dummy) {
     return oss << " Dummy" << dummy.vec;
 }
 
+// same as Dummy, but the ints live inline instead of on the heap
+class SmallDummy {
+public:
+    small_vector<int, 4> vec;
+    SmallDummy() : vec({1, 2, 3}) {}
+    SmallDummy(initializer_list<int> init) : vec(init) {}
+    SmallDummy(const SmallDummy& other) = delete;
+};
+
+ostream& operator<<(ostream& oss, const SmallDummy& dummy) {
+    return oss << " SmallDummy" << dummy.vec;
+}
+
 template<typename T, typename... Ts>
 T make_object_with_brace(Ts&& ... params) {
     T new_obj{forward<Ts>(params) ...};
@@ -88,10 +102,18 @@ int main() {
     Dummy dum3({});
     cout << "empty initializer_list" << dum3 << endl;
 
+    // small_vector follows the same {} vs () rules
+    SmallDummy sdum{};
+    SmallDummy sdum2{{}};
+    SmallDummy sdum3({});
+    cout << sdum << sdum2 << sdum3 << endl;
+
     cout << make_object_with_brace<vector<int>>(5, -7) << endl;
     cout << make_object_with_brace<vector<int>>() << endl;
     cout << make_object_with_paren<vector<int>>(5, -7) << endl;
     cout << make_object_with_paren<vector<int>>() << endl;
+    cout << make_object_with_brace<small_vector<int, 4>>(5, -7) << endl;
+    cout << make_object_with_paren<small_vector<int, 8>>(5, -7) << endl;
     ptype(nullptr);
 
     MyType<int> vec{1, 2, 3};
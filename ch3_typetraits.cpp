@@ -6,6 +6,7 @@
 #include <vector>
 #include <unordered_map>
 #include "utils.h"
+#include "relocating_vector.h"
 
 using namespace std;
 
@@ -24,6 +25,29 @@ int main() {
     ptype<add_lvalue_reference_t<unsigned int>>();  // C++14
     ptype<add_rvalue_reference_t<int*>>();  // C++14
 
+    /* traits picking a faster code path: relocate by memcpy when it is safe */
+    struct Boxed {
+        unique_ptr<string> name;
+        using trivially_relocatable = bool_constant<all_trivially_relocatable_v<unique_ptr<string>>>;
+    };
+    cout << boolalpha
+         << "int " << is_trivially_relocatable_v<int> << ", "
+         << "unique_ptr<string> " << is_trivially_relocatable_v<unique_ptr<string>> << ", "
+         << "Boxed " << is_trivially_relocatable_v<Boxed> << ", "
+         << "string " << is_trivially_relocatable_v<string> << ", "  // SSO points into itself
+         << "Marker " << is_trivially_relocatable_v<Marker> << endl;
+
+    relocating_vector<unique_ptr<int>> ptrs;
+    for (int i = 0; i < 5; ++i) {
+        ptrs.push_back(make_unique<int>(i));  // grows by memcpy
+    }
+    ptrs.insert(ptrs.begin() + 2, make_unique<int>(42));  // memmove of the tail
+    ptrs.erase(ptrs.begin());
+    relocating_vector<int> values;
+    for (auto& p : ptrs) {
+        values.push_back(*p);
+    }
+    cout << values << endl;
 
     return 0;
 }
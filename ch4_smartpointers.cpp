@@ -3,20 +3,31 @@
  * item 18 unique_ptr
  */
 #include "utils.h"
+#include "fixed_string.h"
+#include "interned_marker.h"
+#include "struct_layout.h"
+#include "rcu.h"
 
 using namespace std;
 
 
-class Apple : public Marker {
+/*
+ * the fruit name prefixes are fixed_strings, so `prefix + x` builds the Marker
+ * name with a single allocation instead of a "apple"s temporary that then regrows
+ */
+class Apple final : public Marker {
 public:
+    static constexpr fixed_string prefix = "apple";
+
     Apple(int id, string x, string suffix1, int suffix2)
-    : Marker("apple"s + x), id(id), suffix1(suffix1), suffix2(suffix2)
+    : Marker(prefix + x), id(id), suffix1(suffix1), suffix2(suffix2)
     {}
 
     string get() const override {
         return Marker::get() + "-"s + std::to_string(id) + suffix1 + std::to_string(suffix2);
     }
 private:
+    friend struct boost::hana::accessors_impl<Apple>;  // for the layout report below
     int id;
     string suffix1;
     int suffix2;
@@ -24,31 +35,41 @@ private:
 
 class Banana : public Marker {
 public:
+    static constexpr fixed_string prefix = "banana";
+
     Banana(double id, string x, double suffix1)
-        : Marker("banana"s + x), id(id), suffix1(suffix1)
+        : Marker(prefix + x), id(id), suffix1(suffix1)
     {}
     string get() const override {
         return Marker::get() + "-"s + std::to_string(id) + std::to_string(suffix1);
     }
 private:
+    friend struct boost::hana::accessors_impl<Banana>;
     double id;
     double suffix1;
 };
 
-class Cherry : public Marker {
+class Cherry final : public Marker {
 public:
+    static constexpr fixed_string prefix = "cherry";
+
     Cherry(string id, string x)
-        : Marker("cherry"s + x), id(id)
+        : Marker(prefix + x), id(id)
     {}
     string get() const override {
         return Marker::get() + "-"s + id;
     }
 private:
+    friend struct boost::hana::accessors_impl<Cherry>;
     string id;
 };
 
+BOOST_HANA_ADAPT_STRUCT(Apple, id, suffix1, suffix2);
+BOOST_HANA_ADAPT_STRUCT(Banana, id, suffix1);
+BOOST_HANA_ADAPT_STRUCT(Cherry, id);
+
 auto custom_del = [](Marker* mp) {
-    cout << "smart pointer custom deleter called" << endl;
+    LOG_INFO("smart pointer custom deleter called");
     delete mp;
 };
 
@@ -95,5 +116,44 @@ int main() {
     // shared_ptr custom deleter is not part of the type
     shared_ptr<Marker> banana_ptr2 {new Banana(1.2, "b2", -0.5), custom_del};
 
+    // every fruit carries one of three long names: store them once, keep 4-byte ids
+    {
+        Marker::print_enabled = false;
+        constexpr size_t N = 30000;
+        const string names[] = {"apple_from_the_orchard", "banana_from_the_orchard", "cherry_from_the_orchard"};
+        vector<Marker> plain;
+        vector<InternedMarker> interned;
+        plain.reserve(N);
+        interned.reserve(N);
+        size_t plain_heap = 0;
+        for (size_t i = 0; i < N; ++i) {
+            plain.emplace_back(names[i % 3]);
+            interned.emplace_back(names[i % 3]);
+            plain_heap += names[i % 3].size() + 1;  // past the SSO limit, one allocation each
+        }
+        cout << N << " Markers: " << N * sizeof(Marker) + plain_heap << " bytes, "
+             << N << " InternedMarkers: " << N * sizeof(InternedMarker) << " bytes + "
+             << default_intern_pool().memory().text_bytes << " bytes of pooled text" << endl;
+        cout << "same fruit: " << (interned[0] == interned[3]) << ", " << interned[4].get() << endl;
+    }
+    Marker::print_enabled = true;
+
+    // where the fruit bytes go: the Marker base, then the members with their holes
+    cout << layout_of<Apple>() << endl;
+    cout << layout_of<Banana>() << endl;
+    cout << layout_of<Cherry>() << endl;
+    packed<Apple> apple_data(Apple(7, "a3", "-x", 9));
+    cout << "packed<Apple>: " << sizeof(apple_data) << " bytes, id " << apple_data[BOOST_HANA_STRING("id")]
+         << " at offset " << packed<Apple>::offset_of<0>() << ", suffix1 " << apple_data.get<1>() << endl;
+
+    // a "current" fruit that readers grab without touching a shared refcount
+    {
+        rcu_cell<Marker> current(make_unique<Cherry>("rcu", "-old"));
+        auto reader = current.read();
+        current.store(make_unique<Apple>(1, "-new", "r", 2));
+        cout << "old reader sees " << reader->get() << ", new readers see " << current.read()->get()
+             << ", retired: " << rcu_domain::instance().pending() << endl;
+    }  // the reader leaves first, then the cell reclaims both fruits
+
     return 0;
 }
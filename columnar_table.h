@@ -0,0 +1,372 @@
+#ifndef EFFECTIVECPP_COLUMNAR_TABLE_H
+#define EFFECTIVECPP_COLUMNAR_TABLE_H
+
+/*
+ * Table<Enum, Cols...>: column-oriented storage for records that item 10 models as
+ * tuple<Cols...> indexed by an enum, e.g.
+ *     Table<UserInfoFields, string, string, int> users;
+ *     users.push_back(UserInfo{"DrFord", "yoyo@gmail.com", 777});
+ *     users.column<uiScore>();          // contiguous ints
+ *     get<uiEmail>(users[0]);           // same spelling as std::get on the tuple
+ *
+ * Each column is its own 64-byte aligned vector, so a scan over scores touches
+ * only scores. String columns are one packed char arena plus end offsets, no
+ * per-row heap allocation, and are read back as string_view.
+ *
+ * The numeric scans are plain loops the compiler vectorizes: sum() keeps independent
+ * lanes, where() compares into bytes and packs them with movemask. where() returns a
+ * bit_vector mask, so filters combine with the bulk &, |, and_not of bit_vector.h,
+ * and sum(mask) skips empty mask words.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "aligned_allocator.h"
+#include "bit_vector.h"
+
+
+// all strings of a column back to back in one buffer, row i is chars[ends[i-1], ends[i])
+class string_column {
+public:
+    void push_back(std::string_view s) {
+        chars.append(s);
+        ends.push_back(chars.size());
+    }
+
+    std::string_view operator[](std::size_t i) const noexcept {
+        std::size_t begin = i ? ends[i - 1] : 0;
+        return {chars.data() + begin, ends[i] - begin};
+    }
+
+    std::size_t size() const noexcept { return ends.size(); }
+    void reserve(std::size_t rows, std::size_t bytes = 0) {
+        ends.reserve(rows);
+        chars.reserve(bytes);
+    }
+    void clear() noexcept {
+        chars.clear();
+        ends.clear();
+    }
+
+    // heap bytes in use, for comparing against vector<string>
+    std::size_t memory_bytes() const noexcept {
+        return chars.capacity() + ends.capacity() * sizeof(std::size_t);
+    }
+
+private:
+    std::string chars;
+    std::vector<std::size_t> ends;
+};
+
+
+template<typename TableT>
+class table_row;
+
+
+template<typename Enum, typename... Cols>
+class Table {
+    static_assert(std::is_enum_v<Enum>, "columns are addressed by an enum");
+    static_assert(sizeof...(Cols) > 0, "a table needs at least one column");
+
+    template<typename T>
+    using storage_t = std::conditional_t<std::is_same_v<T, std::string>,
+                                         string_column,
+                                         std::vector<T, aligned_allocator<T, 64>>>;
+
+    static constexpr std::size_t idx(Enum e) noexcept { return static_cast<std::size_t>(e); }
+
+public:
+    using enum_type = Enum;
+    using row_type = std::tuple<Cols...>;
+    using row_ref = table_row<Table>;
+    static constexpr std::size_t num_columns = sizeof...(Cols);
+
+    template<Enum E>
+    using value_type_of = std::tuple_element_t<idx(E), row_type>;
+
+    /***************** rows *****************/
+    std::size_t size() const noexcept { return nrows; }
+    bool empty() const noexcept { return nrows == 0; }
+
+    void reserve(std::size_t n) {
+        std::apply([n](auto&... cols) { (cols.reserve(n), ...); }, columns);
+    }
+
+    void clear() noexcept {
+        std::apply([](auto&... cols) { (cols.clear(), ...); }, columns);
+        nrows = 0;
+    }
+
+    void push_back(const row_type& row) {
+        push_row(row, std::index_sequence_for<Cols...>{});
+    }
+
+    // one argument per column, strings can be anything convertible to string_view
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        static_assert(sizeof...(Args) == num_columns, "one value per column");
+        push_row(std::forward_as_tuple(std::forward<Args>(args)...), std::index_sequence_for<Cols...>{});
+    }
+
+    // tuple-like view of row i, see get<I>(table_row) below
+    row_ref operator[](std::size_t i) const noexcept { return row_ref(*this, i); }
+
+    // copy row i back into the tuple the rest of the code uses
+    row_type row(std::size_t i) const {
+        return row_at(i, std::index_sequence_for<Cols...>{});
+    }
+
+    /***************** columns *****************/
+    template<Enum E>
+    const auto& column() const noexcept { return std::get<idx(E)>(columns); }
+
+    template<std::size_t I>
+    const auto& column_at() const noexcept { return std::get<I>(columns); }
+
+    // const T& for numeric columns, string_view for string columns
+    template<Enum E>
+    decltype(auto) get(std::size_t i) const noexcept { return column<E>()[i]; }
+
+    /***************** vectorized scans over numeric columns *****************/
+    // bit i is set iff pred(column<E>()[i])
+    template<Enum E, typename Pred>
+    bit_vector where(Pred pred) const {
+        const auto* col = numeric_column<E>().data();
+        bit_vector mask(nrows);
+        bit_vector::word_type* words = mask.data();
+        constexpr std::size_t W = bit_vector::WORD_BITS;
+        std::size_t full = nrows / W;
+        for (std::size_t wi = 0; wi < full; ++wi) {
+            // compare into bytes first, that loop vectorizes; then pack 64 bytes into a word
+            const auto* chunk = col + wi * W;
+            alignas(16) std::uint8_t flags[W];
+            for (std::size_t j = 0; j < W; ++j) {
+                flags[j] = pred(chunk[j]) ? 0xFF : 0;
+            }
+            words[wi] = pack_flags(flags);
+        }
+        for (std::size_t i = full * W; i < nrows; ++i) {
+            words[full] |= bit_vector::word_type{static_cast<bool>(pred(col[i]))} << (i % W);
+        }
+        return mask;
+    }
+
+    // sum in int64 / uint64 / double so an int column can't overflow
+    template<Enum E>
+    auto sum() const noexcept {
+        const auto& col = numeric_column<E>();
+        return lane_reduce<E>([&](auto& lanes, std::size_t i) { lanes += col[i]; });
+    }
+
+    // sum over the rows selected by a where() mask
+    template<Enum E>
+    auto sum(const bit_vector& mask) const noexcept {
+        const auto* col = numeric_column<E>().data();
+        using T = value_type_of<E>;
+        constexpr std::size_t W = bit_vector::WORD_BITS;
+        acc_t<T> total {};
+        for (std::size_t wi = 0; wi < mask.num_words(); ++wi) {
+            bit_vector::word_type w = mask.word(wi);
+            if (w == 0) {  // selective filters leave most words empty
+                continue;
+            }
+            const auto* chunk = col + wi * W;
+            if (w == ~bit_vector::word_type{0}) {
+                for (std::size_t j = 0; j < W; ++j) {
+                    total += chunk[j];
+                }
+            }
+            else {
+                // the tail word has its unused bits clear, so this never reads past nrows
+                for (; w; w &= w - 1) {
+                    total += chunk[ctz64(w)];
+                }
+            }
+        }
+        return total;
+    }
+
+    template<Enum E>
+    value_type_of<E> min() const noexcept {
+        return extreme<E>([](auto a, auto b) { return b < a ? b : a; });
+    }
+
+    template<Enum E>
+    value_type_of<E> max() const noexcept {
+        return extreme<E>([](auto a, auto b) { return a < b ? b : a; });
+    }
+
+    // rows holding the k largest values of column E, largest first, ties by lower row
+    template<Enum E>
+    std::vector<std::size_t> top_k(std::size_t k) const {
+        const auto& col = numeric_column<E>();
+        using entry = std::pair<value_type_of<E>, std::size_t>;
+        // min-heap on value, so the top is the smallest we keep; later rows lose ties
+        auto worse = [](const entry& a, const entry& b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        };
+        std::priority_queue<entry, std::vector<entry>, decltype(worse)> heap(worse);
+        k = std::min(k, nrows);
+        if (k == 0) {
+            return {};
+        }
+        for (std::size_t i = 0; i < nrows; ++i) {
+            if (heap.size() < k) {
+                heap.emplace(col[i], i);
+            }
+            else if (heap.top().first < col[i]) {  // rarely true once the heap is warm
+                heap.pop();
+                heap.emplace(col[i], i);
+            }
+        }
+        std::vector<std::size_t> rows(heap.size());
+        for (auto it = rows.rbegin(); it != rows.rend(); ++it) {
+            *it = heap.top().second;
+            heap.pop();
+        }
+        return rows;
+    }
+
+    // heap bytes used by all columns
+    std::size_t memory_bytes() const noexcept {
+        return std::apply([](const auto&... cols) { return (column_bytes(cols) + ...); }, columns);
+    }
+
+private:
+    template<typename Row, std::size_t... Is>
+    void push_row(Row&& row, std::index_sequence<Is...>) {
+        (std::get<Is>(columns).push_back(std::get<Is>(std::forward<Row>(row))), ...);
+        ++nrows;
+    }
+
+    template<std::size_t... Is>
+    row_type row_at(std::size_t i, std::index_sequence<Is...>) const {
+        return row_type(std::tuple_element_t<Is, row_type>(std::get<Is>(columns)[i])...);
+    }
+
+    template<Enum E>
+    const auto& numeric_column() const noexcept {
+        static_assert(std::is_arithmetic_v<value_type_of<E>>, "scans need a numeric column");
+        return column<E>();
+    }
+
+    // bit j of the result is the top bit of flags[j]
+    static bit_vector::word_type pack_flags(const std::uint8_t* flags) noexcept {
+        bit_vector::word_type w = 0;
+#ifdef __SSE2__
+        for (std::size_t j = 0; j < bit_vector::WORD_BITS; j += 16) {
+            __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(flags + j));
+            w |= bit_vector::word_type(static_cast<std::uint16_t>(_mm_movemask_epi8(v))) << j;
+        }
+#else
+        for (std::size_t j = 0; j < bit_vector::WORD_BITS; ++j) {
+            w |= bit_vector::word_type{flags[j] >> 7} << j;
+        }
+#endif
+        return w;
+    }
+
+    template<typename T>
+    using acc_t = std::conditional_t<std::is_floating_point_v<T>, double,
+                  std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+    /*
+     * LANES independent accumulators: the adds within one step don't depend on each
+     * other, so the compiler can keep them in one vector register even for doubles,
+     * where it may not reorder a single running sum.
+     */
+    template<Enum E, typename Step>
+    auto lane_reduce(Step step) const noexcept {
+        using acc = acc_t<value_type_of<E>>;
+        constexpr std::size_t LANES = 8;
+        acc lanes[LANES] {};
+        std::size_t i = 0;
+        for (; i + LANES <= nrows; i += LANES) {
+            for (std::size_t l = 0; l < LANES; ++l) {
+                step(lanes[l], i + l);
+            }
+        }
+        for (; i < nrows; ++i) {
+            step(lanes[0], i);
+        }
+        acc total {};
+        for (acc lane : lanes) {
+            total += lane;
+        }
+        return total;
+    }
+
+    template<Enum E, typename Pick>
+    value_type_of<E> extreme(Pick pick) const noexcept {
+        const auto& col = numeric_column<E>();
+        if (nrows == 0) {
+            return {};
+        }
+        value_type_of<E> best = col[0];
+        for (std::size_t i = 1; i < nrows; ++i) {
+            best = pick(best, col[i]);
+        }
+        return best;
+    }
+
+    static std::size_t column_bytes(const string_column& col) noexcept { return col.memory_bytes(); }
+    template<typename V>
+    static std::size_t column_bytes(const V& col) noexcept {
+        return col.capacity() * sizeof(typename V::value_type);
+    }
+
+    std::tuple<storage_t<Cols>...> columns;
+    std::size_t nrows = 0;
+};
+
+
+/*
+ * Row i of a Table, tuple-like: get<uiEmail>(row), structured bindings, and an
+ * implicit conversion to the row tuple. Holds a pointer, so it must not outlive the table.
+ */
+template<typename TableT>
+class table_row {
+public:
+    table_row(const TableT& table, std::size_t i) noexcept
+    : table(&table), i(i)
+    {}
+
+    template<std::size_t I>
+    decltype(auto) get() const noexcept { return table->template column_at<I>()[i]; }
+
+    operator typename TableT::row_type() const { return table->row(i); }
+
+    std::size_t index() const noexcept { return i; }
+
+private:
+    const TableT* table;
+    std::size_t i;
+};
+
+// an unscoped enumerator converts to the index, scoped ones go through getEtype as with std::get
+template<std::size_t I, typename TableT>
+decltype(auto) get(const table_row<TableT>& row) noexcept {
+    return row.template get<I>();
+}
+
+
+namespace std {
+template<typename TableT>
+struct tuple_size<table_row<TableT>> : integral_constant<size_t, TableT::num_columns> {};
+
+template<size_t I, typename TableT>
+struct tuple_element<I, table_row<TableT>> {
+    using type = decltype(declval<const table_row<TableT>&>().template get<I>());
+};
+}
+
+
+#endif //EFFECTIVECPP_COLUMNAR_TABLE_H
@@ -0,0 +1,197 @@
+#ifndef EFFECTIVECPP_CONSTEXPR_MATH_H
+#define EFFECTIVECPP_CONSTEXPR_MATH_H
+
+/*
+ * Compile-time math helpers (item 15: use constexpr whenever possible)
+ * - ipow / checked_pow: exponentiation by squaring, O(log exp)
+ * - make_lut<N>(f): build a std::array lookup table at compile time
+ * - csin / ccos: constexpr Taylor-series trig, so trig tables can be constexpr too
+ */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+
+/*
+ * Exponentiation by squaring. Overflow wraps around (two's complement) instead of
+ * being undefined, so this is safe to call at runtime with anything.
+ * Use checked_pow when you need to know.
+ */
+template<typename T>
+constexpr T ipow(T base, unsigned exp) noexcept {
+    static_assert(std::is_integral_v<T>, "ipow only works on integers");
+    // do the arithmetic unsigned: signed overflow is UB and a compile error in constexpr.
+    // At least unsigned int wide, or 8- and 16-bit types would be promoted to int;
+    // wrapping mod 2^32 and truncating gives the same bits as wrapping in T
+    using U = std::common_type_t<std::make_unsigned_t<T>, unsigned>;
+    U b = static_cast<U>(base);
+    U result = 1;
+    while (exp) {
+        result *= (exp & 1u) ? b : U{1};  // select instead of branch: random exps mispredict
+        exp >>= 1;
+        b *= b;
+    }
+    return static_cast<T>(result);
+}
+
+
+// true if a * b does not fit into T
+template<typename T>
+constexpr bool mul_overflows(T a, T b) noexcept {
+    static_assert(std::is_integral_v<T>, "mul_overflows only works on integers");
+    using limits = std::numeric_limits<T>;
+    if (a == 0 || b == 0) {
+        return false;
+    }
+    if constexpr (std::is_signed_v<T>) {
+        if (a > 0) {
+            return b > 0 ? a > limits::max() / b : b < limits::min() / a;
+        }
+        else {
+            // dividing by a negative b flips the comparison
+            return b > 0 ? a < limits::min() / b : a < limits::max() / b;
+        }
+    }
+    else {
+        return a > limits::max() / b;
+    }
+}
+
+
+/*
+ * Same as ipow, but returns nullopt if any intermediate product overflows.
+ * Squaring is skipped after the last bit, so base*base can't produce a false alarm.
+ */
+template<typename T>
+constexpr std::optional<T> checked_pow(T base, unsigned exp) noexcept {
+    static_assert(std::is_integral_v<T>, "checked_pow only works on integers");
+    T result = 1;
+    while (true) {
+        if (exp & 1u) {
+            if (mul_overflows(result, base)) {
+                return std::nullopt;
+            }
+            result *= base;
+        }
+        exp >>= 1;
+        if (!exp) {
+            return result;
+        }
+        if (mul_overflows(base, base)) {
+            return std::nullopt;
+        }
+        base *= base;
+    }
+}
+
+
+// largest exp such that base**exp still fits in T
+template<typename T>
+constexpr unsigned max_exponent(T base) noexcept {
+    if (base == 0 || base == 1 || (std::is_signed_v<T> && base == static_cast<T>(-1))) {
+        return std::numeric_limits<unsigned>::max();  // never overflows
+    }
+    unsigned exp = 0;
+    while (checked_pow(base, exp + 1)) {
+        ++exp;
+    }
+    return exp;
+}
+
+
+/*
+ * Build a lookup table at compile time:
+ *     constexpr auto squares = make_lut<16>([](size_t i) { return i * i; });
+ * The element type is whatever f returns. Works at runtime too, but the point
+ * is to assign it to a constexpr variable so the table lands in .rodata.
+ */
+template<std::size_t N, typename F>
+constexpr auto make_lut(F f) {
+    using T = std::decay_t<decltype(f(std::size_t{}))>;
+    std::array<T, N> table {};  // non-const std::array::operator[] is constexpr since C++17
+    for (std::size_t i = 0; i < N; ++i) {
+        table[i] = f(i);
+    }
+    return table;
+}
+
+
+/*
+ * Table of base**0 ... base**max_exponent(base), sized so that nothing overflows
+ */
+template<typename T, T Base>
+constexpr auto pow_table() {
+    static_assert(Base >= 2 || (std::is_signed_v<T> && Base <= -2), "pow_table needs |Base| >= 2");
+    constexpr std::size_t N = max_exponent(Base) + 1;
+    return make_lut<N>([](std::size_t i) { return ipow(Base, static_cast<unsigned>(i)); });
+}
+
+
+// 1.0 / i for i in [0, N), with entry 0 set to 0 so the table has no inf
+template<std::size_t N>
+constexpr auto reciprocal_table() {
+    return make_lut<N>([](std::size_t i) { return i == 0 ? 0.0 : 1.0 / static_cast<double>(i); });
+}
+
+
+/***************** constexpr trig *****************/
+constexpr double PI = 3.14159265358979323846;
+
+// std::floor is not constexpr until C++23
+constexpr double cfloor(double x) noexcept {
+    auto i = static_cast<long long>(x);
+    return (x < 0 && static_cast<double>(i) != x) ? static_cast<double>(i - 1) : static_cast<double>(i);
+}
+
+/*
+ * Reduce to [-pi/2, pi/2] and sum the Taylor series. 12 terms is plenty for
+ * double precision on that interval (the next term is below 1e-20).
+ */
+constexpr double csin(double x) noexcept {
+    x -= 2 * PI * cfloor(x / (2 * PI) + 0.5);  // now in [-pi, pi)
+    if (x > PI / 2) {
+        x = PI - x;
+    }
+    else if (x < -PI / 2) {
+        x = -PI - x;
+    }
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double ccos(double x) noexcept {
+    return csin(x + PI / 2);
+}
+
+/*
+ * Fixed-point sine table: entry i is sin(2*pi*i/N) in Q15 (scaled by 32767).
+ * N must be a power of two so a phase can be wrapped with a mask.
+ */
+template<std::size_t N>
+constexpr auto sin_q15_table() {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "sin table size must be a power of two");
+    return make_lut<N>([](std::size_t i) {
+        double s = csin(2 * PI * static_cast<double>(i) / N) * 32767.0;
+        return static_cast<std::int16_t>(s < 0 ? s - 0.5 : s + 0.5);
+    });
+}
+
+template<std::size_t N>
+constexpr auto cos_q15_table() {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "cos table size must be a power of two");
+    return make_lut<N>([](std::size_t i) {
+        double c = ccos(2 * PI * static_cast<double>(i) / N) * 32767.0;
+        return static_cast<std::int16_t>(c < 0 ? c - 0.5 : c + 0.5);
+    });
+}
+
+
+#endif //EFFECTIVECPP_CONSTEXPR_MATH_H
@@ -0,0 +1,111 @@
+#ifndef EFFECTIVECPP_COW_H
+#define EFFECTIVECPP_COW_H
+
+/*
+ * cow<T>: copy-on-write handle. Copies share one T until someone asks for write
+ * access, at which point that handle clones the T for itself (detaches).
+ *   read()  -> const T&, never copies
+ *   write() -> T&, copies only if the buffer is shared
+ *   take()  -> T by value, moved out if this is the only owner, copied otherwise
+ *
+ * The T& from write() stays valid after the call, so handing it out marks the
+ * handle unshareable, like the old copy-on-write std::string did: copies of it
+ * (and of anything holding it) clone right away instead of sharing a buffer that
+ * could still change under them. It stays that way until it is assigned.
+ *
+ * Thread safety is the same as shared_ptr: distinct handles sharing a buffer can be
+ * read and detached from different threads, one handle must not be used concurrently.
+ * use_count() is only a relaxed load, so a handle that finds itself the sole owner
+ * issues an acquire fence before touching the T in place: that pairs with the
+ * release decrement of the last other owner, so its reads happen before our writes.
+ */
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+
+template<typename T>
+class cow {
+public:
+    cow()
+    : ptr(std::make_shared<T>())
+    {}
+    explicit cow(T value)
+    : ptr(std::make_shared<T>(std::move(value)))
+    {}
+
+    cow(const cow& other)
+    : ptr(other.share())
+    {}
+    cow(cow&& other) noexcept
+    : ptr(std::move(other.ptr)), unshareable(std::exchange(other.unshareable, false))
+    {}
+    cow& operator=(const cow& other) {
+        if (this != &other) {
+            ptr = other.share();
+            unshareable = false;
+        }
+        return *this;
+    }
+    cow& operator=(cow&& other) noexcept {
+        ptr = std::move(other.ptr);
+        unshareable = std::exchange(other.unshareable, false);
+        return *this;
+    }
+
+    const T& read() const noexcept { return *ptr; }
+    const T& operator*() const noexcept { return *ptr; }
+    const T* operator->() const noexcept { return ptr.get(); }
+
+    T& write() {
+        detach();
+        unshareable = true;
+        return *ptr;
+    }
+
+    T take() && {
+        if (sole_owner()) {
+            return std::move(*ptr);
+        }
+        ++deep_copies;
+        return *ptr;
+    }
+
+    bool shared() const noexcept { return ptr.use_count() > 1; }
+    long use_count() const noexcept { return ptr.use_count(); }
+
+    // how many times any cow<T> had to clone its buffer, for tests and benchmarks
+    static inline std::atomic<std::size_t> deep_copies {0};
+
+private:
+    // what a copy of this handle points to
+    std::shared_ptr<T> share() const {
+        if (unshareable) {
+            ++deep_copies;
+            return std::make_shared<T>(*ptr);
+        }
+        return ptr;
+    }
+
+    void detach() {
+        if (!sole_owner()) {
+            ++deep_copies;
+            ptr = std::make_shared<T>(*ptr);
+        }
+    }
+
+    bool sole_owner() const noexcept {
+        if (ptr.use_count() != 1) {
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+    std::shared_ptr<T> ptr;
+    bool unshareable = false;  // a T& from write() may still be live
+};
+
+
+#endif //EFFECTIVECPP_COW_H
@@ -2,7 +2,10 @@
  * Template magic in C++14 and C++17
  */
 
+#include <numeric>
 #include "utils.h"
+#include "small_vector.h"
+#include "parallel_reduce.h"
 
 
 class Elem {
@@ -40,10 +43,11 @@ auto right_sum(Ts&& ... args) {
 
 /*
  * comma is also a unary operator that returns nothing
+ * works with vector, small_vector and static_vector alike
  */
-template<typename T, typename... Ts>
-vector<T>& multi_push(vector<T>& vec, Ts&& ... elems) {
-    (vec.push_back(elems), ...);
+template<typename VecT, typename... Ts>
+VecT& multi_push(VecT& vec, Ts&& ... elems) {
+    (vec.push_back(std::forward<Ts>(elems)), ...);
     return vec;
 }
 
@@ -82,6 +86,11 @@ int main() {
     cout << right_sum(Elem{"hello"}, Elem{"my"}, Elem{"world"}, Elem{"yo"}) << endl;
     vector<int> vec {3, 5, 6, 10, 2};
     cout << multi_push(vec, -5, 7, 18, 200) << endl;
+    // the element count is known at the call site, so keep them off the heap
+    small_vector<int, 8> small_vec {3, 5};
+    cout << multi_push(small_vec, -5, 7, 18, 200) << " inline: " << small_vec.is_inline() << endl;
+    static_vector<string, 4> names;
+    cout << multi_push(names, "hello"s, "my"s, "world"s) << endl;
 
     // template fold magic
     cout << any_str("hello ", 3.1415, " my ", -20, -1.11f) << endl;
@@ -92,5 +101,15 @@ int main() {
     auto tup3 = std::make_tuple("tup3"s, 501, -30);
     ptuple(tuple_multi_concat(tup1, tup3, tup2));
     ptuple(tuple_multi_concat(tup3, tup1, tup2, tup1, tup3));
+
+    // left_sum over a runtime range: chunks fold in parallel, then combine in order
+    thread_pool pool(2);
+    vector<Elem> words {Elem{"hello"}, Elem{"my"}, Elem{"world"}, Elem{"yo"},
+                        Elem{"how"}, Elem{"are"}, Elem{"you"}, Elem{"today"}};
+    auto concat = [](Elem a, const Elem& b) { return a + b; };
+    cout << parallel_reduce(pool, words, concat, 2) << endl;
+    vector<long> numbers(1000);
+    std::iota(numbers.begin(), numbers.end(), 1L);
+    cout << "sum 1..1000 = " << parallel_reduce(pool, numbers, std::plus<>{}) << endl;
 }
 
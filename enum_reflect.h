@@ -0,0 +1,222 @@
+#ifndef EFFECTIVECPP_ENUM_REFLECT_H
+#define EFFECTIVECPP_ENUM_REFLECT_H
+
+/*
+ * Compile-time enum reflection: the enumerators of E and their names, without
+ * listing them again.
+ *
+ *   enum_to_string(CUserInfoFields::uiEmail);          // "uiEmail"
+ *   enum_from_string<CUserInfoFields>("uiScore");      // optional, empty for unknown names
+ *   enum_traits<CUserInfoFields>::values;              // std::array of all enumerators
+ *   enum_array<CUserInfoFields, int> width {};         // one T per enumerator
+ *   width[CUserInfoFields::uiName] = 20;
+ *
+ * The names come out of __PRETTY_FUNCTION__ of a function template instantiated
+ * for every value in enum_range<E> (-128..127 by default, clipped to the
+ * underlying type): "... E V = Color::red ..." names an enumerator, "(Color)3"
+ * doesn't. Enumerators outside the range aren't seen, specialize enum_range for
+ * those; aliases (two names, one value) show up once, under the name the
+ * compiler prints.
+ *
+ * enum_to_string is one table load, enum_from_string goes through a perfect_hash
+ * of the names: one hash, one table load, one string compare.
+ * Works with GCC and Clang.
+ */
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "perfect_hash.h"
+
+
+// the values scanned for enumerators, specialize for enums outside it
+template<typename E>
+struct enum_range {
+    static constexpr long long min = -128;
+    static constexpr long long max = 127;
+};
+
+
+namespace enum_reflect_detail {
+    template<typename E, E V>
+    constexpr std::string_view pretty_name() noexcept {
+        return __PRETTY_FUNCTION__;
+    }
+
+    // the enumerator out of "[with E = ns::Color; E V = ns::Color::red; ...]" (GCC)
+    // or "[E = ns::Color, V = ns::Color::red]" (Clang), "" for "(ns::Color)3"
+    constexpr std::string_view parse_name(std::string_view pretty) noexcept {
+        std::size_t start = pretty.find(" V = ");
+        if (start == std::string_view::npos) {
+            return {};
+        }
+        start += 5;
+        std::size_t end = pretty.find_first_of(";]", start);
+        std::string_view value = pretty.substr(start, end - start);
+        if (value.empty() || value[0] == '(' || value[0] == '-' || (value[0] >= '0' && value[0] <= '9')) {
+            return {};
+        }
+        std::size_t colon = value.rfind(':');
+        return colon == std::string_view::npos ? value : value.substr(colon + 1);
+    }
+
+    template<typename E, E V>
+    constexpr std::size_t name_length = parse_name(pretty_name<E, V>()).size();
+
+    // the name copied out of __PRETTY_FUNCTION__, into storage of its own
+    template<typename E, E V>
+    struct name_of {
+        static constexpr std::size_t length = name_length<E, V>;
+        static constexpr std::array<char, length + 1> make() noexcept {
+            std::array<char, length + 1> chars {};
+            std::string_view name = parse_name(pretty_name<E, V>());
+            for (std::size_t i = 0; i < length; ++i) {
+                chars[i] = name[i];
+            }
+            return chars;
+        }
+        static constexpr std::array<char, length + 1> chars = make();
+        static constexpr std::string_view view {chars.data(), length};
+    };
+
+    template<typename E>
+    struct scan {
+        using U = std::underlying_type_t<E>;
+        static constexpr long long LO = std::max<long long>(enum_range<E>::min, std::numeric_limits<U>::min());
+        static constexpr long long HI = std::min<long long>(enum_range<E>::max,
+                                                            static_cast<long long>(std::numeric_limits<U>::max()));
+        static_assert(LO <= HI, "enum_range<E> is empty");
+        static constexpr std::size_t SPAN = static_cast<std::size_t>(HI - LO + 1);
+
+        template<std::size_t... I>
+        static constexpr std::array<std::string_view, SPAN> names(std::index_sequence<I...>) noexcept {
+            return {name_of<E, static_cast<E>(static_cast<U>(LO + static_cast<long long>(I)))>::view...};
+        }
+        // the name of every value in the range, "" for non-enumerators
+        static constexpr auto all = names(std::make_index_sequence<SPAN>{});
+
+        static constexpr std::size_t count() noexcept {
+            std::size_t n = 0;
+            for (auto name : all) {
+                n += !name.empty();
+            }
+            return n;
+        }
+    };
+}
+
+
+template<typename E>
+struct enum_traits {
+    static_assert(std::is_enum_v<E>, "enum_traits needs an enum");
+
+private:
+    using scan = enum_reflect_detail::scan<E>;
+    using U = std::underlying_type_t<E>;
+
+    static constexpr auto collect() noexcept {
+        std::pair<std::array<E, scan::count()>, std::array<std::string_view, scan::count()>> out {};
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < scan::SPAN; ++i) {
+            if (!scan::all[i].empty()) {
+                out.first[n] = static_cast<E>(static_cast<U>(scan::LO + static_cast<long long>(i)));
+                out.second[n] = scan::all[i];
+                ++n;
+            }
+        }
+        return out;
+    }
+    static constexpr auto collected = collect();
+
+public:
+    static constexpr std::size_t count = scan::count();
+    // in increasing value order
+    static constexpr std::array<E, count> values = collected.first;
+    static constexpr std::array<std::string_view, count> names = collected.second;
+
+    static constexpr perfect_hash<count> by_name {names};
+
+    // position of v in values, count for values without a name
+    static constexpr std::size_t index_of(E v) noexcept {
+        auto offset = static_cast<long long>(static_cast<U>(v)) - scan::LO;
+        if (offset < 0 || offset >= static_cast<long long>(scan::SPAN)) {
+            return count;
+        }
+        return positions[static_cast<std::size_t>(offset)];
+    }
+
+    static constexpr std::string_view to_string(E v) noexcept {
+        std::size_t i = index_of(v);
+        return i < count ? names[i] : std::string_view{};
+    }
+
+    static constexpr std::optional<E> from_string(std::string_view name) noexcept {
+        std::size_t i = by_name.find(name);
+        return i < count ? std::optional<E>(values[i]) : std::nullopt;
+    }
+
+private:
+    static constexpr auto make_positions() noexcept {
+        std::array<std::uint16_t, scan::SPAN> pos {};
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < scan::SPAN; ++i) {
+            pos[i] = static_cast<std::uint16_t>(scan::all[i].empty() ? count : n++);
+        }
+        return pos;
+    }
+    static constexpr auto positions = make_positions();
+};
+
+
+// "" for values that aren't enumerators
+template<typename E>
+constexpr std::string_view enum_to_string(E v) noexcept {
+    return enum_traits<E>::to_string(v);
+}
+
+template<typename E>
+constexpr std::optional<E> enum_from_string(std::string_view name) noexcept {
+    return enum_traits<E>::from_string(name);
+}
+
+
+/*
+ * One T per enumerator of E, indexed by the enumerator. Enumerators need not be
+ * contiguous: the slot is found through enum_traits<E>::index_of.
+ * Every enumerator used as an index must lie inside enum_range<E>: one outside it
+ * has no slot (asserted in debug builds).
+ */
+template<typename E, typename T>
+struct enum_array {
+    static constexpr std::size_t N = enum_traits<E>::count;
+
+    std::array<T, N> data;
+
+    constexpr T& operator[](E e) noexcept {
+        std::size_t i = enum_traits<E>::index_of(e);
+        assert(i < N);
+        return data[i];
+    }
+    constexpr const T& operator[](E e) const noexcept {
+        std::size_t i = enum_traits<E>::index_of(e);
+        assert(i < N);
+        return data[i];
+    }
+
+    static constexpr std::size_t size() noexcept { return N; }
+    static constexpr const std::array<E, N>& keys() noexcept { return enum_traits<E>::values; }
+
+    constexpr auto begin() noexcept { return data.begin(); }
+    constexpr auto end() noexcept { return data.end(); }
+    constexpr auto begin() const noexcept { return data.begin(); }
+    constexpr auto end() const noexcept { return data.end(); }
+};
+
+
+#endif //EFFECTIVECPP_ENUM_REFLECT_H
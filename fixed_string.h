@@ -0,0 +1,228 @@
+#ifndef EFFECTIVECPP_FIXED_STRING_H
+#define EFFECTIVECPP_FIXED_STRING_H
+
+/*
+ * fixed_string<N>: a constexpr string with inline capacity N.
+ * Concatenation and number formatting all run at compile time, so
+ *     constexpr auto label = "pi = " + format_fixed<4>(3.14159265) + "\n";
+ * is a finished char array in .rodata and `cout << label` is a single write.
+ *
+ * The capacity is part of the type, the length is a (constexpr) member, because
+ * the formatted width of a number depends on its value and C++17 can't take a
+ * double as a template parameter.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+
+template<std::size_t N>
+class fixed_string {
+public:
+    constexpr fixed_string() noexcept = default;
+
+    // from a string literal, see the deduction guide below
+    constexpr fixed_string(const char (&str)[N + 1]) noexcept {
+        for (std::size_t i = 0; i < N; ++i) {
+            buf[i] = str[i];
+        }
+        len = N;
+    }
+
+    static constexpr std::size_t capacity() noexcept { return N; }
+    constexpr std::size_t size() const noexcept { return len; }
+    constexpr bool empty() const noexcept { return len == 0; }
+    constexpr const char* data() const noexcept { return buf; }
+    constexpr const char* c_str() const noexcept { return buf; }
+    constexpr char operator[](std::size_t i) const noexcept { return buf[i]; }
+    constexpr const char* begin() const noexcept { return buf; }
+    constexpr const char* end() const noexcept { return buf + len; }
+
+    constexpr std::string_view view() const noexcept { return {buf, len}; }
+    constexpr operator std::string_view() const noexcept { return view(); }
+    std::string str() const { return std::string(buf, len); }
+
+    // throws (i.e. fails to compile in a constant expression) when full
+    constexpr void push_back(char c) {
+        if (len == N) {
+            throw std::length_error("fixed_string capacity exceeded");
+        }
+        buf[len++] = c;
+        buf[len] = '\0';
+    }
+
+    template<std::size_t M>
+    constexpr void append(const fixed_string<M>& other) {
+        for (char c : other) {
+            push_back(c);
+        }
+    }
+
+private:
+    char buf[N + 1] {};
+    std::size_t len = 0;
+};
+
+template<std::size_t M>
+fixed_string(const char (&)[M]) -> fixed_string<M - 1>;
+
+
+template<std::size_t N, std::size_t M>
+constexpr bool operator==(const fixed_string<N>& a, const fixed_string<M>& b) noexcept {
+    return a.view() == b.view();
+}
+template<std::size_t N, std::size_t M>
+constexpr bool operator!=(const fixed_string<N>& a, const fixed_string<M>& b) noexcept {
+    return !(a == b);
+}
+template<std::size_t N>
+constexpr bool operator==(const fixed_string<N>& a, std::string_view b) noexcept {
+    return a.view() == b;
+}
+
+
+/*
+ * compile-time concatenation, the result capacity is the sum of both capacities
+ */
+template<std::size_t N, std::size_t M>
+constexpr fixed_string<N + M> operator+(const fixed_string<N>& a, const fixed_string<M>& b) {
+    fixed_string<N + M> result;
+    result.append(a);
+    result.append(b);
+    return result;
+}
+template<std::size_t N, std::size_t M>
+constexpr fixed_string<N + M - 1> operator+(const fixed_string<N>& a, const char (&b)[M]) {
+    return a + fixed_string<M - 1>(b);
+}
+template<std::size_t N, std::size_t M>
+constexpr fixed_string<N + M - 1> operator+(const char (&a)[M], const fixed_string<N>& b) {
+    return fixed_string<M - 1>(a) + b;
+}
+
+/*
+ * Constant prefix + runtime suffix: still a std::string at the end, but built
+ * with exactly one allocation instead of `"apple"s + x` (temporary, then regrow)
+ */
+template<std::size_t N>
+std::string operator+(const fixed_string<N>& prefix, const std::string& suffix) {
+    std::string result;
+    result.reserve(prefix.size() + suffix.size());
+    result.append(prefix.data(), prefix.size());
+    result.append(suffix);
+    return result;
+}
+
+
+// one ostream::write, no per-character formatting
+template<std::size_t N>
+std::ostream& operator<<(std::ostream& oss, const fixed_string<N>& s) {
+    return oss.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+
+/***************** constexpr number formatting *****************/
+
+template<std::size_t N>
+constexpr void append_digits(fixed_string<N>& out, std::uint64_t v, std::size_t min_width = 1) {
+    char tmp[20] {};
+    std::size_t n = 0;
+    do {
+        tmp[n++] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v);
+    for (; n < min_width; ++n) {
+        tmp[n] = '0';
+    }
+    while (n) {
+        out.push_back(tmp[--n]);
+    }
+}
+
+/*
+ * Integer to text: 20 chars hold any 64-bit value including the sign
+ */
+template<typename T>
+constexpr fixed_string<20> format_int(T value) {
+    static_assert(std::numeric_limits<T>::is_integer, "format_int needs an integer");
+    fixed_string<20> out;
+    std::uint64_t magnitude = static_cast<std::uint64_t>(value);
+    if constexpr (std::numeric_limits<T>::is_signed) {
+        if (value < 0) {
+            out.push_back('-');
+            // negate in unsigned arithmetic so INT64_MIN works
+            magnitude = ~magnitude + 1;
+        }
+    }
+    append_digits(out, magnitude);
+    return out;
+}
+
+
+/*
+ * Double to fixed-point text with `Precision` digits after the point, rounded to
+ * nearest. The sign is kept even when the integer part is zero (-0.25 -> "-0.25"),
+ * but -0.0 itself prints as "0.00": std::signbit is not constexpr.
+ * Magnitudes of 1e18 and above switch to scientific notation, nan/inf are spelled out.
+ * The last digit can differ from printf on exact halfway cases, because the
+ * fraction is scaled in double arithmetic rather than with exact decimal expansion.
+ */
+template<unsigned Precision = 6>
+constexpr auto format_fixed(double value) {
+    static_assert(Precision <= 17, "a double has at most 17 significant decimal digits");
+    // sign + 19 int digits + '.' + fraction + "e+NNN"
+    fixed_string<1 + 19 + 1 + Precision + 5> out;
+    if (value != value) {
+        out.append(fixed_string("nan"));
+        return out;
+    }
+    if (value < 0) {
+        out.push_back('-');
+        value = -value;
+    }
+    if (value == std::numeric_limits<double>::infinity()) {
+        out.append(fixed_string("inf"));
+        return out;
+    }
+
+    int exponent = 0;
+    bool scientific = value >= 1e18;
+    while (value >= 10 && scientific) {
+        value /= 10;
+        ++exponent;
+    }
+
+    std::uint64_t scale = 1;
+    for (unsigned i = 0; i < Precision; ++i) {
+        scale *= 10;
+    }
+    auto int_part = static_cast<std::uint64_t>(value);
+    auto frac_part = static_cast<std::uint64_t>((value - static_cast<double>(int_part)) * scale + 0.5);
+    if (frac_part >= scale) {  // 0.999 rounded up to 1.00
+        frac_part -= scale;
+        ++int_part;
+        if (scientific && int_part == 10) {
+            int_part = 1;
+            ++exponent;
+        }
+    }
+
+    append_digits(out, int_part);
+    if constexpr (Precision > 0) {
+        out.push_back('.');
+        append_digits(out, frac_part, Precision);
+    }
+    if (scientific) {
+        out.push_back('e');
+        out.push_back('+');
+        append_digits(out, static_cast<std::uint64_t>(exponent), 2);
+    }
+    return out;
+}
+
+
+#endif //EFFECTIVECPP_FIXED_STRING_H
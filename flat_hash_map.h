@@ -0,0 +1,579 @@
+#ifndef EFFECTIVECPP_FLAT_HASH_MAP_H
+#define EFFECTIVECPP_FLAT_HASH_MAP_H
+
+/*
+ * flat_hash_map<K, V>: open-addressing hash map in the style of Abseil's SwissTable.
+ * - entries live in one contiguous array, no per-node allocation
+ * - one control byte per slot (empty / deleted / 7 bits of the hash), probed 16 at a
+ *   time with SSE2, so most lookups touch one control group and one entry
+ * - transparent lookup: a map keyed by std::string can be searched with a
+ *   string_view or const char* without building a temporary std::string
+ * - the element type is kv_pair<K, V> {const K first; V second;}, NOT std::pair. That is on purpose: the
+ *   ch2_auto trap `for (const pair<string, Dummy>& p : map)` silently copies every
+ *   element from an unordered_map, here it simply does not compile.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+template<typename K, typename V>
+struct kv_pair {
+    const K first;
+    V second;
+};
+
+
+// hashes std::string, string_view and const char* identically, for heterogeneous lookup
+struct transparent_string_hash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const noexcept {
+        return std::hash<std::string_view>{}(s);
+    }
+};
+
+// default Hash/KeyEqual per key type: strings get the transparent pair
+template<typename K>
+struct flat_hash_defaults {
+    using hash = std::hash<K>;
+    using key_equal = std::equal_to<K>;
+};
+template<>
+struct flat_hash_defaults<std::string> {
+    using hash = transparent_string_hash;
+    using key_equal = std::equal_to<>;
+};
+
+
+namespace flat_hash_detail {
+
+    using ctrl_t = std::int8_t;
+    constexpr ctrl_t EMPTY = -128;    // 0b10000000
+    constexpr ctrl_t DELETED = -2;    // 0b11111110
+    constexpr ctrl_t SENTINEL = -1;   // 0b11111111, one past the last slot, stops iteration
+    // full slots hold H2, the low 7 bits of the hash: 0b0xxxxxxx
+    constexpr std::size_t GROUP = 16;
+
+    // bit i set <=> control byte i of the group matches
+    struct group {
+#ifdef __SSE2__
+        __m128i ctrl;
+        explicit group(const ctrl_t* p) noexcept
+        : ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(p)))
+        {}
+        std::uint32_t match(ctrl_t h2) const noexcept {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+        }
+        std::uint32_t match_empty() const noexcept {
+            return match(EMPTY);
+        }
+        // EMPTY and DELETED are the only values below SENTINEL
+        std::uint32_t match_empty_or_deleted() const noexcept {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(SENTINEL), ctrl)));
+        }
+#else
+        const ctrl_t* ctrl;
+        explicit group(const ctrl_t* p) noexcept : ctrl(p) {}
+        std::uint32_t match(ctrl_t h2) const noexcept {
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < GROUP; ++i) {
+                mask |= static_cast<std::uint32_t>(ctrl[i] == h2) << i;
+            }
+            return mask;
+        }
+        std::uint32_t match_empty() const noexcept {
+            return match(EMPTY);
+        }
+        std::uint32_t match_empty_or_deleted() const noexcept {
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < GROUP; ++i) {
+                mask |= static_cast<std::uint32_t>(ctrl[i] < SENTINEL) << i;
+            }
+            return mask;
+        }
+#endif
+    };
+
+    inline unsigned lowest_bit(std::uint32_t mask) noexcept {
+        return static_cast<unsigned>(__builtin_ctz(mask));
+    }
+
+    /*
+     * std::hash on integers is the identity, which would put all the entropy in
+     * H1 and none in H2. Fold a 64x64->128 multiply to spread every input bit.
+     */
+    inline std::uint64_t mix(std::uint64_t h) noexcept {
+        __uint128_t r = static_cast<__uint128_t>(h) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+    }
+
+}
+
+
+template<typename K, typename V,
+         typename Hash = typename flat_hash_defaults<K>::hash,
+         typename KeyEqual = typename flat_hash_defaults<K>::key_equal>
+class flat_hash_map {
+    using ctrl_t = flat_hash_detail::ctrl_t;
+    static constexpr std::size_t GROUP = flat_hash_detail::GROUP;
+
+    template<typename F, typename = void>
+    struct _has_is_transparent : std::false_type {};
+    template<typename F>
+    struct _has_is_transparent<F, std::void_t<typename F::is_transparent>> : std::true_type {};
+    static constexpr bool is_transparent = _has_is_transparent<Hash>::value && _has_is_transparent<KeyEqual>::value;
+
+    // heterogeneous overloads only exist when both functors are transparent
+    template<typename Q>
+    using enable_if_transparent = std::enable_if_t<is_transparent && sizeof(Q) != 0, int>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = kv_pair<K, V>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    template<bool Const>
+    class basic_iterator {
+    public:
+        using value_type = kv_pair<K, V>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        basic_iterator() noexcept = default;
+        // iterator -> const_iterator
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& other) noexcept
+        : ctrl(other.ctrl), slot(other.slot)
+        {}
+
+        reference operator*() const noexcept { return *slot; }
+        pointer operator->() const noexcept { return slot; }
+        basic_iterator& operator++() noexcept {
+            ++ctrl;
+            ++slot;
+            skip_free();
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept { return a.slot == b.slot; }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) noexcept { return a.slot != b.slot; }
+
+    private:
+        friend class flat_hash_map;
+        template<bool> friend class basic_iterator;
+        basic_iterator(const ctrl_t* ctrl, pointer slot) noexcept
+        : ctrl(ctrl), slot(slot)
+        {}
+        // full bytes are >= 0 and the sentinel is -1, everything else is free
+        void skip_free() noexcept {
+            while (*ctrl < flat_hash_detail::SENTINEL) {
+                ++ctrl;
+                ++slot;
+            }
+        }
+
+        const ctrl_t* ctrl = nullptr;
+        pointer slot = nullptr;
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    flat_hash_map() = default;
+
+    flat_hash_map(std::initializer_list<std::pair<K, V>> init) {
+        reserve(init.size());
+        for (auto& kv : init) {
+            try_emplace(kv.first, kv.second);
+        }
+    }
+
+    flat_hash_map(const flat_hash_map& other)
+    : hash_fn(other.hash_fn), eq_fn(other.eq_fn) {
+        reserve(other.size());
+        for (auto& kv : other) {
+            insert_unique(hash_of(kv.first), kv.first, kv.second);
+        }
+    }
+
+    flat_hash_map(flat_hash_map&& other) noexcept
+    : hash_fn(std::move(other.hash_fn)), eq_fn(std::move(other.eq_fn)),
+      ctrl(other.ctrl), slots(other.slots), cap(other.cap), sz(other.sz), growth_left(other.growth_left) {
+        other.reset_empty();
+    }
+
+    flat_hash_map& operator=(flat_hash_map other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~flat_hash_map() {
+        destroy_all();
+    }
+
+    void swap(flat_hash_map& other) noexcept {
+        using std::swap;
+        swap(hash_fn, other.hash_fn);
+        swap(eq_fn, other.eq_fn);
+        swap(ctrl, other.ctrl);
+        swap(slots, other.slots);
+        swap(cap, other.cap);
+        swap(sz, other.sz);
+        swap(growth_left, other.growth_left);
+    }
+
+    /***************** iteration *****************/
+    iterator begin() noexcept {
+        if (!cap) {
+            return end();
+        }
+        iterator it(ctrl, slots);
+        it.skip_free();
+        return it;
+    }
+    iterator end() noexcept { return iterator(ctrl + cap, slots + cap); }
+    const_iterator begin() const noexcept { return const_cast<flat_hash_map*>(this)->begin(); }
+    const_iterator end() const noexcept { return const_cast<flat_hash_map*>(this)->end(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    size_type size() const noexcept { return sz; }
+    bool empty() const noexcept { return sz == 0; }
+    size_type capacity() const noexcept { return cap; }
+    double load_factor() const noexcept { return cap ? static_cast<double>(sz) / cap : 0.0; }
+
+    /***************** lookup *****************/
+    iterator find(const K& key) { return find_impl(key); }
+    const_iterator find(const K& key) const { return const_cast<flat_hash_map*>(this)->find_impl(key); }
+    template<typename Q, enable_if_transparent<Q> = 0>
+    iterator find(const Q& key) { return find_impl(key); }
+    template<typename Q, enable_if_transparent<Q> = 0>
+    const_iterator find(const Q& key) const { return const_cast<flat_hash_map*>(this)->find_impl(key); }
+
+    bool contains(const K& key) const { return find(key) != end(); }
+    template<typename Q, enable_if_transparent<Q> = 0>
+    bool contains(const Q& key) const { return find(key) != end(); }
+    size_type count(const K& key) const { return contains(key); }
+    template<typename Q, enable_if_transparent<Q> = 0>
+    size_type count(const Q& key) const { return contains(key); }
+
+    V& at(const K& key) { return at_impl(key); }
+    const V& at(const K& key) const { return const_cast<flat_hash_map*>(this)->at_impl(key); }
+    template<typename Q, enable_if_transparent<Q> = 0>
+    V& at(const Q& key) { return at_impl(key); }
+    template<typename Q, enable_if_transparent<Q> = 0>
+    const V& at(const Q& key) const { return const_cast<flat_hash_map*>(this)->at_impl(key); }
+
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+    V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+    template<typename Q, enable_if_transparent<Q> = 0>
+    V& operator[](const Q& key) { return try_emplace(key).first->second; }
+
+    /***************** insertion *****************/
+    /*
+     * The key is only converted to K (e.g. string_view -> std::string) when the
+     * entry is actually inserted, and V is built in place from args: no temporaries
+     * on the hit path, no V copy on the miss path.
+     */
+    template<typename KArg, typename... Args>
+    std::pair<iterator, bool> try_emplace(KArg&& key, Args&&... args) {
+        if constexpr (!std::is_same_v<std::decay_t<KArg>, K> && !is_transparent) {
+            // without transparent functors the key has to become a K first
+            return try_emplace(K(std::forward<KArg>(key)), std::forward<Args>(args)...);
+        }
+        else {
+            std::size_t h = hash_of(key);
+            if (auto it = find_hashed(key, h); it != end()) {
+                return {it, false};
+            }
+            return {insert_unique(h, std::forward<KArg>(key), std::forward<Args>(args)...), true};
+        }
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const K& key, Args&&... args) {
+        return try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<K, V>& kv) {
+        return try_emplace(kv.first, kv.second);
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    /***************** removal *****************/
+    size_type erase(const K& key) { return erase_impl(key); }
+    template<typename Q, enable_if_transparent<Q> = 0>
+    size_type erase(const Q& key) { return erase_impl(key); }
+
+    iterator erase(const_iterator pos) {
+        std::size_t i = static_cast<std::size_t>(pos.slot - slots);
+        erase_at(i);
+        iterator next(ctrl + i, slots + i);
+        next.skip_free();
+        return next;
+    }
+
+    void clear() noexcept {
+        for (std::size_t i = 0; i < cap; ++i) {
+            if (ctrl[i] >= 0) {
+                slots[i].~value_type();
+            }
+        }
+        if (cap) {
+            std::memset(ctrl, flat_hash_detail::EMPTY, cap);
+        }
+        sz = 0;
+        growth_left = max_load(cap);
+    }
+
+    // make room for n elements without rehashing
+    void reserve(size_type n) {
+        if (n > sz + growth_left) {
+            std::size_t new_cap = GROUP;
+            while (max_load(new_cap) < n) {
+                new_cap *= 2;
+            }
+            rehash(new_cap);
+        }
+    }
+
+private:
+    // 7/8 maximum load factor
+    static constexpr std::size_t max_load(std::size_t capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    template<typename Q>
+    std::size_t hash_of(const Q& key) const {
+        return flat_hash_detail::mix(static_cast<std::uint64_t>(hash_fn(key)));
+    }
+    static ctrl_t h2(std::size_t h) noexcept { return static_cast<ctrl_t>(h & 0x7F); }
+    static std::size_t h1(std::size_t h) noexcept { return h >> 7; }
+
+    template<typename Q>
+    iterator find_impl(const Q& key) {
+        return find_hashed(key, hash_of(key));
+    }
+
+    /*
+     * Probe whole groups: compare all 16 control bytes with H2 in one instruction,
+     * check only the candidates, stop at the first group that has an empty slot.
+     * Triangular probing over a power-of-two group count visits every group.
+     */
+    template<typename Q>
+    iterator find_hashed(const Q& key, std::size_t h) {
+        if (!cap) {
+            return end();
+        }
+        const std::size_t mask = cap / GROUP - 1;
+        std::size_t g = h1(h) & mask;
+        for (std::size_t step = 1; ; ++step) {
+            flat_hash_detail::group grp(ctrl + g * GROUP);
+            for (std::uint32_t m = grp.match(h2(h)); m; m &= m - 1) {
+                std::size_t i = g * GROUP + flat_hash_detail::lowest_bit(m);
+                if (eq_fn(slots[i].first, key)) {
+                    return iterator(ctrl + i, slots + i);
+                }
+            }
+            if (grp.match_empty() || step > mask) {
+                return end();
+            }
+            g = (g + step) & mask;
+        }
+    }
+
+    // first empty or deleted slot on the probe sequence of h
+    std::size_t find_free_slot(std::size_t h) const noexcept {
+        const std::size_t mask = cap / GROUP - 1;
+        std::size_t g = h1(h) & mask;
+        for (std::size_t step = 1; ; ++step) {
+            flat_hash_detail::group grp(ctrl + g * GROUP);
+            if (std::uint32_t m = grp.match_empty_or_deleted()) {
+                return g * GROUP + flat_hash_detail::lowest_bit(m);
+            }
+            g = (g + step) & mask;
+        }
+    }
+
+    // key is known to be absent
+    template<typename KArg, typename... Args>
+    iterator insert_unique(std::size_t h, KArg&& key, Args&&... args) {
+        if (growth_left == 0) {
+            /*
+             * key or args may refer into the table (m.try_emplace(k, m.at(j))), so build
+             * the element in the new table first and only then move the old slots over,
+             * like vector growth. On a throw the old table is put back untouched.
+             */
+            ctrl_t* old_ctrl = ctrl;
+            value_type* old_slots = slots;
+            std::size_t old_cap = cap;
+            // mostly tombstones: clean up in place, otherwise double
+            allocate(cap && sz < max_load(cap) / 2 ? cap : std::max(cap * 2, GROUP));
+            std::size_t i = find_free_slot(h);
+            try {
+                ::new (static_cast<void*>(slots + i)) value_type{K(std::forward<KArg>(key)), V(std::forward<Args>(args)...)};
+            }
+            catch (...) {
+                deallocate(ctrl, slots, cap);
+                ctrl = old_ctrl;
+                slots = old_slots;
+                cap = old_cap;
+                throw;
+            }
+            ctrl[i] = h2(h);
+            ++sz;
+            move_slots(old_ctrl, old_slots, old_cap);
+            return iterator(ctrl + i, slots + i);
+        }
+        std::size_t i = find_free_slot(h);
+        // aggregate init with prvalues: K and V are constructed directly in the slot
+        ::new (static_cast<void*>(slots + i)) value_type{K(std::forward<KArg>(key)), V(std::forward<Args>(args)...)};
+        if (ctrl[i] == flat_hash_detail::EMPTY) {
+            --growth_left;
+        }
+        ctrl[i] = h2(h);
+        ++sz;
+        return iterator(ctrl + i, slots + i);
+    }
+
+    template<typename Q>
+    V& at_impl(const Q& key) {
+        auto it = find_impl(key);
+        if (it == end()) {
+            throw std::out_of_range("flat_hash_map::at");
+        }
+        return it->second;
+    }
+
+    template<typename Q>
+    size_type erase_impl(const Q& key) {
+        auto it = find_impl(key);
+        if (it == end()) {
+            return 0;
+        }
+        erase_at(static_cast<std::size_t>(it.slot - slots));
+        return 1;
+    }
+
+    /*
+     * A lookup stops at the first group with an EMPTY byte. If this group already
+     * has one, no probe sequence can continue past it, so the slot can go back to
+     * EMPTY. Otherwise it must become a DELETED tombstone.
+     */
+    void erase_at(std::size_t i) {
+        slots[i].~value_type();
+        --sz;
+        flat_hash_detail::group grp(ctrl + i / GROUP * GROUP);
+        if (grp.match_empty()) {
+            ctrl[i] = flat_hash_detail::EMPTY;
+            ++growth_left;
+        }
+        else {
+            ctrl[i] = flat_hash_detail::DELETED;
+        }
+    }
+
+    void rehash(std::size_t new_cap) {
+        ctrl_t* old_ctrl = ctrl;
+        value_type* old_slots = slots;
+        std::size_t old_cap = cap;
+
+        allocate(new_cap);
+        move_slots(old_ctrl, old_slots, old_cap);
+    }
+
+    // move every element of the old table into the freshly allocated one, then free it
+    void move_slots(ctrl_t* old_ctrl, value_type* old_slots, std::size_t old_cap) {
+        for (std::size_t i = 0; i < old_cap; ++i) {
+            if (old_ctrl[i] >= 0) {
+                value_type& kv = old_slots[i];
+                std::size_t h = hash_of(kv.first);
+                std::size_t j = find_free_slot(h);
+                /*
+                 * The key is const inside the map, but this slot dies on the next line
+                 * and nobody can observe it anymore, so moving out of it is safe.
+                 * Same trick as absl / boost::unordered_flat_map; a std::string key is
+                 * moved, not copied, on every rehash.
+                 */
+                ::new (static_cast<void*>(slots + j)) value_type{
+                    std::move(const_cast<K&>(kv.first)), std::move(kv.second)};
+                kv.~value_type();
+                ctrl[j] = h2(h);
+            }
+        }
+        growth_left = max_load(cap) - sz;
+        deallocate(old_ctrl, old_slots, old_cap);
+    }
+
+    void allocate(std::size_t new_cap) {
+        // control bytes must be 16-byte aligned for _mm_load_si128, +1 for the sentinel
+        ctrl = static_cast<ctrl_t*>(::operator new(new_cap + GROUP, std::align_val_t{GROUP}));
+        std::memset(ctrl, flat_hash_detail::EMPTY, new_cap);
+        ctrl[new_cap] = flat_hash_detail::SENTINEL;
+        slots = static_cast<value_type*>(
+            ::operator new(new_cap * sizeof(value_type), std::align_val_t{alignof(value_type)}));
+        cap = new_cap;
+    }
+
+    static void deallocate(ctrl_t* c, value_type* s, std::size_t capacity) noexcept {
+        if (capacity) {
+            ::operator delete(c, std::align_val_t{GROUP});
+            ::operator delete(s, std::align_val_t{alignof(value_type)});
+        }
+    }
+
+    void destroy_all() noexcept {
+        for (std::size_t i = 0; i < cap; ++i) {
+            if (ctrl[i] >= 0) {
+                slots[i].~value_type();
+            }
+        }
+        deallocate(ctrl, slots, cap);
+        reset_empty();
+    }
+
+    void reset_empty() noexcept {
+        ctrl = nullptr;
+        slots = nullptr;
+        cap = sz = growth_left = 0;
+    }
+
+    Hash hash_fn;
+    KeyEqual eq_fn;
+    ctrl_t* ctrl = nullptr;
+    value_type* slots = nullptr;
+    std::size_t cap = 0;
+    std::size_t sz = 0;
+    std::size_t growth_left = 0;
+};
+
+
+#endif //EFFECTIVECPP_FLAT_HASH_MAP_H
@@ -0,0 +1,277 @@
+#ifndef EFFECTIVECPP_HANA_HASH_H
+#define EFFECTIVECPP_HANA_HASH_H
+
+/*
+ * fast_hash<T> / fast_equal<T>: hash and member-wise equality derived at compile
+ * time, so aggregates can be hash-map keys without hand-written std::hash:
+ *
+ *   unordered_map<Fish, int, fast_hash<Fish>, fast_equal<Fish>> by_fish;
+ *   flat_hash_map<UserInfo, int, fast_hash<UserInfo>, fast_equal<UserInfo>> by_user;
+ *
+ * What gets hashed is picked by detection, in the style of is_serializable:
+ *   - istring (intern_pool.h): its 32-bit id, never the text it converts to
+ *   - bytes of the whole object when it has unique object representations
+ *     (ints, enums, pointers, padding-free structs of those): one wyhash call
+ *   - strings, string_view and vectors of such bytes: one wyhash call over the buffer
+ *   - floating point: the value with -0.0 folded into 0.0, so equal values hash equal
+ *   - hana Structs, std::tuple / std::pair and hana sequences: member by member,
+ *     every member's hash becoming the seed of the next one, so {a, b} != {b, a}
+ *   - other ranges: element by element
+ *   - anything else with a std::hash: that value, remixed
+ *
+ * The byte hash follows wyhash (Wang Yi, public domain): 64x64->128 multiply and
+ * fold, 16 bytes per round, three lanes for long inputs. Not a cryptographic hash
+ * and not stable across builds.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/hana.hpp>
+
+namespace hana = boost::hana;
+
+
+namespace hana_hash_detail {
+    constexpr std::uint64_t SECRET[4] = {
+        0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+    };
+
+    inline void mum(std::uint64_t& a, std::uint64_t& b) noexcept {
+        __uint128_t r = static_cast<__uint128_t>(a) * b;
+        a = static_cast<std::uint64_t>(r);
+        b = static_cast<std::uint64_t>(r >> 64);
+    }
+    inline std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept {
+        mum(a, b);
+        return a ^ b;
+    }
+
+    inline std::uint64_t read8(const unsigned char* p) noexcept {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+    inline std::uint64_t read4(const unsigned char* p) noexcept {
+        std::uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+    // 1 to 3 bytes: first, middle and last
+    inline std::uint64_t read3(const unsigned char* p, std::size_t k) noexcept {
+        return (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[k >> 1]} << 8) | p[k - 1];
+    }
+}
+
+
+inline std::uint64_t wyhash_bytes(const void* key, std::size_t len, std::uint64_t seed = 0) noexcept {
+    using namespace hana_hash_detail;
+    auto p = static_cast<const unsigned char*>(key);
+    seed ^= mix(seed ^ SECRET[0], SECRET[1]);
+    std::uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            std::size_t mid = (len >> 3) << 2;
+            a = (read4(p) << 32) | read4(p + mid);
+            b = (read4(p + len - 4) << 32) | read4(p + len - 4 - mid);
+        }
+        else if (len > 0) {
+            a = read3(p, len);
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        std::size_t i = len;
+        if (i > 48) {
+            // three independent lanes keep the multipliers busy
+            std::uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+                see1 = mix(read8(p + 16) ^ SECRET[2], read8(p + 24) ^ see1);
+                see2 = mix(read8(p + 32) ^ SECRET[3], read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+    a ^= SECRET[1];
+    b ^= seed;
+    mum(a, b);
+    return mix(a ^ SECRET[0] ^ len, b ^ SECRET[1]);
+}
+
+// one 64-bit word into a running hash
+inline std::uint64_t wyhash_word(std::uint64_t value, std::uint64_t seed) noexcept {
+    using namespace hana_hash_detail;
+    return mix(value ^ seed ^ SECRET[0], value ^ SECRET[2]);
+}
+
+
+/***************** detection *****************/
+inline auto has_std_hash = hana::is_valid([](auto&& x) -> decltype(
+    (void) std::hash<std::decay_t<decltype(x)>>{}(x)) { });
+
+inline auto is_range = hana::is_valid([](auto&& x) -> decltype(
+    (void) std::begin(x), (void) std::end(x)) { });
+
+inline auto is_contiguous = hana::is_valid([](auto&& x) -> decltype(
+    (void) std::data(x), (void) std::size(x)) { });
+
+template<typename T>
+struct is_std_tuple : std::false_type {};
+template<typename... Ts>
+struct is_std_tuple<std::tuple<Ts...>> : std::true_type {};
+template<typename A, typename B>
+struct is_std_tuple<std::pair<A, B>> : std::true_type {};
+
+// equal values have equal bytes: the whole object can go through wyhash_bytes
+template<typename T>
+constexpr bool is_bytewise_hashable_v = std::has_unique_object_representations_v<T>;
+
+
+class istring;
+
+template<typename T>
+std::uint64_t hash_value(const T& x, std::uint64_t seed = 0) noexcept;
+
+namespace hana_hash_detail {
+    template<typename T>
+    std::uint64_t hash_members(const T& x, std::uint64_t seed) noexcept {
+        if constexpr (hana::Struct<T>::value) {
+            hana::for_each(hana::accessors<T>(), [&](auto acc) {
+                seed = hash_value(hana::second(acc)(x), seed);
+            });
+        }
+        else if constexpr (is_std_tuple<T>::value) {
+            std::apply([&](const auto&... m) { ((seed = hash_value(m, seed)), ...); }, x);
+        }
+        else {
+            hana::for_each(x, [&](const auto& m) { seed = hash_value(m, seed); });
+        }
+        return seed;
+    }
+}
+
+template<typename T>
+std::uint64_t hash_value(const T& x, std::uint64_t seed) noexcept {
+    if constexpr (std::is_same_v<T, istring>) {
+        // converts to string_view too, but equal text means equal id
+        return wyhash_word(x.id(), seed);
+    }
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        std::string_view s = x;
+        return wyhash_bytes(s.data(), s.size(), seed);
+    }
+    else if constexpr (std::is_floating_point_v<T>) {
+        double d = x == 0 ? 0.0 : static_cast<double>(x);  // -0.0 == 0.0
+        std::uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        return wyhash_word(bits, seed);
+    }
+    else if constexpr (is_bytewise_hashable_v<T> && sizeof(T) <= 8) {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &x, sizeof(T));
+        return wyhash_word(bits, seed);
+    }
+    else if constexpr (is_bytewise_hashable_v<T>) {
+        return wyhash_bytes(&x, sizeof(T), seed);
+    }
+    else if constexpr (hana::Struct<T>::value || is_std_tuple<T>::value || hana::Sequence<T>::value) {
+        return hana_hash_detail::hash_members(x, seed);
+    }
+    else if constexpr (decltype(is_contiguous(x))::value) {
+        using E = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(x))>>;
+        if constexpr (is_bytewise_hashable_v<E>) {
+            return wyhash_bytes(std::data(x), std::size(x) * sizeof(E), seed);
+        }
+        else {
+            for (const auto& e : x) {
+                seed = hash_value(e, seed);
+            }
+            return wyhash_word(std::size(x), seed);
+        }
+    }
+    else if constexpr (decltype(is_range(x))::value) {
+        std::uint64_t n = 0;
+        for (const auto& e : x) {
+            seed = hash_value(e, seed);
+            ++n;
+        }
+        return wyhash_word(n, seed);
+    }
+    else {
+        static_assert(decltype(has_std_hash(x))::value,
+                      "fast_hash: T is not a hana Struct, tuple, range, string or std::hash-able");
+        return wyhash_word(std::hash<T>{}(x), seed);
+    }
+}
+
+
+/*
+ * Member-wise ==, with the same recursion as hash_value so the two always agree
+ * on which members matter. Leaves fall back to the type's own ==.
+ */
+template<typename T>
+bool equal_value(const T& a, const T& b) noexcept {
+    if constexpr (hana::Struct<T>::value) {
+        bool eq = true;
+        hana::for_each(hana::accessors<T>(), [&](auto acc) {
+            eq = eq && equal_value(hana::second(acc)(a), hana::second(acc)(b));
+        });
+        return eq;
+    }
+    else if constexpr (is_std_tuple<T>::value) {
+        return std::apply([&](const auto&... x) {
+            return std::apply([&](const auto&... y) { return (equal_value(x, y) && ...); }, b);
+        }, a);
+    }
+    else if constexpr (hana::Sequence<T>::value) {
+        bool eq = true;
+        hana::for_each(hana::make_range(hana::size_c<0>, hana::length(a)), [&](auto i) {
+            eq = eq && equal_value(a[i], b[i]);
+        });
+        return eq;
+    }
+    else if constexpr (is_bytewise_hashable_v<T> && !std::is_scalar_v<T>) {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    }
+    else {
+        return a == b;
+    }
+}
+
+
+template<typename T>
+struct fast_hash {
+    std::size_t operator()(const T& x) const noexcept {
+        return static_cast<std::size_t>(hash_value(x));
+    }
+};
+
+template<typename T>
+struct fast_equal {
+    bool operator()(const T& a, const T& b) const noexcept {
+        return equal_value(a, b);
+    }
+};
+
+
+#endif //EFFECTIVECPP_HANA_HASH_H
@@ -0,0 +1,104 @@
+#ifndef EFFECTIVECPP_HANA_SWITCH_H
+#define EFFECTIVECPP_HANA_SWITCH_H
+
+/*
+ * Compile time meta-switch for type selection from boost::any, see boost_hana_switch.cpp:
+ *     string r = switch_(a)(
+ *         case_<int>([](auto i) { ... }),
+ *         default_([] { ... })
+ *     );
+ * arg can be a boost::any or a small_any (small_any.h).
+ */
+#include <typeindex>
+#include <boost/any.hpp>
+#include <boost/hana.hpp>
+
+namespace hana = boost::hana;
+
+
+/*
+ * associate each type to a function
+ * pair.first is type and pair.second is actual function
+ */
+template<typename T>
+inline auto case_ = [](auto f) {
+    return hana::make_pair(hana::type_c<T>, f);
+};
+
+struct default_t;
+inline auto default_ = case_<default_t>;
+
+/*
+ * How the dispatch names the dynamic type. boost::any: its std::type_index.
+ * Anything with a type_id() and a static id_of<T>() (small_any.h): that id, so each
+ * case costs one pointer compare instead of a type_info comparison.
+ */
+inline auto has_type_id = hana::is_valid([](auto&& a) -> decltype((void) a.type_id()) { });
+
+template<typename Any>
+auto _switch_type_key(const Any& a) {
+    if constexpr (decltype(has_type_id(a))::value) {
+        return a.type_id();
+    }
+    else {
+        return std::type_index(a.type());
+    }
+}
+
+template<typename T, typename Any>
+auto _switch_type_key_of() {
+    if constexpr (decltype(has_type_id(std::declval<const Any&>()))::value) {
+        return Any::template id_of<T>();
+    }
+    else {
+        return std::type_index(typeid(T));
+    }
+}
+
+// base case: no more cases left, execute the default
+template <typename Any, typename Key, typename Default>
+auto _switch_process(Any&, Key const&, Default& default_) {
+    return default_();
+}
+// recursion on ...Rest
+template <typename Any, typename Key, typename Default, typename Case, typename ...Rest>
+auto _switch_process(Any& a, Key const& t, Default& default_,
+    Case& case_, Rest& ...rest)
+{
+    using T = typename decltype(+hana::first(case_))::type;
+    // boost::unsafe_any_cast for boost::any, found by ADL for other any types
+    using boost::unsafe_any_cast;
+    // if Any's type matches the case type (first of the tuple), execute its associated function
+    return t == _switch_type_key_of<T, Any>() ? hana::second(case_)(*unsafe_any_cast<T>(&a))
+        : _switch_process(a, t, default_, rest...);
+}
+
+/*
+ * switch_(arg) returns a lambda function that does the type dispatching
+ */
+template<typename T>
+auto switch_(T& arg) {
+    return [&arg](auto ... cases_) {
+        // put into a hana tuple to mainipulate
+        auto cases = hana::make_tuple(cases_ ...);
+        // find the default case first, returns hana::optional
+        // predicate must be generic because of heterogenous typing and must return hana IntegralConstant
+        // http://boostorg.github.io/hana/index.html#tutorial-algorithms-cross_phase
+        auto default_ = hana::find_if(cases, [](auto const& c) {
+            // recall: first of the case tuple is the type
+            return hana::first(c) == hana::type_c<default_t>;  // same as c[1_c]
+        });
+        static_assert(!hana::is_nothing(default_), "hana switch_ is missing default case!");
+        // remove the default case first
+        auto rest = hana::filter(cases, [](auto const& c) {
+            return hana::first(c) != hana::type_c<default_t>;
+        });
+        // unpack(args, f) is similar to python unpacking call f(*args)
+        return hana::unpack(rest, [&](auto& ...rest) {
+            return _switch_process(arg, _switch_type_key(arg), hana::second(*default_), rest...);
+        });
+    };
+}
+
+
+#endif //EFFECTIVECPP_HANA_SWITCH_H
@@ -0,0 +1,252 @@
+#ifndef EFFECTIVECPP_INTERN_POOL_H
+#define EFFECTIVECPP_INTERN_POOL_H
+
+/*
+ * String interning: every distinct string is stored once and named by a 32-bit id.
+ *
+ *   istring a = "apple", b = string("apple");   // both intern into default_intern_pool()
+ *   a == b;                                     // one integer compare
+ *   a.view();                                   // string_view into the pool, valid forever
+ *
+ * intern_pool keeps the characters in arena blocks that never move (doubling from
+ * 1 KB to 64 KB per shard), so views stay valid for the life of the pool, and maps
+ * text -> id with SHARDS flat_hash_maps, each behind its own shared_mutex: a lookup of a known string
+ * takes one shared lock on one shard, a new string one exclusive lock. id -> text
+ * is a two-level table of pages that are only ever appended to, read without a
+ * lock. Strings are never removed.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "flat_hash_map.h"
+
+
+class intern_pool {
+public:
+    using id_type = std::uint32_t;
+
+    static constexpr std::size_t SHARDS = 16;
+    static constexpr std::size_t MIN_BLOCK_BYTES = 1 << 10;
+    static constexpr std::size_t BLOCK_BYTES = 1 << 16;
+    static constexpr std::size_t PAGE_BITS = 16;
+    static constexpr std::size_t PAGE_SIZE = std::size_t{1} << PAGE_BITS;
+    static constexpr std::size_t MAX_PAGES = std::size_t{1} << (32 - PAGE_BITS);
+
+    struct stats {
+        std::size_t strings = 0;      // distinct strings, including ""
+        std::size_t text_bytes = 0;   // their characters
+        std::size_t arena_bytes = 0;  // blocks allocated for them
+        std::size_t index_bytes = 0;  // hash index slots plus the id table
+        std::size_t total_bytes() const noexcept { return arena_bytes + index_bytes; }
+    };
+
+    // id 0 is always ""
+    intern_pool()
+    : pages(new std::atomic<std::string_view*>[MAX_PAGES]()) {
+        intern(std::string_view{});
+    }
+
+    ~intern_pool() {
+        for (std::size_t i = 0; i < MAX_PAGES; ++i) {
+            delete[] pages[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    intern_pool(const intern_pool&) = delete;
+    intern_pool& operator=(const intern_pool&) = delete;
+
+    id_type intern(std::string_view s) {
+        std::size_t h = std::hash<std::string_view>{}(s);
+        shard& sh = shards[(h >> 32) % SHARDS];
+        {
+            std::shared_lock<std::shared_mutex> lock(sh.mutex);
+            auto it = sh.index.find(s);
+            if (it != sh.index.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(sh.mutex);
+        auto it = sh.index.find(s);
+        if (it != sh.index.end()) {
+            return it->second;  // another thread got here first
+        }
+        std::string_view stored = sh.store(s);
+        id_type id = next_id.fetch_add(1, std::memory_order_relaxed);
+        if (id == MAX_ID) {
+            throw std::length_error("intern_pool: out of 32-bit ids");
+        }
+        slot(id) = stored;
+        // the id only escapes through the index, whose lock publishes the slot write
+        sh.index.try_emplace(stored, id);
+        return id;
+    }
+
+    // the id of s if it was interned before, without adding it
+    bool find(std::string_view s, id_type& id) const {
+        std::size_t h = std::hash<std::string_view>{}(s);
+        const shard& sh = shards[(h >> 32) % SHARDS];
+        std::shared_lock<std::shared_mutex> lock(sh.mutex);
+        auto it = sh.index.find(s);
+        if (it == sh.index.end()) {
+            return false;
+        }
+        id = it->second;
+        return true;
+    }
+
+    // only valid for ids this pool handed out
+    std::string_view view(id_type id) const noexcept {
+        return pages[id >> PAGE_BITS].load(std::memory_order_acquire)[id & (PAGE_SIZE - 1)];
+    }
+
+    std::size_t size() const noexcept { return next_id.load(std::memory_order_relaxed); }
+
+    stats memory() const {
+        stats st;
+        st.strings = size();
+        for (auto& sh : shards) {
+            std::shared_lock<std::shared_mutex> lock(sh.mutex);
+            st.text_bytes += sh.text_bytes;
+            st.arena_bytes += sh.arena_bytes;
+            st.index_bytes += sh.index.capacity() * (sizeof(kv_pair<std::string_view, id_type>) + 1);
+        }
+        std::size_t used_pages = (st.strings + PAGE_SIZE - 1) / PAGE_SIZE;
+        st.index_bytes += MAX_PAGES * sizeof(void*) + used_pages * PAGE_SIZE * sizeof(std::string_view);
+        return st;
+    }
+
+private:
+    static constexpr id_type MAX_ID = ~id_type{0};
+
+    struct alignas(64) shard {
+        mutable std::shared_mutex mutex;
+        flat_hash_map<std::string_view, id_type> index;
+        std::vector<std::unique_ptr<char[]>> blocks;
+        char* cursor = nullptr;
+        std::size_t left = 0;
+        std::size_t text_bytes = 0;
+        std::size_t arena_bytes = 0;
+
+        // copy s into the arena, long strings get a block of their own
+        std::string_view store(std::string_view s) {
+            if (s.empty()) {
+                return {"", 0};
+            }
+            text_bytes += s.size();
+            if (s.size() > left) {
+                std::size_t block = std::clamp(arena_bytes, MIN_BLOCK_BYTES, BLOCK_BYTES);
+                std::size_t bytes = std::max(block, s.size());
+                blocks.emplace_back(new char[bytes]);
+                arena_bytes += bytes;
+                if (bytes > block) {
+                    std::memcpy(blocks.back().get(), s.data(), s.size());
+                    return {blocks.back().get(), s.size()};
+                }
+                cursor = blocks.back().get();
+                left = bytes;
+            }
+            std::memcpy(cursor, s.data(), s.size());
+            std::string_view stored {cursor, s.size()};
+            cursor += s.size();
+            left -= s.size();
+            return stored;
+        }
+    };
+
+    // writable slot for a fresh id, allocating its page on first use
+    std::string_view& slot(id_type id) {
+        auto& page = pages[id >> PAGE_BITS];
+        std::string_view* p = page.load(std::memory_order_acquire);
+        if (!p) {
+            auto* fresh = new std::string_view[PAGE_SIZE];
+            if (page.compare_exchange_strong(p, fresh, std::memory_order_acq_rel)) {
+                p = fresh;
+            }
+            else {
+                delete[] fresh;  // another shard allocated it meanwhile
+            }
+        }
+        return p[id & (PAGE_SIZE - 1)];
+    }
+
+    shard shards[SHARDS];
+    std::unique_ptr<std::atomic<std::string_view*>[]> pages;
+    std::atomic<id_type> next_id {0};
+};
+
+
+inline std::ostream& operator<<(std::ostream& os, const intern_pool::stats& st) {
+    return os << st.strings << " strings, " << st.text_bytes << " bytes of text in " << st.arena_bytes
+              << " bytes of arena + " << st.index_bytes << " bytes of index";
+}
+
+
+// the pool behind istring
+inline intern_pool& default_intern_pool() {
+    static intern_pool instance;
+    return instance;
+}
+
+
+/*
+ * An interned string: 4 bytes, trivially copyable, == and hashing on the id.
+ * Ordering compares the text, so sorted output stays alphabetical.
+ */
+class istring {
+public:
+    istring() noexcept = default;
+    istring(std::string_view s)
+    : id_(default_intern_pool().intern(s))
+    {}
+    istring(const std::string& s)
+    : istring(std::string_view(s))
+    {}
+    istring(const char* s)
+    : istring(std::string_view(s))
+    {}
+
+    static istring from_id(intern_pool::id_type id) noexcept {
+        istring s;
+        s.id_ = id;
+        return s;
+    }
+
+    intern_pool::id_type id() const noexcept { return id_; }
+    std::string_view view() const noexcept { return default_intern_pool().view(id_); }
+    std::string str() const { return std::string(view()); }
+    operator std::string_view() const noexcept { return view(); }
+    bool empty() const noexcept { return id_ == 0; }
+    std::size_t size() const noexcept { return view().size(); }
+
+    friend bool operator==(istring a, istring b) noexcept { return a.id_ == b.id_; }
+    friend bool operator!=(istring a, istring b) noexcept { return a.id_ != b.id_; }
+    friend bool operator<(istring a, istring b) noexcept { return a.view() < b.view(); }
+
+    friend std::ostream& operator<<(std::ostream& os, istring s) { return os << s.view(); }
+
+private:
+    intern_pool::id_type id_ = 0;
+};
+
+namespace std {
+    template<>
+    struct hash<istring> {
+        std::size_t operator()(istring s) const noexcept {
+            return std::hash<std::uint32_t>{}(s.id());
+        }
+    };
+}
+
+
+#endif //EFFECTIVECPP_INTERN_POOL_H
@@ -0,0 +1,75 @@
+#ifndef EFFECTIVECPP_INTERNED_MARKER_H
+#define EFFECTIVECPP_INTERNED_MARKER_H
+
+#include <utility>
+#include "utils.h"
+#include "intern_pool.h"
+
+
+/*
+ * Marker with an interned name (intern_pool.h): 4 bytes instead of a string, so
+ * copies never allocate and equal names compare as one integer. No virtual get(),
+ * unlike Marker: a vptr would quadruple the size.
+ * Logs like Marker and shares its print_enabled switch.
+ */
+class InternedMarker {
+public:
+    InternedMarker(istring x)
+    : x(x)
+    {}
+
+    InternedMarker(const InternedMarker& other) {
+        if (Marker::print_enabled)
+            LOG_INFO("copy-ctor ", x);
+        x = other.x;
+    };
+    InternedMarker& operator=(const InternedMarker& other) {
+        if (Marker::print_enabled)
+            LOG_INFO("copy-assign ", x);
+        x = other.x;
+        return *this;
+    };
+
+    InternedMarker(InternedMarker&& other) noexcept {
+        if (Marker::print_enabled)
+            LOG_INFO("move-ctor ", x);
+        x = std::exchange(other.x, moved_from());
+    };
+    InternedMarker& operator=(InternedMarker&& other) noexcept {
+        if (Marker::print_enabled)
+            LOG_INFO("move-assign ", x);
+        x = std::exchange(other.x, moved_from());
+        return *this;
+    };
+
+    ~InternedMarker() {
+        if (Marker::print_enabled)
+            LOG_INFO("dtor ", x);
+    };
+
+    string get() const { return x.str(); }
+    istring name() const noexcept { return x; }
+
+    friend bool operator==(const InternedMarker& a, const InternedMarker& b) noexcept { return a.x == b.x; }
+    friend bool operator!=(const InternedMarker& a, const InternedMarker& b) noexcept { return a.x != b.x; }
+
+protected:
+    istring x;
+
+private:
+    // interned once, so a move stays noexcept
+    static istring moved_from() noexcept {
+        static const istring name = "__MOVE_DESTROYED__";
+        return name;
+    }
+};
+
+namespace std {
+    template<>
+    struct hash<InternedMarker> {
+        size_t operator()(const InternedMarker& m) const noexcept { return hash<istring>{}(m.name()); }
+    };
+}
+
+
+#endif //EFFECTIVECPP_INTERNED_MARKER_H
@@ -0,0 +1,312 @@
+#ifndef EFFECTIVECPP_LOGGER_H
+#define EFFECTIVECPP_LOGGER_H
+
+/*
+ * Line logger with an optional background thread.
+ *
+ *   LOG_INFO("copy-ctor ", x);            // default logger, one line per call
+ *   LOG_TO(my_log, log_level::debug, a, b);
+ *
+ * The macros test the level first, so the arguments of a disabled call are never
+ * evaluated. Arguments are concatenated with operator<< and a '\n' is appended.
+ *
+ * Synchronous mode (the default): the line is formatted and written on the calling
+ * thread and the sink is flushed, byte for byte what `cout << ... << endl` printed,
+ * so example output keeps its order relative to plain cout.
+ *
+ * Asynchronous mode (set_async(true)): the call copies its arguments into a node and
+ * pushes it on a lock-free multi-producer single-consumer queue. A background thread
+ * formats, batches up to 64 KB per write and flushes the sink once per batch.
+ * flush() returns once every line logged before it has reached the sink, and
+ * set_async(false) or destroying the logger drains the queue first.
+ *   - arguments are copied (decayed): char* / const char* become std::string, while
+ *     char arrays (string literals) are kept as pointers and must outlive the flush
+ *   - formatting runs on a fresh ostream, so manipulators set on cout don't apply
+ */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "vector_like.h"
+
+
+enum class log_level { trace, debug, info, warn, error, off };
+
+
+class logger {
+public:
+    explicit logger(std::ostream& sink = std::cout, log_level level = log_level::info)
+    : sink(sink), min_level(level)
+    {}
+
+    ~logger() { set_async(false); }
+
+    logger(const logger&) = delete;
+    logger& operator=(const logger&) = delete;
+
+    bool enabled(log_level level) const noexcept {
+        return level >= min_level.load(std::memory_order_relaxed);
+    }
+    void set_level(log_level level) noexcept { min_level.store(level, std::memory_order_relaxed); }
+
+    bool is_async() const noexcept { return async.load(std::memory_order_acquire); }
+
+    /*
+     * Start or stop the background thread; stopping writes out everything queued.
+     * Switch while no other thread is logging, e.g. at the start and end of main.
+     */
+    void set_async(bool on) {
+        std::lock_guard<std::mutex> guard(mode_mutex);
+        if (on && !worker.joinable()) {
+            stopping.store(false);
+            worker = std::thread([this] { consume(); });
+            async.store(true, std::memory_order_release);
+        }
+        else if (!on && worker.joinable()) {
+            async.store(false, std::memory_order_release);
+            stopping.store(true);
+            wake();
+            worker.join();
+        }
+    }
+
+    // use the LOG_* macros instead, they skip argument evaluation for disabled levels
+    template<typename... Args>
+    void write(Args&&... args) {
+        if (is_async()) {
+            push(new message<stored_t<Args>...>(std::forward<Args>(args)...));
+        }
+        else {
+            std::lock_guard<std::mutex> guard(sink_mutex);
+            (sink << ... << args) << std::endl;
+        }
+    }
+
+    // block until every line logged before this call is written and the sink flushed
+    void flush() {
+        if (!is_async()) {
+            std::lock_guard<std::mutex> guard(sink_mutex);
+            sink.flush();
+            return;
+        }
+        auto* marker = new flush_marker;
+        auto done = marker->done.get_future();
+        push(marker);
+        done.wait();
+    }
+
+    // lines the background thread has written, for tests and benchmarks
+    std::size_t lines_written() const noexcept { return written.load(std::memory_order_relaxed); }
+
+private:
+    /***************** queued records *****************/
+    struct node {
+        virtual ~node() = default;
+        // append the formatted line to out; false for control nodes that carry no line
+        virtual bool format(std::ostream&) { return false; }
+        std::atomic<node*> next {nullptr};
+    };
+
+    template<typename... Ts>
+    struct message : node {
+        template<typename... Args>
+        explicit message(Args&&... args)
+        : args(std::forward<Args>(args)...)
+        {}
+        bool format(std::ostream& os) override {
+            std::apply([&os](const auto&... a) { (os << ... << a) << '\n'; }, args);
+            return true;
+        }
+        std::tuple<Ts...> args;
+    };
+
+    struct flush_marker : node {
+        std::promise<void> done;
+    };
+
+    // string literals stay pointers, any other char pointer is copied because it may dangle
+    template<typename T>
+    using stored_t = std::conditional_t<
+        !std::is_array_v<std::remove_reference_t<T>>
+            && (std::is_same_v<std::decay_t<T>, char*> || std::is_same_v<std::decay_t<T>, const char*>),
+        std::string,
+        std::decay_t<T>>;
+
+    /*
+     * Vyukov's intrusive MPSC queue: producers swap themselves into `head` with one
+     * atomic exchange and then link the previous node, the single consumer walks from
+     * `tail`. A producer preempted between the two steps hides later nodes for a
+     * moment; the consumer just sees "empty" and comes back.
+     */
+    void push(node* n) {
+        n->next.store(nullptr, std::memory_order_relaxed);
+        node* prev = head.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+        if (consumer_sleeping.load()) {
+            wake();
+        }
+    }
+
+    node* pop() {
+        node* t = tail;
+        node* next = t->next.load(std::memory_order_acquire);
+        if (t == &stub) {
+            if (!next) {
+                return nullptr;
+            }
+            tail = next;
+            t = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail = next;
+            return t;
+        }
+        if (t != head.load(std::memory_order_acquire)) {
+            return nullptr;  // a producer is between its exchange and its link
+        }
+        push_stub();
+        next = t->next.load(std::memory_order_acquire);
+        if (next) {
+            tail = next;
+            return t;
+        }
+        return nullptr;
+    }
+
+    void push_stub() {
+        stub.next.store(nullptr, std::memory_order_relaxed);
+        node* prev = head.exchange(&stub, std::memory_order_acq_rel);
+        prev->next.store(&stub, std::memory_order_release);
+    }
+
+    bool queue_empty() const {
+        return tail->next.load(std::memory_order_acquire) == nullptr
+            && head.load(std::memory_order_acquire) == tail;
+    }
+
+    void wake() {
+        std::lock_guard<std::mutex> guard(sleep_mutex);
+        wakeup.notify_one();
+    }
+
+    /***************** background thread *****************/
+    // appends to a std::string, so the consumer formats with a plain ostream and no copies
+    class string_buf : public std::streambuf {
+    public:
+        std::string data;
+    protected:
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            data.append(s, static_cast<std::size_t>(n));
+            return n;
+        }
+        int_type overflow(int_type c) override {
+            if (c != traits_type::eof()) {
+                data.push_back(static_cast<char>(c));
+            }
+            return c;
+        }
+    };
+
+    void consume() {
+        static constexpr std::size_t BATCH_BYTES = 1 << 16;
+        string_buf buf;
+        std::ostream out(&buf);
+        std::size_t lines = 0;
+        auto write_batch = [&] {
+            if (!buf.data.empty()) {
+                sink.write(buf.data.data(), static_cast<std::streamsize>(buf.data.size()));
+                sink.flush();
+                buf.data.clear();
+                written.fetch_add(lines, std::memory_order_relaxed);
+                lines = 0;
+            }
+        };
+
+        while (true) {
+            bool got_any = false;
+            while (node* n = pop()) {
+                got_any = true;
+                if (n->format(out)) {
+                    ++lines;
+                }
+                else if (auto* marker = dynamic_cast<flush_marker*>(n)) {
+                    write_batch();
+                    marker->done.set_value();
+                }
+                delete n;
+                if (buf.data.size() >= BATCH_BYTES) {
+                    write_batch();
+                }
+            }
+            write_batch();
+            if (got_any) {
+                continue;
+            }
+            if (stopping.load()) {
+                if (queue_empty()) {
+                    return;
+                }
+                std::this_thread::yield();  // a producer is mid-push, let it link
+                continue;
+            }
+            // sleeping is published before the emptiness check, push() checks it after linking
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            consumer_sleeping.store(true);
+            if (queue_empty()) {
+                wakeup.wait_for(lock, std::chrono::milliseconds(50));
+            }
+            consumer_sleeping.store(false);
+        }
+    }
+
+    std::ostream& sink;
+    std::atomic<log_level> min_level;
+
+    node stub;
+    std::atomic<node*> head {&stub};
+    node* tail = &stub;  // consumer only
+
+    std::thread worker;
+    std::mutex mode_mutex;
+    std::mutex sink_mutex;
+    std::mutex sleep_mutex;
+    std::condition_variable wakeup;
+    std::atomic<bool> async {false};
+    std::atomic<bool> stopping {false};
+    std::atomic<bool> consumer_sleeping {false};
+    std::atomic<std::size_t> written {0};
+};
+
+
+// the logger behind LOG_INFO and friends, writes to cout
+inline logger& default_logger() {
+    static logger instance;
+    return instance;
+}
+
+
+#define LOG_TO(lg, level, ...)                  \
+    do {                                        \
+        if ((lg).enabled(level)) {              \
+            (lg).write(__VA_ARGS__);            \
+        }                                       \
+    } while (0)
+
+#define LOG_TRACE(...) LOG_TO(default_logger(), log_level::trace, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_TO(default_logger(), log_level::debug, __VA_ARGS__)
+#define LOG_INFO(...)  LOG_TO(default_logger(), log_level::info, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_TO(default_logger(), log_level::warn, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_TO(default_logger(), log_level::error, __VA_ARGS__)
+
+
+#endif //EFFECTIVECPP_LOGGER_H
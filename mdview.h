@@ -0,0 +1,284 @@
+#ifndef EFFECTIVECPP_MDVIEW_H
+#define EFFECTIVECPP_MDVIEW_H
+
+/*
+ * view<T, Extents, Layout, CheckPolicy>: a non-owning multidimensional view,
+ * a stripped down C++23 std::mdspan.
+ * - Extents: extents<3, dynamic_extent> mixes compile-time and runtime sizes
+ * - Layout: layout_right (row-major, C), layout_left (column-major, Fortran), layout_stride
+ * - CheckPolicy: unchecked, assert_checked or throw_checked, chosen at compile time.
+ *   With `unchecked` operator() is exactly ptr[offset], nothing else survives inlining.
+ */
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+
+constexpr std::size_t dynamic_extent = std::numeric_limits<std::size_t>::max();
+
+
+/*
+ * very cool hack to get array size at compile time (from item 1)
+ */
+template<typename T, std::size_t N>
+constexpr std::size_t array_size(const T (&)[N]) noexcept {
+    return N;
+}
+
+
+template<std::size_t... Es>
+class extents {
+public:
+    static_assert(sizeof...(Es) > 0, "rank 0 views are not supported");
+
+    static constexpr std::size_t rank() noexcept { return sizeof...(Es); }
+    static constexpr std::size_t rank_dynamic() noexcept {
+        return ((Es == dynamic_extent ? 1 : 0) + ...);
+    }
+    static constexpr std::size_t static_extent(std::size_t r) noexcept {
+        constexpr std::size_t es[] = {Es...};
+        return es[r];
+    }
+
+    constexpr extents() noexcept = default;
+
+    // one argument per dynamic extent, in order
+    template<typename... Dyn, typename = std::enable_if_t<sizeof...(Dyn) == rank_dynamic() && (sizeof...(Dyn) > 0)>>
+    constexpr explicit extents(Dyn... dyn) noexcept
+    : dyn_sizes{static_cast<std::size_t>(dyn)...}
+    {}
+
+    constexpr std::size_t extent(std::size_t r) const noexcept {
+        if (static_extent(r) != dynamic_extent) {
+            return static_extent(r);
+        }
+        return dyn_sizes[dynamic_index(r)];
+    }
+
+    constexpr std::size_t size() const noexcept {
+        std::size_t n = 1;
+        for (std::size_t r = 0; r < rank(); ++r) {
+            n *= extent(r);
+        }
+        return n;
+    }
+
+private:
+    // position of extent r among the dynamic ones
+    static constexpr std::size_t dynamic_index(std::size_t r) noexcept {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < r; ++i) {
+            n += static_extent(i) == dynamic_extent;
+        }
+        return n;
+    }
+
+    std::array<std::size_t, rank_dynamic()> dyn_sizes {};
+};
+
+
+// extents<dynamic_extent, ...> with `Rank` dynamic sizes
+template<std::size_t Rank, typename = std::make_index_sequence<Rank>>
+struct _dextents_helper;
+template<std::size_t Rank, std::size_t... Is>
+struct _dextents_helper<Rank, std::index_sequence<Is...>> {
+    using type = extents<((void) Is, dynamic_extent)...>;
+};
+template<std::size_t Rank>
+using dextents = typename _dextents_helper<Rank>::type;
+
+
+/***************** layouts *****************/
+
+// row-major: the last index is contiguous
+struct layout_right {
+    template<typename Extents>
+    class mapping {
+    public:
+        constexpr mapping(const Extents& ext) noexcept : ext(ext) {}
+
+        template<typename... I>
+        constexpr std::size_t operator()(I... idx) const noexcept {
+            const std::size_t is[] = {static_cast<std::size_t>(idx)...};
+            std::size_t offset = is[0];
+            for (std::size_t r = 1; r < Extents::rank(); ++r) {
+                offset = offset * ext.extent(r) + is[r];
+            }
+            return offset;
+        }
+
+        constexpr std::size_t required_span_size() const noexcept { return ext.size(); }
+        constexpr const Extents& extents() const noexcept { return ext; }
+
+    private:
+        Extents ext;
+    };
+};
+
+// column-major: the first index is contiguous
+struct layout_left {
+    template<typename Extents>
+    class mapping {
+    public:
+        constexpr mapping(const Extents& ext) noexcept : ext(ext) {}
+
+        template<typename... I>
+        constexpr std::size_t operator()(I... idx) const noexcept {
+            const std::size_t is[] = {static_cast<std::size_t>(idx)...};
+            constexpr std::size_t last = Extents::rank() - 1;
+            std::size_t offset = is[last];
+            for (std::size_t r = last; r-- > 0; ) {
+                offset = offset * ext.extent(r) + is[r];
+            }
+            return offset;
+        }
+
+        constexpr std::size_t required_span_size() const noexcept { return ext.size(); }
+        constexpr const Extents& extents() const noexcept { return ext; }
+
+    private:
+        Extents ext;
+    };
+};
+
+// arbitrary strides in elements, e.g. every other column or a sub-block
+struct layout_stride {
+    template<typename Extents>
+    class mapping {
+    public:
+        using strides_type = std::array<std::size_t, Extents::rank()>;
+
+        constexpr mapping(const Extents& ext, const strides_type& strides) noexcept
+        : ext(ext), strides(strides)
+        {}
+
+        template<typename... I>
+        constexpr std::size_t operator()(I... idx) const noexcept {
+            const std::size_t is[] = {static_cast<std::size_t>(idx)...};
+            std::size_t offset = 0;
+            for (std::size_t r = 0; r < Extents::rank(); ++r) {
+                offset += is[r] * strides[r];
+            }
+            return offset;
+        }
+
+        constexpr std::size_t required_span_size() const noexcept {
+            std::size_t last = 0;
+            for (std::size_t r = 0; r < Extents::rank(); ++r) {
+                if (ext.extent(r) == 0) {
+                    return 0;
+                }
+                last += (ext.extent(r) - 1) * strides[r];
+            }
+            return last + 1;
+        }
+        constexpr const Extents& extents() const noexcept { return ext; }
+        constexpr std::size_t stride(std::size_t r) const noexcept { return strides[r]; }
+
+    private:
+        Extents ext;
+        strides_type strides;
+    };
+};
+
+
+/***************** bounds-check policies *****************/
+
+struct unchecked {
+    static constexpr void check(std::size_t, std::size_t, std::size_t) noexcept {}
+};
+
+// free in Release (NDEBUG), aborts in Debug
+struct assert_checked {
+    static constexpr void check(std::size_t i, std::size_t extent, std::size_t) noexcept {
+        assert(i < extent && "view index out of range");
+        (void) i; (void) extent;
+    }
+};
+
+struct throw_checked {
+    static void check(std::size_t i, std::size_t extent, std::size_t dim) {
+        if (i >= extent) {
+            throw std::out_of_range("view index " + std::to_string(i) + " out of range for extent "
+                                    + std::to_string(extent) + " in dimension " + std::to_string(dim));
+        }
+    }
+};
+
+
+template<typename T, typename Extents, typename Layout = layout_right, typename CheckPolicy = unchecked>
+class view {
+public:
+    using element_type = T;
+    using extents_type = Extents;
+    using layout_type = Layout;
+    using mapping_type = typename Layout::template mapping<Extents>;
+
+    constexpr view(T* ptr, const Extents& ext) noexcept
+    : ptr(ptr), map(ext)
+    {}
+    constexpr view(T* ptr, const mapping_type& map) noexcept
+    : ptr(ptr), map(map)
+    {}
+
+    static constexpr std::size_t rank() noexcept { return Extents::rank(); }
+    constexpr std::size_t extent(std::size_t r) const noexcept { return map.extents().extent(r); }
+    constexpr std::size_t size() const noexcept { return map.extents().size(); }
+    constexpr const Extents& extents() const noexcept { return map.extents(); }
+    constexpr const mapping_type& mapping() const noexcept { return map; }
+    constexpr T* data() const noexcept { return ptr; }
+
+    template<typename... I>
+    constexpr T& operator()(I... idx) const noexcept(std::is_same_v<CheckPolicy, unchecked>) {
+        static_assert(sizeof...(I) == rank(), "need exactly one index per dimension");
+        if constexpr (!std::is_same_v<CheckPolicy, unchecked>) {
+            std::size_t r = 0;
+            ((CheckPolicy::check(static_cast<std::size_t>(idx), extent(r), r), ++r), ...);
+        }
+        return ptr[map(idx...)];
+    }
+
+    constexpr T& operator[](std::size_t i) const noexcept(std::is_same_v<CheckPolicy, unchecked>) {
+        static_assert(rank() == 1, "operator[] is only for rank 1 views, use operator()");
+        return (*this)(i);
+    }
+
+    // same memory and shape, different bounds checking
+    template<typename NewPolicy>
+    constexpr view<T, Extents, Layout, NewPolicy> with_policy() const noexcept {
+        return {ptr, map};
+    }
+
+private:
+    T* ptr;
+    mapping_type map;
+};
+
+
+/*
+ * C arrays carry their extents in the type (the array_size trick, one level deeper),
+ * so the view is fully static
+ */
+template<typename CheckPolicy = unchecked, typename T, std::size_t N>
+constexpr auto make_view(T (&arr)[N]) noexcept {
+    return view<T, extents<N>, layout_right, CheckPolicy>(arr, extents<N>{});
+}
+
+template<typename CheckPolicy = unchecked, typename T, std::size_t R, std::size_t C>
+constexpr auto make_view(T (&arr)[R][C]) noexcept {
+    return view<T, extents<R, C>, layout_right, CheckPolicy>(&arr[0][0], extents<R, C>{});
+}
+
+// runtime-sized matrix over a flat buffer
+template<typename Layout = layout_right, typename CheckPolicy = unchecked, typename T>
+constexpr auto make_matrix_view(T* ptr, std::size_t rows, std::size_t cols) noexcept {
+    return view<T, dextents<2>, Layout, CheckPolicy>(ptr, dextents<2>(rows, cols));
+}
+
+
+#endif //EFFECTIVECPP_MDVIEW_H
@@ -0,0 +1,484 @@
+#ifndef EFFECTIVECPP_MEMOIZE_H
+#define EFFECTIVECPP_MEMOIZE_H
+
+/*
+ * Memoization of pure functions behind a sharded, thread-safe LRU cache.
+ *
+ *   auto fmt = memoize<const Fish&>([](const Fish& f) { return any_str(f); });
+ *   fmt(Fish{"nemo"});                    // computed
+ *   fmt(Fish{"nemo"});                    // from the cache
+ *   fmt.stats();                          // hits, misses, evictions, bytes held
+ *
+ *   lru_cache<string, int> cache({64 << 10});             // 64 KB, 16 shards
+ *   cache.get_or_compute("key", [] { return 42; });
+ *
+ * The key is the tuple of the decayed arguments, hashed member by member like
+ * fast_hash (hana_hash.h) unless another hash is given (memoize_with). Keys are split over
+ * shards by hash, each shard an LRU list plus a flat_hash_map behind its own
+ * mutex: a hit locks one shard, moves the entry to the front and copies the value
+ * out. A miss computes outside the lock, so a slow call never blocks the shard;
+ * two threads missing on the same key both compute it and the first insert wins.
+ *
+ * Capacity is in bytes, split evenly between the shards. An entry costs its key
+ * and value (sizeof plus the heap buffers of strings, vectors, tuples and hana
+ * Structs of those), the list node and the index slot; entries bigger than a
+ * shard are returned but not kept. With a ttl, entries older than it count as
+ * misses and are dropped when looked up; without one the clock is never read.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/hana.hpp>
+#include "flat_hash_map.h"
+#include "hana_hash.h"
+
+namespace hana = boost::hana;
+
+
+struct cache_options {
+    std::size_t capacity_bytes = 1 << 20;           // the whole cache, all shards together
+    std::size_t shards = 16;
+    std::chrono::steady_clock::duration ttl {};     // zero: entries never expire
+};
+
+struct cache_stats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;     // dropped to make room
+    std::size_t expirations = 0;   // dropped because of the ttl
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+    double hit_rate() const noexcept { return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const cache_stats& st) {
+    return os << st.hits << " hits, " << st.misses << " misses, " << st.evictions << " evictions, "
+              << st.expirations << " expired, " << st.entries << " entries in " << st.bytes << " bytes";
+}
+
+
+namespace memoize_detail {
+    template<typename T>
+    struct is_basic_string : std::false_type {};
+    template<typename C, typename Tr, typename A>
+    struct is_basic_string<std::basic_string<C, Tr, A>> : std::true_type {};
+
+    template<typename T>
+    struct is_vector : std::false_type {};
+    template<typename E, typename A>
+    struct is_vector<std::vector<E, A>> : std::true_type {};
+
+    // bytes x owns outside of itself; types it can't see into count as sizeof only
+    template<typename T>
+    std::size_t heap_bytes(const T& x) noexcept {
+        if constexpr (is_basic_string<T>::value) {
+            auto data = reinterpret_cast<const unsigned char*>(x.data());
+            auto self = reinterpret_cast<const unsigned char*>(&x);
+            bool small = data >= self && data < self + sizeof(T);  // short string in the object itself
+            return small ? 0 : (x.capacity() + 1) * sizeof(typename T::value_type);
+        }
+        else if constexpr (std::is_trivially_copyable_v<T>) {
+            return 0;
+        }
+        else if constexpr (is_vector<T>::value) {
+            std::size_t n = x.capacity() * sizeof(typename T::value_type);
+            for (const auto& e : x) {
+                n += heap_bytes(e);
+            }
+            return n;
+        }
+        else if constexpr (is_std_tuple<T>::value) {
+            return std::apply([](const auto&... m) { return (std::size_t{0} + ... + heap_bytes(m)); }, x);
+        }
+        else if constexpr (hana::Struct<T>::value) {
+            std::size_t n = 0;
+            hana::for_each(hana::accessors<T>(), [&](auto acc) { n += heap_bytes(hana::second(acc)(x)); });
+            return n;
+        }
+        else {
+            return 0;
+        }
+    }
+}
+
+
+/*
+ * The default fast_hash / fast_equal compare keys with ==: 0.0 and -0.0 share an
+ * entry and a NaN key never hits. For floating-point keys where that matters pass
+ * memo_key_hash / memo_key_equal, which memoize uses.
+ */
+template<typename K, typename V, typename Hash = fast_hash<K>, typename KeyEqual = fast_equal<K>>
+class lru_cache {
+public:
+    explicit lru_cache(cache_options opts = {})
+    : options(opts),
+      num_shards(opts.shards ? opts.shards : 1),
+      shards(new shard[num_shards]) {
+        for (std::size_t i = 0; i < num_shards; ++i) {
+            shards[i].capacity = options.capacity_bytes / num_shards;
+        }
+    }
+
+    lru_cache(const lru_cache&) = delete;
+    lru_cache& operator=(const lru_cache&) = delete;
+
+    // a copy of the cached value, counting a hit or a miss; with transparent
+    // Hash and KeyEqual, key can be anything they take
+    template<typename Q = K>
+    std::optional<V> get(const Q& key) {
+        shard& sh = shard_for(key);
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        const entry* e = sh.lookup(key, options.ttl);
+        return e ? std::optional<V>(e->value) : std::nullopt;
+    }
+
+    // insert or replace key, evicting from the cold end of its shard
+    void put(K key, V value) {
+        shard& sh = shard_for(key);
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        sh.insert(std::move(key), std::move(value), options.ttl, true);
+    }
+
+    // the cached value of key, or make() stored under K(key); make runs without the lock held
+    template<typename Q, typename Make>
+    V get_or_compute(const Q& key, Make&& make) {
+        shard& sh = shard_for(key);
+        {
+            std::lock_guard<std::mutex> lock(sh.mutex);
+            if (const entry* e = sh.lookup(key, options.ttl)) {
+                return e->value;
+            }
+        }
+        V value = std::forward<Make>(make)();
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        sh.insert(K(key), value, options.ttl, false);
+        return value;
+    }
+
+    bool erase(const K& key) {
+        shard& sh = shard_for(key);
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        auto it = sh.index.find(key);
+        if (it == sh.index.end()) {
+            return false;
+        }
+        sh.remove(it->second);
+        return true;
+    }
+
+    // drops every entry, keeps the counters
+    void clear() {
+        for (std::size_t i = 0; i < num_shards; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            shards[i].index.clear();
+            shards[i].lru.clear();
+            shards[i].bytes = 0;
+        }
+    }
+
+    cache_stats stats() const {
+        cache_stats st;
+        for (std::size_t i = 0; i < num_shards; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            st.hits += shards[i].counts.hits;
+            st.misses += shards[i].counts.misses;
+            st.evictions += shards[i].counts.evictions;
+            st.expirations += shards[i].counts.expirations;
+            st.entries += shards[i].lru.size();
+            st.bytes += shards[i].bytes;
+        }
+        return st;
+    }
+
+    const cache_options& config() const noexcept { return options; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct entry {
+        K key;
+        V value;
+        std::size_t bytes;
+        clock::time_point expires;
+    };
+    using list_type = std::list<entry>;
+    using index_type = flat_hash_map<K, typename list_type::iterator, Hash, KeyEqual>;
+
+    // the entry, its list node and its index slot (which holds a second copy of the key)
+    static std::size_t entry_bytes(const K& key, const V& value) noexcept {
+        return sizeof(entry) + 2 * sizeof(void*) + sizeof(typename index_type::value_type) + 1
+               + 2 * memoize_detail::heap_bytes(key) + memoize_detail::heap_bytes(value);
+    }
+
+    struct alignas(64) shard {
+        mutable std::mutex mutex;
+        list_type lru;       // most recently used first
+        index_type index;
+        std::size_t bytes = 0;
+        std::size_t capacity = 0;
+        cache_stats counts;
+
+        template<typename Q>
+        const entry* lookup(const Q& key, clock::duration ttl) {
+            auto it = index.find(key);
+            if (it == index.end()) {
+                ++counts.misses;
+                return nullptr;
+            }
+            auto node = it->second;
+            if (ttl != clock::duration::zero() && clock::now() >= node->expires) {
+                remove(node);
+                ++counts.expirations;
+                ++counts.misses;
+                return nullptr;
+            }
+            lru.splice(lru.begin(), lru, node);
+            ++counts.hits;
+            return &*node;
+        }
+
+        void insert(K key, V value, clock::duration ttl, bool replace) {
+            auto it = index.find(key);
+            if (it != index.end()) {
+                if (!replace) {
+                    return;  // another thread computed it meanwhile
+                }
+                remove(it->second);
+            }
+            std::size_t size = entry_bytes(key, value);
+            if (size > capacity) {
+                return;
+            }
+            auto expires = ttl != clock::duration::zero() ? clock::now() + ttl : clock::time_point{};
+            lru.push_front(entry{std::move(key), std::move(value), size, expires});
+            index.try_emplace(lru.front().key, lru.begin());
+            bytes += size;
+            while (bytes > capacity) {
+                remove(std::prev(lru.end()));
+                ++counts.evictions;
+            }
+        }
+
+        void remove(typename list_type::iterator node) {
+            bytes -= node->bytes;
+            index.erase(node->key);
+            lru.erase(node);
+        }
+    };
+
+    template<typename Q>
+    shard& shard_for(const Q& key) noexcept {
+        std::size_t h = Hash{}(key);
+        return shards[(h >> 32) % num_shards];
+    }
+
+    cache_options options;
+    std::size_t num_shards;
+    std::unique_ptr<shard[]> shards;
+};
+
+
+namespace memoize_detail {
+    template<typename T>
+    constexpr bool has_floating_point() noexcept;
+
+    template<typename... Ts>
+    constexpr bool any_floating_point(const std::tuple<Ts...>*) noexcept {
+        return (has_floating_point<std::decay_t<Ts>>() || ...);
+    }
+    template<typename A, typename B>
+    constexpr bool any_floating_point(const std::pair<A, B>*) noexcept {
+        return has_floating_point<std::decay_t<A>>() || has_floating_point<std::decay_t<B>>();
+    }
+
+    // floating point anywhere inside T: in members, tuple elements or range elements
+    template<typename T>
+    constexpr bool has_floating_point() noexcept {
+        if constexpr (std::is_floating_point_v<T>) {
+            return true;
+        }
+        else if constexpr (hana::Struct<T>::value) {
+            return hana::unpack(hana::accessors<T>(), [](auto... acc) {
+                return (has_floating_point<std::decay_t<decltype(hana::second(acc)(std::declval<const T&>()))>>()
+                        || ... || false);
+            });
+        }
+        else if constexpr (is_std_tuple<T>::value) {
+            return any_floating_point(static_cast<const T*>(nullptr));
+        }
+        else if constexpr (decltype(is_range(std::declval<const T&>()))::value) {
+            return has_floating_point<std::decay_t<decltype(*std::begin(std::declval<const T&>()))>>();
+        }
+        else {
+            return false;
+        }
+    }
+
+    /*
+     * A memo key means "the same input to f", which == doesn't give for floating
+     * point: 0.0 == -0.0 although 1 / x differs, and NaN != NaN. Floats are told
+     * apart by value and sign, with every NaN one key; everything without a float
+     * inside goes to hash_value / equal_value as is.
+     */
+    template<typename T>
+    std::uint64_t key_hash(const T& x, std::uint64_t seed) noexcept {
+        if constexpr (is_std_tuple<T>::value) {
+            // element by element, so a tuple of references hashes like the tuple of values
+            std::apply([&](const auto&... m) { ((seed = key_hash(m, seed)), ...); }, x);
+            return seed;
+        }
+        else if constexpr (!has_floating_point<T>()) {
+            return hash_value(x, seed);
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            if (x != x) {
+                return wyhash_word(~std::uint64_t{0}, seed);
+            }
+            return wyhash_word(std::signbit(x), hash_value(x, seed));
+        }
+        else if constexpr (hana::Struct<T>::value) {
+            hana::for_each(hana::accessors<T>(), [&](auto acc) { seed = key_hash(hana::second(acc)(x), seed); });
+            return seed;
+        }
+        else {
+            std::uint64_t n = 0;
+            for (const auto& e : x) {
+                seed = key_hash(e, seed);
+                ++n;
+            }
+            return wyhash_word(n, seed);
+        }
+    }
+
+    template<typename A, typename B>
+    bool key_equal(const A& a, const B& b) noexcept {
+        if constexpr (is_std_tuple<A>::value && is_std_tuple<B>::value) {
+            return std::apply([&](const auto&... x) {
+                return std::apply([&](const auto&... y) { return (key_equal(x, y) && ...); }, b);
+            }, a);
+        }
+        else if constexpr (!std::is_same_v<A, B>) {
+            return a == b;
+        }
+        else if constexpr (!has_floating_point<A>()) {
+            return equal_value(a, b);
+        }
+        else if constexpr (std::is_floating_point_v<A>) {
+            return a != a ? b != b : a == b && std::signbit(a) == std::signbit(b);
+        }
+        else if constexpr (hana::Struct<A>::value) {
+            bool eq = true;
+            hana::for_each(hana::accessors<A>(), [&](auto acc) {
+                eq = eq && key_equal(hana::second(acc)(a), hana::second(acc)(b));
+            });
+            return eq;
+        }
+        else {
+            return std::equal(std::begin(a), std::end(a), std::begin(b), std::end(b),
+                              [](const auto& x, const auto& y) { return key_equal(x, y); });
+        }
+    }
+}
+
+/*
+ * Hash and equality of argument tuples, member by member like fast_hash / fast_equal
+ * except for floating point (see key_hash). Transparent: a tuple of references
+ * to the arguments finds the entry stored under the tuple of their copies, so a
+ * hit copies nothing but the result.
+ */
+struct memo_key_hash {
+    using is_transparent = void;
+    template<typename K>
+    std::size_t operator()(const K& key) const noexcept {
+        return static_cast<std::size_t>(memoize_detail::key_hash(key, 0));
+    }
+};
+
+struct memo_key_equal {
+    using is_transparent = void;
+    template<typename A, typename B>
+    bool operator()(const A& a, const B& b) const noexcept {
+        return memoize_detail::key_equal(a, b);
+    }
+};
+
+
+/*
+ * f behind an lru_cache keyed on its arguments. f must be pure: same arguments,
+ * same result, no side effects worth repeating.
+ */
+template<typename F, typename Key, typename Hash = memo_key_hash, typename KeyEqual = memo_key_equal>
+class memoized;
+
+template<typename F, typename... Args, typename Hash, typename KeyEqual>
+class memoized<F, std::tuple<Args...>, Hash, KeyEqual> {
+public:
+    using key_type = std::tuple<Args...>;
+    using result_type = std::decay_t<std::invoke_result_t<const F&, const Args&...>>;
+
+    explicit memoized(F f, cache_options opts = {})
+    : fn(std::move(f)), cache(opts) {}
+
+    template<typename... A>
+    result_type operator()(A&&... args) const {
+        if constexpr (by_reference<A...>()) {
+            std::tuple<const Args&...> key(args...);
+            return cache.get_or_compute(key, [&] { return std::apply(fn, key); });
+        }
+        else {
+            key_type key(std::forward<A>(args)...);
+            return cache.get_or_compute(key, [&] { return std::apply(fn, key); });
+        }
+    }
+
+    cache_stats stats() const { return cache.stats(); }
+    void clear() const { cache.clear(); }
+
+    // uncached, for comparison
+    const F& function() const noexcept { return fn; }
+
+private:
+    // the arguments are exactly the key's types (no conversion, so no temporary to
+    // dangle) and the hash and equality take reference tuples
+    template<typename... A>
+    static constexpr bool by_reference() noexcept {
+        if constexpr (sizeof...(A) != sizeof...(Args)) {
+            return false;
+        }
+        else {
+            return (std::is_same_v<std::decay_t<A>, Args> && ...)
+                && std::is_same_v<Hash, memo_key_hash> && std::is_same_v<KeyEqual, memo_key_equal>;
+        }
+    }
+
+    F fn;
+    mutable lru_cache<key_type, result_type, Hash, KeyEqual> cache;
+};
+
+// memoize<const string&, int>(f): f(const string&, int) with a cache keyed on (string, int)
+template<typename... Args, typename F>
+memoized<F, std::tuple<std::decay_t<Args>...>> memoize(F f, cache_options opts = {}) {
+    return memoized<F, std::tuple<std::decay_t<Args>...>>(std::move(f), opts);
+}
+
+// the same with another hash over std::tuple<decayed Args...>, which then gets copied on every call
+template<typename Hash, typename... Args, typename F>
+memoized<F, std::tuple<std::decay_t<Args>...>, Hash> memoize_with(F f, cache_options opts = {}) {
+    return memoized<F, std::tuple<std::decay_t<Args>...>, Hash>(std::move(f), opts);
+}
+
+
+#endif //EFFECTIVECPP_MEMOIZE_H
@@ -0,0 +1,145 @@
+#ifndef EFFECTIVECPP_PARALLEL_REDUCE_H
+#define EFFECTIVECPP_PARALLEL_REDUCE_H
+
+/*
+ * parallel_reduce: the runtime-range version of the left_sum / right_sum folds in
+ * cpp17_fold.cpp, split across a thread_pool.
+ *
+ *   auto total = parallel_reduce(pool, values, std::plus<>{});          // range must not be empty
+ *   auto text  = parallel_reduce(pool, words, string{}, concat);        // with an initial value
+ *
+ * The range is cut into consecutive chunks, every chunk is left-folded on its own,
+ * and the chunk results are folded left to right on the calling thread:
+ *     init op (x0 op x1 op ... op xk) op (xk+1 op ...) op ...
+ * Nothing is ever swapped, so any associative op gives exactly the sequential
+ * result, commutative or not (string concatenation, matrix products). Only the
+ * bracketing changes, which shows for ops that are not associative: Elem prints
+ * its brackets.
+ *
+ * std::plus / std::multiplies on arithmetic values in contiguous memory take a
+ * lane path instead: 8 independent accumulators per chunk, which the compiler turns
+ * into SIMD adds. That reassociates, so integers come out exact and floating point
+ * sums round like std::reduce, not like std::accumulate.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "thread_pool.h"
+
+
+namespace parallel_reduce_detail {
+    template<typename It, typename T>
+    constexpr bool is_contiguous_v = std::is_pointer_v<It>
+        || std::is_same_v<It, typename std::vector<T>::iterator>
+        || std::is_same_v<It, typename std::vector<T>::const_iterator>;
+
+    // + or * on an arithmetic type that doesn't promote (char + char is an int)
+    template<typename Op, typename T, typename = void>
+    constexpr bool is_lane_op_v = false;
+    template<typename Op, typename T>
+    constexpr bool is_lane_op_v<Op, T, std::enable_if_t<std::is_arithmetic_v<T>>> =
+        std::is_same_v<decltype(std::declval<Op&>()(std::declval<T>(), std::declval<T>())), T>
+        && (std::is_same_v<Op, std::plus<>> || std::is_same_v<Op, std::plus<T>>
+            || std::is_same_v<Op, std::multiplies<>> || std::is_same_v<Op, std::multiplies<T>>);
+
+    // fold of [first, last), which is not empty
+    template<typename It, typename Op>
+    auto fold_chunk(It first, It last, Op& op) {
+        using T = typename std::iterator_traits<It>::value_type;
+        if constexpr (is_contiguous_v<It, T> && is_lane_op_v<Op, T>) {
+            constexpr std::size_t LANES = 8;
+            const T* p = &*first;
+            auto n = static_cast<std::size_t>(last - first);
+            if (n >= 2 * LANES) {
+                T lanes[LANES];
+                std::copy(p, p + LANES, lanes);
+                std::size_t i = LANES;
+                for (; i + LANES <= n; i += LANES) {
+                    for (std::size_t l = 0; l < LANES; ++l) {
+                        lanes[l] = op(lanes[l], p[i + l]);
+                    }
+                }
+                T acc = lanes[0];
+                for (std::size_t l = 1; l < LANES; ++l) {
+                    acc = op(acc, lanes[l]);
+                }
+                for (; i < n; ++i) {
+                    acc = op(acc, p[i]);
+                }
+                return acc;
+            }
+        }
+        auto acc = static_cast<std::decay_t<decltype(op(*first, *first))>>(*first);
+        for (++first; first != last; ++first) {
+            acc = op(std::move(acc), *first);
+        }
+        return acc;
+    }
+}
+
+
+/*
+ * Fold of the non-empty range [first, last) with op, chunked across the pool.
+ * grain = 0 cuts about 4 chunks per worker.
+ */
+template<typename It, typename Op>
+auto parallel_reduce(thread_pool& pool, It first, It last, Op op, std::size_t grain = 0) {
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                    typename std::iterator_traits<It>::iterator_category>,
+                  "parallel_reduce needs random access iterators");
+    using R = std::decay_t<decltype(parallel_reduce_detail::fold_chunk(first, last, op))>;
+    auto n = static_cast<std::size_t>(std::distance(first, last));
+    if (n == 0) {
+        throw std::invalid_argument("parallel_reduce of an empty range needs an initial value");
+    }
+    if (grain == 0) {
+        std::size_t chunks = 4 * static_cast<std::size_t>(pool.size());
+        grain = (n + chunks - 1) / chunks;
+    }
+    std::size_t chunks = (n + grain - 1) / grain;
+    if (chunks == 1) {
+        return parallel_reduce_detail::fold_chunk(first, last, op);
+    }
+
+    // optional: R need not be default constructible (Elem isn't)
+    std::vector<std::optional<R>> partial(chunks);
+    pool.parallel_for(std::size_t{0}, chunks, [&](std::size_t c) {
+        auto begin = first + static_cast<std::ptrdiff_t>(c * grain);
+        auto end = first + static_cast<std::ptrdiff_t>(std::min(n, (c + 1) * grain));
+        partial[c].emplace(parallel_reduce_detail::fold_chunk(begin, end, op));
+    }, 1);
+
+    R result = std::move(*partial[0]);
+    for (std::size_t c = 1; c < chunks; ++c) {
+        result = op(std::move(result), std::move(*partial[c]));
+    }
+    return result;
+}
+
+template<typename It, typename T, typename Op>
+T parallel_reduce(thread_pool& pool, It first, It last, T init, Op op, std::size_t grain = 0) {
+    if (first == last) {
+        return init;
+    }
+    return op(std::move(init), parallel_reduce(pool, first, last, op, grain));
+}
+
+template<typename Range, typename Op>
+auto parallel_reduce(thread_pool& pool, const Range& range, Op op, std::size_t grain = 0) {
+    return parallel_reduce(pool, std::begin(range), std::end(range), op, grain);
+}
+
+template<typename Range, typename T, typename Op,
+         typename = std::enable_if_t<!std::is_integral_v<Op>>>
+T parallel_reduce(thread_pool& pool, const Range& range, T init, Op op, std::size_t grain = 0) {
+    return parallel_reduce(pool, std::begin(range), std::end(range), std::move(init), op, grain);
+}
+
+
+#endif //EFFECTIVECPP_PARALLEL_REDUCE_H
@@ -0,0 +1,220 @@
+#ifndef EFFECTIVECPP_PERFECT_HASH_H
+#define EFFECTIVECPP_PERFECT_HASH_H
+
+/*
+ * perfect_hash<N>: a lookup table over N strings known at compile time, with no
+ * collisions.
+ *
+ *   static constexpr std::array<std::string_view, 3> keys {"GET", "PUT", "POST"};
+ *   static constexpr perfect_hash<3> index {keys};
+ *   index.find("PUT");     // 1, the position in keys
+ *   index.find("BREW");    // 3 == N, not a key
+ *
+ * Hash and displace: every key hashes once, the low bits pick a bucket, and
+ * each bucket stores a displacement, chosen at construction, that sends its keys
+ * to slots no other key uses:
+ *     h = hash(key);  slot = multiply_shift(h ^ displacement[h % BUCKETS]) % SLOTS
+ * Buckets are placed largest first, so the search stays short even for
+ * hundreds of keys. A lookup is one hash, two table loads and one compare with
+ * the only key that can match.
+ *
+ * The hash only reads the length and the first and last 8 bytes; key sets that
+ * differ only in between hash every byte (FNV-1a) instead. Run in a constant
+ * expression, a key set that can't be placed (duplicate keys) fails to compile.
+ *
+ * The keys are held as string_views: they must outlive the table, which they do
+ * when they point into string literals or other static storage.
+ */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+
+namespace perfect_hash_detail {
+    // murmur3's finalizer
+    constexpr std::uint64_t mix(std::uint64_t h) noexcept {
+        h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdull;
+        h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53ull;
+        return h ^ (h >> 33);
+    }
+
+    // FNV-1a over every byte
+    constexpr std::uint64_t full_hash(std::string_view s) noexcept {
+        std::uint64_t h = 0xcbf29ce484222325ull;
+        for (char c : s) {
+            h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+        }
+        return mix(h);
+    }
+
+    // up to 8 bytes from p, little endian
+    constexpr std::uint64_t load(const char* p, std::size_t n) noexcept {
+        std::uint64_t v = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            v |= std::uint64_t{static_cast<unsigned char>(p[i])} << (8 * i);
+        }
+        return v;
+    }
+    // a constant count, which the compiler merges into a single 8-byte load
+    constexpr std::uint64_t load8(const char* p) noexcept {
+        std::uint64_t v = 0;
+        for (std::size_t i = 0; i < 8; ++i) {
+            v |= std::uint64_t{static_cast<unsigned char>(p[i])} << (8 * i);
+        }
+        return v;
+    }
+
+    // the length and the first and last 8 bytes only: no loop over long keys
+    constexpr std::uint64_t quick_hash(std::string_view s) noexcept {
+        std::size_t n = s.size();
+        std::uint64_t head = n >= 8 ? load8(s.data()) : load(s.data(), n);
+        std::uint64_t tail = n >= 8 ? load8(s.data() + n - 8) : head;
+        return mix(head * 0x9e3779b97f4a7c15ull ^ tail ^ (std::uint64_t{n} << 56));
+    }
+
+    constexpr std::size_t pow2_at_least(std::size_t n) noexcept {
+        std::size_t m = 1;
+        while (m < n) {
+            m *= 2;
+        }
+        return m;
+    }
+}
+
+
+template<std::size_t N>
+class perfect_hash {
+public:
+    static constexpr std::size_t BUCKETS = perfect_hash_detail::pow2_at_least(N);
+    static constexpr std::size_t SLOTS = perfect_hash_detail::pow2_at_least(2 * N);
+    static constexpr std::uint32_t MAX_DISPLACEMENT = 1 << 20;
+
+    constexpr explicit perfect_hash(const std::array<std::string_view, N>& keys)
+    : keys_(keys) {
+        static_assert(N < 0xffff, "perfect_hash slots hold 16-bit key numbers");
+        auto hashes = hash_keys();
+        if (!distinct(hashes)) {
+            full_ = true;
+            hashes = hash_keys();
+            if (!distinct(hashes)) {
+                throw std::invalid_argument("perfect_hash: keys with equal hashes, duplicate keys?");
+            }
+        }
+        for (auto& t : table_) {
+            t = static_cast<std::uint16_t>(N);
+        }
+        place(hashes);
+    }
+
+    // the position of s in the keys, N when it isn't one
+    constexpr std::size_t find(std::string_view s) const noexcept {
+        std::uint64_t h = hash(s);
+        std::size_t i = table_[slot(h, displacement_[h & (BUCKETS - 1)])];
+        return i < N && keys_[i] == s ? i : N;
+    }
+
+    constexpr std::size_t size() const noexcept { return N; }
+    constexpr bool hashes_all_bytes() const noexcept { return full_; }
+    constexpr const std::array<std::string_view, N>& keys() const noexcept { return keys_; }
+
+private:
+    constexpr std::uint64_t hash(std::string_view s) const noexcept {
+        return full_ ? perfect_hash_detail::full_hash(s) : perfect_hash_detail::quick_hash(s);
+    }
+    static constexpr std::size_t slot(std::uint64_t h, std::uint32_t d) noexcept {
+        return (((h ^ d) * 0x9e3779b97f4a7c15ull) >> 32) & (SLOTS - 1);
+    }
+
+    constexpr std::array<std::uint64_t, N> hash_keys() const noexcept {
+        std::array<std::uint64_t, N> hashes {};
+        for (std::size_t i = 0; i < N; ++i) {
+            hashes[i] = hash(keys_[i]);
+        }
+        return hashes;
+    }
+
+    // keys with equal hashes share a bucket and every slot: no displacement splits them
+    static constexpr bool distinct(const std::array<std::uint64_t, N>& hashes) noexcept {
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = i + 1; j < N; ++j) {
+                if (hashes[i] == hashes[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    constexpr void place(const std::array<std::uint64_t, N>& hashes) {
+        std::array<std::size_t, BUCKETS + 1> start {};  // bucket b's keys are members[start[b] .. start[b + 1])
+        for (std::size_t i = 0; i < N; ++i) {
+            ++start[(hashes[i] & (BUCKETS - 1)) + 1];
+        }
+        for (std::size_t b = 0; b < BUCKETS; ++b) {
+            start[b + 1] += start[b];
+        }
+        std::array<std::size_t, N> members {};
+        std::array<std::size_t, BUCKETS> filled {};
+        for (std::size_t i = 0; i < N; ++i) {
+            std::size_t b = hashes[i] & (BUCKETS - 1);
+            members[start[b] + filled[b]++] = i;
+        }
+
+        // buckets in decreasing size
+        std::array<std::size_t, BUCKETS> order {};
+        for (std::size_t b = 0; b < BUCKETS; ++b) {
+            order[b] = b;
+        }
+        auto size = [&](std::size_t b) { return start[b + 1] - start[b]; };
+        for (std::size_t i = 1; i < BUCKETS; ++i) {
+            for (std::size_t j = i; j > 0 && size(order[j]) > size(order[j - 1]); --j) {
+                std::size_t tmp = order[j];
+                order[j] = order[j - 1];
+                order[j - 1] = tmp;
+            }
+        }
+
+        for (std::size_t b : order) {
+            if (size(b) == 0) {
+                break;
+            }
+            std::uint32_t d = 0;
+            while (!fits(hashes, members, start[b], start[b + 1], d)) {
+                if (++d == MAX_DISPLACEMENT) {
+                    throw std::invalid_argument("perfect_hash: no displacement found");
+                }
+            }
+            displacement_[b] = d;
+            for (std::size_t m = start[b]; m < start[b + 1]; ++m) {
+                table_[slot(hashes[members[m]], d)] = static_cast<std::uint16_t>(members[m]);
+            }
+        }
+    }
+
+    // with displacement d, the keys members[first .. last) land on free slots, each on its own
+    constexpr bool fits(const std::array<std::uint64_t, N>& hashes, const std::array<std::size_t, N>& members,
+                        std::size_t first, std::size_t last, std::uint32_t d) const noexcept {
+        for (std::size_t m = first; m < last; ++m) {
+            std::size_t s = slot(hashes[members[m]], d);
+            if (table_[s] != N) {
+                return false;
+            }
+            for (std::size_t k = first; k < m; ++k) {
+                if (slot(hashes[members[k]], d) == s) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::array<std::string_view, N> keys_;
+    bool full_ = false;  // the keys needed the all-bytes hash
+    std::array<std::uint32_t, BUCKETS> displacement_ {};
+    std::array<std::uint16_t, SLOTS> table_ {};
+};
+
+
+#endif //EFFECTIVECPP_PERFECT_HASH_H
@@ -0,0 +1,377 @@
+#ifndef EFFECTIVECPP_PIPELINE_H
+#define EFFECTIVECPP_PIPELINE_H
+
+/*
+ * Three-stage pipeline: producer -> dispatch (x N threads) -> batched sink,
+ * connected by bounded lock-free single-producer single-consumer rings.
+ *
+ *   auto stats = run_pipeline<boost::any, string>(
+ *       [&](auto&& emit) { for (auto& a : input) emit(a); },                // producer thread
+ *       [](boost::any& a) { return switch_(a)(case_<int>(...), ...); },     // dispatch threads
+ *       [&](const vector<string>& batch) { for (auto& s : batch) out << s << '\n'; },  // sink
+ *       {2, 1024, 256});                                                     // replicas, ring size, batch
+ *
+ * The producer deals items round-robin to one ring per dispatch replica and the
+ * sink collects from the replicas' output rings in the same order, so the output
+ * order equals the input order whatever the replica count. A full ring makes the
+ * stage before it wait (backpressure), so memory stays bounded by the ring sizes.
+ *
+ * A stage that throws stops the pipeline: the other stages stop taking items,
+ * the threads are joined and run_pipeline rethrows the first exception, the way
+ * thread_pool::parallel_for reports a failed task.
+ *
+ * run_pipeline returns per-stage counters: items, time spent in the stage's own
+ * function, how often it waited on a full or empty ring, plus end-to-end latency
+ * measured on every 64th item.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+template<typename T>
+class spsc_ring {
+public:
+    // capacity is rounded up to a power of two
+    explicit spsc_ring(std::size_t capacity) {
+        std::size_t cap = 2;
+        while (cap < capacity) {
+            cap *= 2;
+        }
+        mask = cap - 1;
+        slots = static_cast<T*>(::operator new(cap * sizeof(T), std::align_val_t{alignof(T)}));
+    }
+
+    ~spsc_ring() {
+        for (std::size_t i = tail.load(); i != head.load(); ++i) {
+            slots[i & mask].~T();
+        }
+        ::operator delete(slots, std::align_val_t{alignof(T)});
+    }
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    std::size_t capacity() const noexcept { return mask + 1; }
+
+    // producer side
+    bool try_push(T&& value) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail_cache > mask) {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if (h - tail_cache > mask) {
+                return false;
+            }
+        }
+        ::new (static_cast<void*>(slots + (h & mask))) T(std::move(value));
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side
+    bool try_pop(T& out) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head_cache) {
+            head_cache = head.load(std::memory_order_acquire);
+            if (t == head_cache) {
+                return false;
+            }
+        }
+        T& slot = slots[t & mask];
+        out = std::move(slot);
+        slot.~T();
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // producer: no more pushes; the consumer drains what is left and then sees closed()
+    void close() noexcept { done.store(true, std::memory_order_release); }
+    bool closed() const noexcept { return done.load(std::memory_order_acquire); }
+
+private:
+    // producer and consumer indices on separate cache lines, each with a cached copy of the other
+    alignas(64) std::atomic<std::size_t> head {0};
+    std::size_t tail_cache = 0;
+    alignas(64) std::atomic<std::size_t> tail {0};
+    std::size_t head_cache = 0;
+    alignas(64) std::atomic<bool> done {false};
+    T* slots;
+    std::size_t mask;
+};
+
+
+struct stage_stats {
+    std::string name;
+    std::size_t items = 0;
+    double busy_ms = 0;       // inside the stage's own function
+    std::size_t waits = 0;    // times it found its output full or its input empty
+};
+
+struct pipeline_stats {
+    std::vector<stage_stats> stages;
+    std::size_t items = 0;
+    double wall_ms = 0;
+    double mean_latency_us = 0;
+    double max_latency_us = 0;
+
+    double items_per_sec() const { return wall_ms > 0 ? items / wall_ms * 1e3 : 0; }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const pipeline_stats& s) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%zu items in %.3f ms, %.0f items/s, latency mean %.1f us max %.1f us\n",
+                  s.items, s.wall_ms, s.items_per_sec(), s.mean_latency_us, s.max_latency_us);
+    os << line;
+    for (auto& st : s.stages) {
+        std::snprintf(line, sizeof(line), "    %-12s %10zu items %10.3f ms busy %10zu waits\n",
+                      st.name.c_str(), st.items, st.busy_ms, st.waits);
+        os << line;
+    }
+    return os;
+}
+
+struct pipeline_options {
+    std::size_t replicas = 1;     // dispatch threads
+    std::size_t capacity = 1024;  // slots per ring
+    std::size_t batch = 256;      // items per sink call
+};
+
+
+namespace pipeline_detail {
+    using clock = std::chrono::steady_clock;
+    constexpr std::size_t LATENCY_SAMPLE = 64;
+
+    // an item and, for sampled items, when the producer emitted it
+    template<typename T>
+    struct envelope {
+        T value;
+        clock::rep emitted = 0;
+    };
+
+    // spin briefly, then give the core away; counts every wait for the stats
+    inline void backoff(unsigned& spins, std::size_t& waits) {
+        if (spins++ == 0) {
+            ++waits;
+        }
+        if (spins > 64) {
+            std::this_thread::yield();
+        }
+    }
+
+    inline double ms_since(clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    }
+
+    // the first exception a stage threw; the other stages poll failed() and wind down
+    struct failure {
+        std::atomic<bool> flag {false};
+        std::mutex mutex;
+        std::exception_ptr error;
+
+        void fail(std::exception_ptr e) {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (!error) {
+                error = e;
+            }
+            flag.store(true, std::memory_order_release);
+        }
+        bool failed() const noexcept { return flag.load(std::memory_order_acquire); }
+    };
+
+    // thrown out of emit() to stop the producer once another stage failed
+    struct cancelled {};
+
+    // wait for room; false if another stage failed meanwhile
+    template<typename T>
+    bool push_or_fail(spsc_ring<T>& ring, T&& value, std::size_t& waits, const failure& error) {
+        unsigned spins = 0;
+        while (!ring.try_push(std::move(value))) {
+            if (error.failed()) {
+                return false;
+            }
+            backoff(spins, waits);
+        }
+        return true;
+    }
+
+    // wait for an item; false once the ring is closed and drained, or another stage failed
+    template<typename T>
+    bool pop_or_fail(spsc_ring<T>& ring, T& out, std::size_t& waits, const failure& error) {
+        unsigned spins = 0;
+        while (!ring.try_pop(out)) {
+            if (ring.closed()) {
+                return ring.try_pop(out);
+            }
+            if (error.failed()) {
+                return false;
+            }
+            backoff(spins, waits);
+        }
+        return true;
+    }
+}
+
+
+/*
+ * producer(emit) calls emit(In) for every item; dispatch(In&) -> Out runs on
+ * opts.replicas threads; sink(const std::vector<Out>&) receives batches in input order.
+ */
+template<typename In, typename Out, typename Producer, typename Dispatch, typename Sink>
+pipeline_stats run_pipeline(Producer&& producer, Dispatch&& dispatch, Sink&& sink, pipeline_options opts = {}) {
+    using namespace pipeline_detail;
+    const std::size_t n = std::max<std::size_t>(1, opts.replicas);
+    const std::size_t batch_size = std::max<std::size_t>(1, opts.batch);
+
+    std::vector<std::unique_ptr<spsc_ring<envelope<In>>>> inputs;
+    std::vector<std::unique_ptr<spsc_ring<envelope<Out>>>> outputs;
+    for (std::size_t r = 0; r < n; ++r) {
+        inputs.push_back(std::make_unique<spsc_ring<envelope<In>>>(opts.capacity));
+        outputs.push_back(std::make_unique<spsc_ring<envelope<Out>>>(opts.capacity));
+    }
+
+    pipeline_stats stats;
+    stats.stages.resize(n + 2);
+    stats.stages[0].name = "producer";
+    for (std::size_t r = 0; r < n; ++r) {
+        stats.stages[1 + r].name = "dispatch " + std::to_string(r);
+    }
+    stats.stages[n + 1].name = "sink";
+    failure error;
+    auto start = clock::now();
+
+    std::thread producer_thread([&] {
+        stage_stats& st = stats.stages[0];
+        std::size_t next = 0;
+        auto t0 = clock::now();
+        try {
+            producer([&](In value) {
+                envelope<In> env {std::move(value)};
+                if (st.items % LATENCY_SAMPLE == 0) {
+                    env.emitted = clock::now().time_since_epoch().count();
+                }
+                if (!push_or_fail(*inputs[next], std::move(env), st.waits, error)) {
+                    throw cancelled{};
+                }
+                next = next + 1 == n ? 0 : next + 1;
+                ++st.items;
+            });
+        }
+        catch (const cancelled&) {
+        }
+        catch (...) {
+            error.fail(std::current_exception());
+        }
+        st.busy_ms = ms_since(t0);  // includes time blocked on backpressure
+        for (auto& ring : inputs) {
+            ring->close();
+        }
+    });
+
+    std::vector<std::thread> dispatchers;
+    for (std::size_t r = 0; r < n; ++r) {
+        dispatchers.emplace_back([&, r] {
+            stage_stats& st = stats.stages[1 + r];
+            auto& in = *inputs[r];
+            auto& out = *outputs[r];
+            envelope<In> env {};
+            clock::duration busy {};
+            try {
+                while (pop_or_fail(in, env, st.waits, error)) {
+                    auto t0 = clock::now();
+                    envelope<Out> result {dispatch(env.value), env.emitted};
+                    busy += clock::now() - t0;
+                    if (!push_or_fail(out, std::move(result), st.waits, error)) {
+                        break;
+                    }
+                    ++st.items;
+                }
+            }
+            catch (...) {
+                error.fail(std::current_exception());
+            }
+            st.busy_ms = std::chrono::duration<double, std::milli>(busy).count();
+            out.close();
+        });
+    }
+
+    // the sink runs on the calling thread
+    try {
+        stage_stats& st = stats.stages[n + 1];
+        std::vector<Out> batch;
+        batch.reserve(batch_size);
+        envelope<Out> env {};
+        double latency_sum = 0;
+        std::size_t latency_count = 0;
+        clock::duration busy {};
+        auto flush = [&] {
+            auto t0 = clock::now();
+            sink(static_cast<const std::vector<Out>&>(batch));
+            busy += clock::now() - t0;
+            st.items += batch.size();
+            batch.clear();
+        };
+        for (std::size_t next = 0; ; next = next + 1 == n ? 0 : next + 1) {
+            auto& ring = *outputs[next];
+            unsigned spins = 0;
+            bool got = false;
+            while (!(got = ring.try_pop(env))) {
+                if ((ring.closed() && !(got = ring.try_pop(env))) || error.failed()) {
+                    break;
+                }
+                if (spins > 64 && !batch.empty()) {
+                    flush();  // the dispatchers are behind, don't sit on finished output
+                }
+                backoff(spins, st.waits);
+            }
+            if (!got) {
+                // items were dealt round-robin, so the first exhausted ring means all are
+                break;
+            }
+            if (env.emitted) {
+                double us = std::chrono::duration<double, std::micro>(
+                    clock::duration(clock::now().time_since_epoch().count() - env.emitted)).count();
+                latency_sum += us;
+                stats.max_latency_us = std::max(stats.max_latency_us, us);
+                ++latency_count;
+            }
+            batch.push_back(std::move(env.value));
+            if (batch.size() == batch_size) {
+                flush();
+            }
+        }
+        if (!batch.empty()) {
+            flush();
+        }
+        st.busy_ms = std::chrono::duration<double, std::milli>(busy).count();
+        stats.mean_latency_us = latency_count ? latency_sum / latency_count : 0;
+    }
+    catch (...) {
+        error.fail(std::current_exception());
+    }
+
+    producer_thread.join();
+    for (auto& t : dispatchers) {
+        t.join();
+    }
+    if (error.error) {
+        std::rethrow_exception(error.error);
+    }
+    stats.items = stats.stages[n + 1].items;
+    stats.wall_ms = ms_since(start);
+    return stats;
+}
+
+
+#endif //EFFECTIVECPP_PIPELINE_H
@@ -0,0 +1,40 @@
+#ifndef EFFECTIVECPP_POINT_H
+#define EFFECTIVECPP_POINT_H
+
+/*
+ * constexpr Point from item 15, shared by ch3_constexpr and point_cloud.h
+ */
+
+class Point {
+public:
+    constexpr Point(double x = 0, double y = 0) noexcept
+    : x(x), y(y)
+    {}
+
+    constexpr double getX() const noexcept { return x; }
+    constexpr double getY() const noexcept { return y; }
+    constexpr void setX(double newx) { x = newx; }
+    constexpr void setY(double newy) { y = newy; }
+
+private:
+    double x, y;
+};
+
+
+constexpr Point midpoint(const Point& p1, const Point& p2) noexcept {
+    return {
+        (p1.getX() + p2.getX()) / 2,
+        (p1.getY() + p2.getY()) / 2
+    };
+}
+
+
+constexpr Point reflect(const Point& p) {
+    Point ans;
+    ans.setX(-p.getX());
+    ans.setY(-p.getY());
+    return ans;
+}
+
+
+#endif //EFFECTIVECPP_POINT_H
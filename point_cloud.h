@@ -0,0 +1,176 @@
+#ifndef EFFECTIVECPP_POINT_CLOUD_H
+#define EFFECTIVECPP_POINT_CLOUD_H
+
+/*
+ * Struct-of-arrays container for Point (point.h).
+ * x and y live in separate 64-byte aligned arrays, so the batch kernels below are
+ * plain loops over contiguous doubles that the compiler turns into SIMD code.
+ * Every kernel takes an optional thread count and splits the range into chunks.
+ */
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "aligned_allocator.h"
+#include "point.h"
+
+
+class PointCloud {
+public:
+    using Storage = std::vector<double, aligned_allocator<double, 64>>;
+
+    PointCloud() = default;
+    explicit PointCloud(std::size_t n)
+    : xs(n), ys(n)
+    {}
+
+    explicit PointCloud(const std::vector<Point>& points)
+    : xs(points.size()), ys(points.size()) {
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            xs[i] = points[i].getX();
+            ys[i] = points[i].getY();
+        }
+    }
+
+    std::vector<Point> to_points() const {
+        std::vector<Point> points;
+        points.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i) {
+            points.emplace_back(xs[i], ys[i]);
+        }
+        return points;
+    }
+
+    std::size_t size() const noexcept { return xs.size(); }
+    bool empty() const noexcept { return xs.empty(); }
+
+    void resize(std::size_t n) {
+        xs.resize(n);
+        ys.resize(n);
+    }
+    void reserve(std::size_t n) {
+        xs.reserve(n);
+        ys.reserve(n);
+    }
+    void push_back(const Point& p) {
+        xs.push_back(p.getX());
+        ys.push_back(p.getY());
+    }
+
+    // rows are assembled on the fly, there is no Point object to reference
+    Point operator[](std::size_t i) const { return {xs[i], ys[i]}; }
+    void set(std::size_t i, const Point& p) {
+        xs[i] = p.getX();
+        ys[i] = p.getY();
+    }
+
+    double* x() noexcept { return xs.data(); }
+    double* y() noexcept { return ys.data(); }
+    const double* x() const noexcept { return xs.data(); }
+    const double* y() const noexcept { return ys.data(); }
+
+private:
+    Storage xs, ys;
+};
+
+
+/*
+ * Run f(begin, end) over [0, n) split into `threads` chunks.
+ * Chunk boundaries are multiples of 8 doubles (one cache line), so two threads
+ * never write to the same line. The calling thread takes the first chunk.
+ */
+template<typename F>
+void for_each_chunk(std::size_t n, unsigned threads, F&& f) {
+    constexpr std::size_t LINE = 8;
+    threads = std::max(1u, threads);
+    std::size_t chunk = (n + threads - 1) / threads;
+    chunk = (chunk + LINE - 1) / LINE * LINE;
+    if (threads == 1 || chunk >= n) {
+        f(std::size_t{0}, n);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (std::size_t begin = chunk; begin < n; begin += chunk) {
+        workers.emplace_back([&f, begin, end = std::min(n, begin + chunk)] { f(begin, end); });
+    }
+    f(std::size_t{0}, chunk);
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+
+/*
+ * Batch versions of midpoint/reflect plus translate/scale/affine.
+ * The loops are kept trivially simple on purpose: one contiguous stream per
+ * operand and no cross-iteration dependency, which is what the vectorizer wants.
+ * `out` may be the same cloud as `a` or `b`, element i only reads index i.
+ */
+inline void midpoint(const PointCloud& a, const PointCloud& b, PointCloud& out, unsigned threads = 1) {
+    assert(a.size() == b.size());
+    out.resize(a.size());
+    const double* ax = a.x(); const double* ay = a.y();
+    const double* bx = b.x(); const double* by = b.y();
+    double* ox = out.x(); double* oy = out.y();
+    for_each_chunk(a.size(), threads, [=](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            ox[i] = (ax[i] + bx[i]) * 0.5;
+        }
+        for (std::size_t i = begin; i < end; ++i) {
+            oy[i] = (ay[i] + by[i]) * 0.5;
+        }
+    });
+}
+
+inline void reflect(PointCloud& cloud, unsigned threads = 1) {
+    double* xs = cloud.x(); double* ys = cloud.y();
+    for_each_chunk(cloud.size(), threads, [=](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            xs[i] = -xs[i];
+        }
+        for (std::size_t i = begin; i < end; ++i) {
+            ys[i] = -ys[i];
+        }
+    });
+}
+
+inline void translate(PointCloud& cloud, double dx, double dy, unsigned threads = 1) {
+    double* xs = cloud.x(); double* ys = cloud.y();
+    for_each_chunk(cloud.size(), threads, [=](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            xs[i] += dx;
+        }
+        for (std::size_t i = begin; i < end; ++i) {
+            ys[i] += dy;
+        }
+    });
+}
+
+inline void scale(PointCloud& cloud, double sx, double sy, unsigned threads = 1) {
+    double* xs = cloud.x(); double* ys = cloud.y();
+    for_each_chunk(cloud.size(), threads, [=](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            xs[i] *= sx;
+        }
+        for (std::size_t i = begin; i < end; ++i) {
+            ys[i] *= sy;
+        }
+    });
+}
+
+// x' = x * sx + dx, y' = y * sy + dy in one pass, instead of scale() then translate()
+inline void affine(PointCloud& cloud, double sx, double sy, double dx, double dy, unsigned threads = 1) {
+    double* xs = cloud.x(); double* ys = cloud.y();
+    for_each_chunk(cloud.size(), threads, [=](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            xs[i] = xs[i] * sx + dx;
+        }
+        for (std::size_t i = begin; i < end; ++i) {
+            ys[i] = ys[i] * sy + dy;
+        }
+    });
+}
+
+
+#endif //EFFECTIVECPP_POINT_CLOUD_H
@@ -0,0 +1,294 @@
+#ifndef EFFECTIVECPP_RCU_H
+#define EFFECTIVECPP_RCU_H
+
+/*
+ * Read-copy-update: an object that many threads read and few replace, with
+ * readers that never write a cache line another thread reads.
+ *
+ *   rcu_cell<Marker> current(std::make_unique<Apple>(...));
+ *   {
+ *       auto snap = current.read();           // a snapshot, valid until snap dies
+ *       snap->get();
+ *   }
+ *   current.store(std::make_unique<Cherry>(...));          // publish a replacement
+ *   current.update([](const Marker& m) { return std::make_unique<Cherry>(m.get(), "-next"); });  // derive, publish
+ *
+ * Reclamation is epoch based. rcu_domain keeps a global epoch and one record per
+ * reader thread, each on its own cache line. A reader writes the epoch it saw
+ * into its own record, loads the pointer, and writes 0 when done: no shared
+ * refcount, so nothing bounces between cores while nobody writes. A writer swaps
+ * the pointer, tags the old object with the epoch and advances it; the object
+ * is deleted once every record is either 0 or newer than the tag, i.e. no
+ * reader that could have seen it is still inside. That check runs on every
+ * retire, synchronize() waits for it.
+ *
+ * Readers don't block writers and writers don't block readers; writers of one
+ * cell are serialized by its mutex. Objects are deleted as the type they were
+ * published with (store's U, or what update's f returns), so a Derived published
+ * into rcu_cell<Base> needs no virtual destructor in Base, as long as that type is
+ * the object's dynamic type: a polymorphic U must be final or have a virtual
+ * destructor, which rules out store(std::unique_ptr<Base>(new Derived)).
+ * Don't call synchronize() or destroy a cell while holding a snapshot on the
+ * same thread: it would wait for itself.
+ */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+class rcu_domain {
+    struct record;
+
+public:
+    using destroy_fn = void (*)(void*);
+
+    // one per process, shared by all cells
+    static rcu_domain& instance() {
+        static rcu_domain domain;
+        return domain;
+    }
+
+    rcu_domain(const rcu_domain&) = delete;
+    rcu_domain& operator=(const rcu_domain&) = delete;
+
+    ~rcu_domain() {
+        for (auto& r : retired) {
+            r.destroy(r.object);
+        }
+        for (record* r = records.load(std::memory_order_acquire); r;) {
+            record* next = r->next;
+            delete r;
+            r = next;
+        }
+    }
+
+    // marks the calling thread as reading until destroyed; guards nest
+    class read_guard {
+    public:
+        read_guard() : rec(rcu_domain::instance().local_record()) {
+            if (rec->depth++ == 0) {
+                // seq_cst: the epoch is visible before any pointer this reader loads
+                rec->epoch.store(rcu_domain::instance().epoch.load(std::memory_order_acquire),
+                                 std::memory_order_seq_cst);
+            }
+        }
+        ~read_guard() {
+            if (--rec->depth == 0) {
+                rec->epoch.store(0, std::memory_order_release);
+            }
+        }
+        read_guard(const read_guard&) = delete;
+        read_guard& operator=(const read_guard&) = delete;
+
+    private:
+        record* rec;
+    };
+
+    // delete object with destroy once no reader can still see it
+    void retire(void* object, destroy_fn destroy) {
+        std::lock_guard<std::mutex> lock(retire_mutex);
+        retired.push_back({epoch.fetch_add(1, std::memory_order_seq_cst), object, destroy});
+        reclaim(oldest_reader());
+    }
+
+    // wait until the readers inside now have left, then delete everything retired so far
+    void synchronize() {
+        std::uint64_t now = epoch.fetch_add(1, std::memory_order_seq_cst);
+        while (oldest_reader() <= now) {
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(retire_mutex);
+        reclaim(oldest_reader());
+    }
+
+    // objects retired but not deleted yet
+    std::size_t pending() const {
+        std::lock_guard<std::mutex> lock(retire_mutex);
+        return retired.size();
+    }
+
+private:
+    struct alignas(64) record {
+        std::atomic<std::uint64_t> epoch {0};  // 0: not reading
+        std::atomic<bool> in_use {true};
+        unsigned depth = 0;                    // nesting, owner thread only
+        record* next = nullptr;
+    };
+
+    struct retired_object {
+        std::uint64_t epoch;
+        void* object;
+        destroy_fn destroy;
+    };
+
+    // gives the record back when its thread exits
+    struct record_owner {
+        record* rec = nullptr;
+        ~record_owner() {
+            if (rec) {
+                rec->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    rcu_domain() = default;
+
+    record* local_record() {
+        static thread_local record_owner owner;
+        if (!owner.rec) {
+            owner.rec = acquire_record();
+        }
+        return owner.rec;
+    }
+
+    // a record left by an exited thread, or a new one pushed onto the list
+    record* acquire_record() {
+        for (record* r = records.load(std::memory_order_acquire); r; r = r->next) {
+            bool free = false;
+            if (!r->in_use.load(std::memory_order_relaxed)
+                && r->in_use.compare_exchange_strong(free, true, std::memory_order_acquire)) {
+                return r;
+            }
+        }
+        auto* r = new record;
+        r->next = records.load(std::memory_order_relaxed);
+        while (!records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        return r;
+    }
+
+    // the smallest epoch a reader is in, or "infinity" with no readers
+    std::uint64_t oldest_reader() const {
+        std::uint64_t oldest = ~std::uint64_t{0};
+        for (record* r = records.load(std::memory_order_acquire); r; r = r->next) {
+            std::uint64_t e = r->epoch.load(std::memory_order_seq_cst);
+            if (e != 0 && e < oldest) {
+                oldest = e;
+            }
+        }
+        return oldest;
+    }
+
+    // objects retired before the oldest reader's epoch are unreachable; retire_mutex held
+    void reclaim(std::uint64_t oldest) {
+        std::size_t kept = 0;
+        for (auto& r : retired) {
+            if (r.epoch < oldest) {
+                r.destroy(r.object);
+            }
+            else {
+                retired[kept++] = r;
+            }
+        }
+        retired.resize(kept);
+    }
+
+    alignas(64) std::atomic<std::uint64_t> epoch {1};
+    alignas(64) std::atomic<record*> records {nullptr};
+    mutable std::mutex retire_mutex;
+    std::vector<retired_object> retired;
+};
+
+
+namespace rcu_detail {
+    template<typename U>
+    void destroy(void* p) {
+        delete static_cast<U*>(p);
+    }
+}
+
+
+// what rcu_cell::read() returns: the object, pinned until the snapshot dies
+template<typename T>
+class rcu_snapshot {
+public:
+    const T* get() const noexcept { return ptr; }
+    const T& operator*() const noexcept { return *ptr; }
+    const T* operator->() const noexcept { return ptr; }
+    explicit operator bool() const noexcept { return ptr != nullptr; }
+
+private:
+    template<typename> friend class rcu_cell;
+
+    explicit rcu_snapshot(const std::atomic<T*>& source)
+    : ptr(source.load(std::memory_order_seq_cst)) {}
+
+    rcu_domain::read_guard guard;  // first: entered before ptr is loaded
+    const T* ptr;
+};
+
+
+template<typename T>
+class rcu_cell {
+public:
+    // the domain is a function-local static: creating it before this cell is done
+    // constructing makes it outlive the cell, even one at namespace scope
+    rcu_cell() {
+        rcu_domain::instance();
+    }
+
+    template<typename U>
+    explicit rcu_cell(std::unique_ptr<U> initial)
+    : rcu_cell()
+    {
+        store(std::move(initial));
+    }
+
+    rcu_cell(const rcu_cell&) = delete;
+    rcu_cell& operator=(const rcu_cell&) = delete;
+
+    // no reader may still be inside
+    ~rcu_cell() {
+        rcu_domain::instance().synchronize();
+        if (owner) {
+            destroy(owner);
+        }
+    }
+
+    rcu_snapshot<T> read() const { return rcu_snapshot<T>(current); }
+
+    // publish next, retire what was there
+    template<typename U>
+    void store(std::unique_ptr<U> next) {
+        static_assert(std::is_convertible_v<U*, T*>, "rcu_cell<T> holds T or classes derived from it");
+        std::lock_guard<std::mutex> lock(writer);
+        publish(next.release());
+    }
+
+    // publish f(current object) as a unique_ptr, computed while other writers wait;
+    // the cell must hold an object
+    template<typename F>
+    void update(F&& f) {
+        std::lock_guard<std::mutex> lock(writer);
+        auto next = std::forward<F>(f)(static_cast<const T&>(*current.load(std::memory_order_relaxed)));
+        publish(next.release());
+    }
+
+private:
+    // writer held
+    template<typename U>
+    void publish(U* next) {
+        static_assert(!std::is_polymorphic_v<U> || std::is_final_v<U> || std::has_virtual_destructor_v<U>,
+                      "rcu_cell deletes objects as the published type: make it final or give it a virtual destructor");
+        void* old_owner = std::exchange(owner, static_cast<void*>(next));
+        rcu_domain::destroy_fn old_destroy = std::exchange(destroy, &rcu_detail::destroy<U>);
+        T* old = current.exchange(next, std::memory_order_seq_cst);
+        if (old) {
+            rcu_domain::instance().retire(old_owner, old_destroy);
+        }
+    }
+
+    std::atomic<T*> current {nullptr};
+    std::mutex writer;
+    void* owner = nullptr;                    // current as the type it was published with
+    rcu_domain::destroy_fn destroy = nullptr;
+};
+
+
+#endif //EFFECTIVECPP_RCU_H
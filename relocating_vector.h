@@ -0,0 +1,362 @@
+#ifndef EFFECTIVECPP_RELOCATING_VECTOR_H
+#define EFFECTIVECPP_RELOCATING_VECTOR_H
+
+/*
+ * relocating_vector<T>: vector whose growth, insert and erase move elements with
+ * memcpy / memmove when T is trivially relocatable (trivially_relocatable.h), and
+ * with per-element move + destroy otherwise.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "trivially_relocatable.h"
+
+
+template<typename T>
+class relocating_vector {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    // opt in to the vector operator<< in vector_like.h
+    using vector_like = std::true_type;
+    // the vector itself is three pointers' worth of state
+    using trivially_relocatable = std::true_type;
+
+    static constexpr bool relocatable = is_trivially_relocatable_v<T>;
+
+    relocating_vector() noexcept = default;
+
+    // these delegate to the default constructor first: once it has finished the object
+    // counts as constructed, so if filling it throws ~relocating_vector frees what was built
+    explicit relocating_vector(size_type n)
+    : relocating_vector()
+    {
+        resize(n);
+    }
+
+    relocating_vector(size_type n, const T& value)
+    : relocating_vector()
+    {
+        resize(n, value);
+    }
+
+    template<typename It, typename = std::enable_if_t<
+        std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<It>::iterator_category>>>
+    relocating_vector(It first, It last)
+    : relocating_vector()
+    {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                        typename std::iterator_traits<It>::iterator_category>) {
+            auto n = static_cast<size_type>(std::distance(first, last));
+            reserve(n);
+            std::uninitialized_copy(first, last, ptr);
+            sz = n;
+        }
+        else {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    relocating_vector(std::initializer_list<T> init)
+    : relocating_vector(init.begin(), init.end())
+    {}
+
+    relocating_vector(const relocating_vector& other)
+    : relocating_vector(other.begin(), other.end())
+    {}
+
+    relocating_vector(relocating_vector&& other) noexcept
+    : ptr(std::exchange(other.ptr, nullptr)),
+      sz(std::exchange(other.sz, 0)),
+      cap(std::exchange(other.cap, 0))
+    {}
+
+    ~relocating_vector() {
+        clear();
+        deallocate(ptr);
+    }
+
+    relocating_vector& operator=(const relocating_vector& other) {
+        if (this != &other) {
+            relocating_vector tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    relocating_vector& operator=(relocating_vector&& other) noexcept {
+        relocating_vector tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    /***************** element access *****************/
+    reference operator[](size_type i) noexcept { return ptr[i]; }
+    const_reference operator[](size_type i) const noexcept { return ptr[i]; }
+    reference at(size_type i) {
+        if (i >= sz) {
+            throw std::out_of_range("relocating_vector::at");
+        }
+        return ptr[i];
+    }
+    const_reference at(size_type i) const {
+        return const_cast<relocating_vector*>(this)->at(i);
+    }
+    reference front() noexcept { return ptr[0]; }
+    const_reference front() const noexcept { return ptr[0]; }
+    reference back() noexcept { return ptr[sz - 1]; }
+    const_reference back() const noexcept { return ptr[sz - 1]; }
+    pointer data() noexcept { return ptr; }
+    const_pointer data() const noexcept { return ptr; }
+
+    iterator begin() noexcept { return ptr; }
+    iterator end() noexcept { return ptr + sz; }
+    const_iterator begin() const noexcept { return ptr; }
+    const_iterator end() const noexcept { return ptr + sz; }
+    const_iterator cbegin() const noexcept { return ptr; }
+    const_iterator cend() const noexcept { return ptr + sz; }
+
+    /***************** capacity *****************/
+    size_type size() const noexcept { return sz; }
+    bool empty() const noexcept { return sz == 0; }
+    size_type capacity() const noexcept { return cap; }
+
+    void reserve(size_type n) {
+        if (n > cap) {
+            T* new_ptr = allocate(n);
+            relocate_or_free(ptr, sz, new_ptr);
+            deallocate(ptr);
+            ptr = new_ptr;
+            cap = n;
+        }
+    }
+
+    void shrink_to_fit() {
+        if (sz < cap) {
+            // raw until relocated: relocate_or_free frees it itself if a copy throws
+            T* new_ptr = nullptr;
+            if (sz) {
+                new_ptr = allocate(sz);
+                relocate_or_free(ptr, sz, new_ptr);
+            }
+            deallocate(ptr);
+            ptr = new_ptr;
+            cap = sz;
+        }
+    }
+
+    /***************** modifiers *****************/
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (sz == cap) {
+            // build in the new block first, args may alias an element we are about to move
+            size_type new_cap = next_capacity(sz + 1);
+            T* new_ptr = allocate(new_cap);
+            try {
+                ::new (static_cast<void*>(new_ptr + sz)) T(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                deallocate(new_ptr);
+                throw;
+            }
+            relocate_or_free(ptr, sz, new_ptr, new_ptr + sz);
+            deallocate(ptr);
+            ptr = new_ptr;
+            cap = new_cap;
+        }
+        else {
+            ::new (static_cast<void*>(ptr + sz)) T(std::forward<Args>(args)...);
+        }
+        return ptr[sz++];
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() noexcept {
+        ptr[--sz].~T();
+    }
+
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        auto i = static_cast<size_type>(pos - begin());
+        if constexpr (relocatable) {
+            if (sz == cap) {
+                // new element first, then the two halves around it
+                size_type new_cap = next_capacity(sz + 1);
+                T* new_ptr = allocate(new_cap);
+                try {
+                    ::new (static_cast<void*>(new_ptr + i)) T(std::forward<Args>(args)...);
+                }
+                catch (...) {
+                    deallocate(new_ptr);
+                    throw;
+                }
+                copy_bytes(new_ptr, ptr, i);
+                copy_bytes(new_ptr + i + 1, ptr + i, sz - i);
+                deallocate(ptr);
+                ptr = new_ptr;
+                cap = new_cap;
+            }
+            else {
+                // build it aside, shift the tail up one slot, then relocate it into the hole
+                alignas(T) unsigned char tmp[sizeof(T)];
+                ::new (static_cast<void*>(tmp)) T(std::forward<Args>(args)...);
+                move_bytes(ptr + i + 1, ptr + i, sz - i);
+                std::memcpy(static_cast<void*>(ptr + i), tmp, sizeof(T));
+            }
+            ++sz;
+        }
+        else if (i == sz || sz == cap) {
+            emplace_back(std::forward<Args>(args)...);
+            std::rotate(begin() + i, end() - 1, end());
+        }
+        else {
+            // what std::vector does: one move-construct at the end, move-assign the rest
+            T tmp(std::forward<Args>(args)...);
+            emplace_back(std::move(back()));
+            std::move_backward(begin() + i, end() - 2, end() - 1);
+            ptr[i] = std::move(tmp);
+        }
+        return begin() + i;
+    }
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        auto i = static_cast<size_type>(first - begin());
+        auto n = static_cast<size_type>(last - first);
+        if constexpr (relocatable) {
+            std::destroy(begin() + i, begin() + i + n);
+            move_bytes(ptr + i, ptr + i + n, sz - i - n);
+            sz -= n;
+        }
+        else {
+            std::move(begin() + i + n, end(), begin() + i);
+            while (n--) {
+                pop_back();
+            }
+        }
+        return begin() + i;
+    }
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    void resize(size_type n) {
+        reserve(n);
+        while (sz < n) {
+            emplace_back();
+        }
+        while (sz > n) {
+            pop_back();
+        }
+    }
+
+    void resize(size_type n, const T& value) {
+        reserve(n);
+        while (sz < n) {
+            emplace_back(value);
+        }
+        while (sz > n) {
+            pop_back();
+        }
+    }
+
+    void clear() noexcept {
+        std::destroy(ptr, ptr + sz);
+        sz = 0;
+    }
+
+    void swap(relocating_vector& other) noexcept {
+        std::swap(ptr, other.ptr);
+        std::swap(sz, other.sz);
+        std::swap(cap, other.cap);
+    }
+
+private:
+    static T* allocate(size_type n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+    }
+    static void deallocate(T* p) noexcept {
+        if (p) {
+            ::operator delete(p, std::align_val_t{alignof(T)});
+        }
+    }
+
+    // the casts keep GCC's -Wclass-memaccess quiet, the trait is what makes this legal
+    static void copy_bytes(T* dst, const T* src, size_type n) noexcept {
+        if (n) {
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+        }
+    }
+    static void move_bytes(T* dst, const T* src, size_type n) noexcept {
+        if (n) {
+            std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+        }
+    }
+
+    size_type next_capacity(size_type min_cap) const noexcept {
+        return std::max(min_cap, cap * 2);
+    }
+
+    /*
+     * Move n elements from src into the raw block dst and end their lifetime in src.
+     * On the per-element path a throwing copy (move_if_noexcept) leaves src intact,
+     * destroys what was built, destroys `extra` (an element already built in dst),
+     * frees dst and rethrows, so growth keeps the strong guarantee.
+     */
+    static void relocate_or_free(T* src, size_type n, T* dst, T* extra = nullptr) {
+        if constexpr (relocatable) {
+            copy_bytes(dst, src, n);
+        }
+        else {
+            size_type done = 0;
+            try {
+                for (; done < n; ++done) {
+                    ::new (static_cast<void*>(dst + done)) T(std::move_if_noexcept(src[done]));
+                }
+            }
+            catch (...) {
+                std::destroy(dst, dst + done);
+                if (extra) {
+                    extra->~T();
+                }
+                deallocate(dst);
+                throw;
+            }
+            std::destroy(src, src + n);
+        }
+    }
+
+    T* ptr = nullptr;
+    size_type sz = 0;
+    size_type cap = 0;
+};
+
+
+template<typename T>
+bool operator==(const relocating_vector<T>& a, const relocating_vector<T>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+}
+template<typename T>
+bool operator!=(const relocating_vector<T>& a, const relocating_vector<T>& b) {
+    return !(a == b);
+}
+
+
+#endif //EFFECTIVECPP_RELOCATING_VECTOR_H
@@ -0,0 +1,229 @@
+#ifndef EFFECTIVECPP_SMALL_ANY_H
+#define EFFECTIVECPP_SMALL_ANY_H
+
+/*
+ * basic_small_any<Capacity>: boost::any with inline storage.
+ *
+ *   small_any a = 1000;                         // no allocation
+ *   a = vector<int>{4, 22, -1};                 // 24 bytes, still inline
+ *   if (int* p = any_cast<int>(&a)) ...         // nullptr on a type mismatch
+ *   unsafe_any_cast<int>(&a);                   // no check, like boost::unsafe_any_cast
+ *   a.type_id() == small_any::id_of<int>();     // one pointer compare
+ *
+ * Values up to Capacity bytes (32 by default) whose move constructor is noexcept
+ * live inside the object, everything else on the heap. Each stored type gets one
+ * static table of copy / move / destroy functions, and the table address doubles
+ * as the type id. type() still returns the std::type_info, for code written
+ * against boost::any.
+ *
+ * The ids are per program image: values crossing a shared library boundary may
+ * see two ids for one type, use type() there.
+ */
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <boost/any.hpp>
+
+
+template<std::size_t Capacity = 32>
+class basic_small_any {
+    static_assert(Capacity >= sizeof(void*), "the inline buffer must at least hold a pointer");
+
+    union storage {
+        alignas(std::max_align_t) unsigned char buf[Capacity];
+        void* heap;
+    };
+
+    struct ops {
+        const std::type_info& (*type)() noexcept;
+        void (*copy)(const storage& src, storage& dst);
+        void (*move)(storage& src, storage& dst) noexcept;  // leaves src destroyed
+        void (*destroy)(storage& s) noexcept;
+        void* (*get)(const storage& s) noexcept;
+    };
+
+    template<typename T>
+    static constexpr bool stored_inline = sizeof(T) <= Capacity
+                                          && alignof(T) <= alignof(std::max_align_t)
+                                          && std::is_nothrow_move_constructible_v<T>;
+
+    template<typename T, bool Inline = stored_inline<T>>
+    struct handler {
+        static T* ptr(const storage& s) noexcept {
+            return std::launder(reinterpret_cast<T*>(const_cast<unsigned char*>(s.buf)));
+        }
+        static const std::type_info& type() noexcept { return typeid(T); }
+        static void copy(const storage& src, storage& dst) { ::new (static_cast<void*>(dst.buf)) T(*ptr(src)); }
+        static void move(storage& src, storage& dst) noexcept {
+            ::new (static_cast<void*>(dst.buf)) T(std::move(*ptr(src)));
+            ptr(src)->~T();
+        }
+        static void destroy(storage& s) noexcept { ptr(s)->~T(); }
+        static void* get(const storage& s) noexcept { return ptr(s); }
+
+        static constexpr ops table {&type, &copy, &move, &destroy, &get};
+    };
+
+    template<typename T>
+    struct handler<T, false> {
+        static T* ptr(const storage& s) noexcept { return static_cast<T*>(s.heap); }
+        static const std::type_info& type() noexcept { return typeid(T); }
+        static void copy(const storage& src, storage& dst) { dst.heap = new T(*ptr(src)); }
+        static void move(storage& src, storage& dst) noexcept { dst.heap = src.heap; }
+        static void destroy(storage& s) noexcept { delete ptr(s); }
+        static void* get(const storage& s) noexcept { return s.heap; }
+
+        static constexpr ops table {&type, &copy, &move, &destroy, &get};
+    };
+
+    template<typename T>
+    using decay_if_not_any = std::enable_if_t<!std::is_same_v<std::decay_t<T>, basic_small_any>>;
+
+public:
+    using type_id_t = const void*;
+
+    // the id a value of type T reports through type_id(), nullptr is the empty any
+    template<typename T>
+    static type_id_t id_of() noexcept { return &handler<std::decay_t<T>>::table; }
+
+    template<typename T>
+    static constexpr bool is_inline = stored_inline<std::decay_t<T>>;
+
+    basic_small_any() noexcept = default;
+
+    template<typename T, typename = decay_if_not_any<T>>
+    basic_small_any(T&& value) {
+        emplace<std::decay_t<T>>(std::forward<T>(value));
+    }
+
+    basic_small_any(const basic_small_any& other) {
+        if (other.vt) {
+            other.vt->copy(other.data, data);
+            vt = other.vt;
+        }
+    }
+
+    basic_small_any(basic_small_any&& other) noexcept {
+        if (other.vt) {
+            other.vt->move(other.data, data);
+            vt = std::exchange(other.vt, nullptr);
+        }
+    }
+
+    ~basic_small_any() { reset(); }
+
+    basic_small_any& operator=(const basic_small_any& other) {
+        basic_small_any(other).swap(*this);
+        return *this;
+    }
+
+    basic_small_any& operator=(basic_small_any&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.vt) {
+                other.vt->move(other.data, data);
+                vt = std::exchange(other.vt, nullptr);
+            }
+        }
+        return *this;
+    }
+
+    template<typename T, typename = decay_if_not_any<T>>
+    basic_small_any& operator=(T&& value) {
+        basic_small_any(std::forward<T>(value)).swap(*this);
+        return *this;
+    }
+
+    template<typename T, typename... Args>
+    T& emplace(Args&&... args) {
+        static_assert(std::is_copy_constructible_v<T>, "like boost::any, stored values must be copyable");
+        reset();
+        if constexpr (stored_inline<T>) {
+            ::new (static_cast<void*>(data.buf)) T(std::forward<Args>(args)...);
+        }
+        else {
+            data.heap = new T(std::forward<Args>(args)...);
+        }
+        vt = &handler<T>::table;
+        return *static_cast<T*>(vt->get(data));
+    }
+
+    void reset() noexcept {
+        if (vt) {
+            vt->destroy(data);
+            vt = nullptr;
+        }
+    }
+    void clear() noexcept { reset(); }
+
+    void swap(basic_small_any& other) noexcept {
+        basic_small_any tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    bool empty() const noexcept { return vt == nullptr; }
+    bool has_value() const noexcept { return vt != nullptr; }
+
+    const std::type_info& type() const noexcept { return vt ? vt->type() : typeid(void); }
+    type_id_t type_id() const noexcept { return vt; }
+
+    template<typename T>
+    bool is() const noexcept { return vt == id_of<T>(); }
+
+    // no check: the caller knows the stored type is T
+    template<typename T>
+    T* unchecked_get() noexcept { return static_cast<T*>(vt->get(data)); }
+    template<typename T>
+    const T* unchecked_get() const noexcept { return static_cast<const T*>(vt->get(data)); }
+
+private:
+    storage data;
+    const ops* vt = nullptr;
+};
+
+using small_any = basic_small_any<>;
+
+
+/***************** boost::any style casts *****************/
+template<typename T, std::size_t N>
+T* any_cast(basic_small_any<N>* a) noexcept {
+    return a && a->template is<T>() ? a->template unchecked_get<T>() : nullptr;
+}
+template<typename T, std::size_t N>
+const T* any_cast(const basic_small_any<N>* a) noexcept {
+    return a && a->template is<T>() ? a->template unchecked_get<T>() : nullptr;
+}
+
+template<typename T, std::size_t N>
+T any_cast(basic_small_any<N>& a) {
+    using U = std::remove_cv_t<std::remove_reference_t<T>>;
+    U* p = any_cast<U>(&a);
+    if (!p) {
+        throw boost::bad_any_cast();
+    }
+    return static_cast<T>(*p);
+}
+template<typename T, std::size_t N>
+T any_cast(const basic_small_any<N>& a) {
+    using U = std::remove_cv_t<std::remove_reference_t<T>>;
+    const U* p = any_cast<U>(&a);
+    if (!p) {
+        throw boost::bad_any_cast();
+    }
+    return static_cast<T>(*p);
+}
+
+template<typename T, std::size_t N>
+T* unsafe_any_cast(basic_small_any<N>* a) noexcept {
+    return a->template unchecked_get<T>();
+}
+template<typename T, std::size_t N>
+const T* unsafe_any_cast(const basic_small_any<N>* a) noexcept {
+    return a->template unchecked_get<T>();
+}
+
+
+#endif //EFFECTIVECPP_SMALL_ANY_H
@@ -0,0 +1,324 @@
+#ifndef EFFECTIVECPP_SMALL_VECTOR_H
+#define EFFECTIVECPP_SMALL_VECTOR_H
+
+/*
+ * small_vector<T, N>: keeps up to N elements inline, spills to the heap beyond that.
+ * static_vector<T, N>: same inline storage, never allocates, throws std::length_error when full.
+ *
+ * Both are the same class template with a CanSpill switch, so they share every
+ * member function. The price is that static_vector also carries a pointer and a
+ * capacity it never changes, which is cheaper than maintaining two copies of this file.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "trivially_relocatable.h"
+
+
+template<typename T, std::size_t N, bool CanSpill>
+class _inline_vector {
+    static_assert(N > 0, "inline capacity must be at least 1");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    // opt in to the vector operator<< in vector_like.h
+    using vector_like = std::true_type;
+
+    _inline_vector() noexcept
+    : ptr(inline_data()), cap(N)
+    {}
+
+    explicit _inline_vector(size_type n)
+    : _inline_vector() {
+        resize(n);
+    }
+
+    _inline_vector(size_type n, const T& value)
+    : _inline_vector() {
+        resize(n, value);
+    }
+
+    template<typename It, typename = std::enable_if_t<
+        std::is_base_of_v<std::input_iterator_tag, typename std::iterator_traits<It>::iterator_category>>>
+    _inline_vector(It first, It last)
+    : _inline_vector() {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                        typename std::iterator_traits<It>::iterator_category>) {
+            auto n = static_cast<size_type>(std::distance(first, last));
+            reserve(n);
+            std::uninitialized_copy(first, last, ptr);
+            sz = n;
+        }
+        else {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    _inline_vector(std::initializer_list<T> init)
+    : _inline_vector(init.begin(), init.end())
+    {}
+
+    _inline_vector(const _inline_vector& other)
+    : _inline_vector(other.begin(), other.end())
+    {}
+
+    _inline_vector(_inline_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : _inline_vector() {
+        take(std::move(other));
+    }
+
+    ~_inline_vector() {
+        clear();
+        release();
+    }
+
+    _inline_vector& operator=(const _inline_vector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size());
+            std::uninitialized_copy(other.begin(), other.end(), ptr);
+            sz = other.sz;
+        }
+        return *this;
+    }
+
+    _inline_vector& operator=(_inline_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            release();
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    _inline_vector& operator=(std::initializer_list<T> init) {
+        clear();
+        reserve(init.size());
+        std::uninitialized_copy(init.begin(), init.end(), ptr);
+        sz = init.size();
+        return *this;
+    }
+
+    /***************** element access *****************/
+    reference operator[](size_type i) noexcept { return ptr[i]; }
+    const_reference operator[](size_type i) const noexcept { return ptr[i]; }
+    reference at(size_type i) {
+        if (i >= sz) {
+            throw std::out_of_range("small_vector::at");
+        }
+        return ptr[i];
+    }
+    const_reference at(size_type i) const {
+        return const_cast<_inline_vector*>(this)->at(i);
+    }
+    reference front() noexcept { return ptr[0]; }
+    const_reference front() const noexcept { return ptr[0]; }
+    reference back() noexcept { return ptr[sz - 1]; }
+    const_reference back() const noexcept { return ptr[sz - 1]; }
+    pointer data() noexcept { return ptr; }
+    const_pointer data() const noexcept { return ptr; }
+
+    iterator begin() noexcept { return ptr; }
+    iterator end() noexcept { return ptr + sz; }
+    const_iterator begin() const noexcept { return ptr; }
+    const_iterator end() const noexcept { return ptr + sz; }
+    const_iterator cbegin() const noexcept { return ptr; }
+    const_iterator cend() const noexcept { return ptr + sz; }
+
+    /***************** capacity *****************/
+    size_type size() const noexcept { return sz; }
+    bool empty() const noexcept { return sz == 0; }
+    size_type capacity() const noexcept { return cap; }
+    static constexpr size_type inline_capacity() noexcept { return N; }
+    // false once a small_vector has spilled to the heap
+    bool is_inline() const noexcept { return ptr == inline_data(); }
+
+    void reserve(size_type n) {
+        if (n > cap) {
+            grow(n);
+        }
+    }
+
+    /***************** modifiers *****************/
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (sz == cap) {
+            // args may alias an element we are about to move away, build the value first
+            T tmp(std::forward<Args>(args)...);
+            grow(sz + 1);
+            ::new (static_cast<void*>(ptr + sz)) T(std::move(tmp));
+        }
+        else {
+            ::new (static_cast<void*>(ptr + sz)) T(std::forward<Args>(args)...);
+        }
+        return ptr[sz++];
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() noexcept {
+        ptr[--sz].~T();
+    }
+
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        auto i = static_cast<size_type>(pos - begin());
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(begin() + i, end() - 1, end());
+        return begin() + i;
+    }
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        auto i = static_cast<size_type>(first - begin());
+        auto n = static_cast<size_type>(last - first);
+        std::move(begin() + i + n, end(), begin() + i);
+        while (n--) {
+            pop_back();
+        }
+        return begin() + i;
+    }
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    void resize(size_type n) {
+        reserve(n);
+        while (sz < n) {
+            emplace_back();
+        }
+        while (sz > n) {
+            pop_back();
+        }
+    }
+
+    void resize(size_type n, const T& value) {
+        reserve(n);
+        while (sz < n) {
+            emplace_back(value);
+        }
+        while (sz > n) {
+            pop_back();
+        }
+    }
+
+    void clear() noexcept {
+        std::destroy(ptr, ptr + sz);
+        sz = 0;
+    }
+
+    void swap(_inline_vector& other) {
+        _inline_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+private:
+    T* inline_data() noexcept { return reinterpret_cast<T*>(storage); }
+    const T* inline_data() const noexcept { return reinterpret_cast<const T*>(storage); }
+
+    // relocate into a bigger heap block: memcpy for trivially relocatable T, otherwise
+    // element by element, keeping the strong guarantee if T's copy throws
+    void grow(size_type min_cap) {
+        if constexpr (!CanSpill) {
+            (void) min_cap;
+            throw std::length_error("static_vector capacity exceeded");
+        }
+        else {
+            size_type new_cap = std::max(min_cap, cap * 2);
+            T* new_ptr = static_cast<T*>(::operator new(new_cap * sizeof(T), std::align_val_t{alignof(T)}));
+            if constexpr (is_trivially_relocatable_v<T>) {
+                std::memcpy(static_cast<void*>(new_ptr), static_cast<const void*>(ptr), sz * sizeof(T));
+            }
+            else {
+                size_type done = 0;
+                try {
+                    for (; done < sz; ++done) {
+                        ::new (static_cast<void*>(new_ptr + done)) T(std::move_if_noexcept(ptr[done]));
+                    }
+                }
+                catch (...) {
+                    std::destroy(new_ptr, new_ptr + done);
+                    ::operator delete(new_ptr, std::align_val_t{alignof(T)});
+                    throw;
+                }
+                std::destroy(ptr, ptr + sz);
+            }
+            release();
+            ptr = new_ptr;
+            cap = new_cap;
+        }
+    }
+
+    // free the heap block (elements must already be destroyed) and go back inline
+    void release() noexcept {
+        if (!is_inline()) {
+            ::operator delete(ptr, std::align_val_t{alignof(T)});
+            ptr = inline_data();
+            cap = N;
+        }
+    }
+
+    // *this is empty and inline: steal other's heap block, or move its inline elements
+    void take(_inline_vector&& other) {
+        if (!other.is_inline()) {
+            ptr = other.ptr;
+            cap = other.cap;
+            sz = other.sz;
+            other.ptr = other.inline_data();
+            other.cap = N;
+            other.sz = 0;
+        }
+        else {
+            std::uninitialized_move(other.begin(), other.end(), ptr);
+            sz = other.sz;
+            other.clear();
+        }
+    }
+
+    alignas(T) unsigned char storage[N * sizeof(T)];
+    T* ptr;
+    size_type sz = 0;
+    size_type cap;
+};
+
+
+template<typename T, std::size_t N, bool S>
+bool operator==(const _inline_vector<T, N, S>& a, const _inline_vector<T, N, S>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+}
+template<typename T, std::size_t N, bool S>
+bool operator!=(const _inline_vector<T, N, S>& a, const _inline_vector<T, N, S>& b) {
+    return !(a == b);
+}
+template<typename T, std::size_t N, bool S>
+bool operator<(const _inline_vector<T, N, S>& a, const _inline_vector<T, N, S>& b) {
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+
+template<typename T, std::size_t N>
+using small_vector = _inline_vector<T, N, true>;
+
+template<typename T, std::size_t N>
+using static_vector = _inline_vector<T, N, false>;
+
+
+#endif //EFFECTIVECPP_SMALL_VECTOR_H
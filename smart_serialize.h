@@ -0,0 +1,143 @@
+#ifndef EFFECTIVECPP_SMART_SERIALIZE_H
+#define EFFECTIVECPP_SMART_SERIALIZE_H
+
+/*
+ * The smart_serialize experiments from boost_hana.cpp, shared with the benchmarks.
+ * smart_serializeN(x) calls x.serialize() if it exists and falls back to any_str(x).
+ * The memo_ versions at the end remember their results (memoize.h).
+ */
+#include <string>
+#include <variant>
+#include <boost/hana.hpp>
+#include "utils.h"
+#include "animals.h"
+#include "thread_pool.h"
+#include "memoize.h"
+
+namespace hana = boost::hana;
+
+
+/*
+ * check if serialize exists
+ */
+inline auto is_serializable = hana::is_valid([](auto&& x) -> decltype((void) x.serialize()) { });
+
+template<typename T>
+string smart_serialize1(const T& obj) {
+    if constexpr (decltype(is_serializable(obj))::value) {
+        return obj.serialize();
+    }
+    else {
+        return any_str(obj);
+    }
+}
+
+/*
+ * Equivalent, using hana::sfinae compile time optional
+ */
+inline auto maybe_serialize = hana::sfinae([](auto&& x) -> decltype(x.serialize()) {
+    return x.serialize();
+});
+
+template<typename T>
+string smart_serialize2(const T& obj) {
+    return maybe_serialize(obj).value_or(any_str(obj));
+}
+
+template<typename T>
+string smart_serialize3(const T& obj) {
+    auto ans = maybe_serialize(obj);
+    if constexpr (hana::is_just(ans)) {
+//        return ans.value();  // must if-constexpr, otherwise .value() won't compile
+        return *ans;  // equivalent to ans.value()
+    }
+    else {  // hana::is_nothing
+        return any_str(obj);
+    }
+}
+
+template<typename T>
+string smart_serialize4(T&& obj) {
+    return hana::if_(
+        is_serializable(obj),
+        [](auto&& obj) { return obj.serialize(); },
+        [](auto&& obj) { return any_str(obj); }
+    )(std::forward<T>(obj));
+}
+
+template<typename T>
+string smart_serialize5(T&& obj) {
+    return hana::eval_if(
+        is_serializable(obj),
+        // explanation for `_` see below
+        [&](auto _) { return _(obj).serialize(); },
+        [&](auto _) { return any_str(_(obj)); }
+    );
+}
+
+
+// a heterogeneous batch is a range of variants, each alternative serialized on its own
+template<typename... Ts>
+string smart_serialize1(const std::variant<Ts...>& obj) {
+    return std::visit([](const auto& x) { return smart_serialize1(x); }, obj);
+}
+
+
+/*
+ * Batch version: out[i] = smart_serialize1(in[i]) with the range split across the pool.
+ * grain = 0 lets the pool pick the chunk size from a timed probe.
+ */
+template<typename InIt, typename OutIt>
+OutIt parallel_smart_serialize(thread_pool& pool, InIt first, InIt last, OutIt out, std::size_t grain = 0) {
+    return pool.parallel_transform(first, last, out, [](const auto& x) { return smart_serialize1(x); }, grain);
+}
+
+template<typename Range>
+vector<string> parallel_smart_serialize(thread_pool& pool, const Range& range, std::size_t grain = 0) {
+    vector<string> out(std::size(range));
+    parallel_smart_serialize(pool, std::begin(range), std::end(range), out.begin(), grain);
+    return out;
+}
+
+
+/*
+ * Memoized: one cache per argument type, shared by all threads, default
+ * cache_options (1 MB in 16 shards). The argument types must be fast_hash-able.
+ */
+template<typename T>
+auto& smart_serialize_memo() {
+    static auto memo = memoize<const T&>([](const T& x) { return smart_serialize1(x); });
+    return memo;
+}
+
+template<typename T>
+string memo_smart_serialize(const T& obj) {
+    return smart_serialize_memo<T>()(obj);
+}
+
+// per alternative, so every alternative shares the cache of its plain type
+template<typename... Ts>
+string memo_smart_serialize(const std::variant<Ts...>& obj) {
+    return std::visit([](const auto& x) { return memo_smart_serialize(x); }, obj);
+}
+
+template<typename TupleT>
+auto& tuple_str_memo() {
+    static auto memo = memoize<const TupleT&>([](const TupleT& tup) { return tuple_str(tup); });
+    return memo;
+}
+
+template<typename TupleT>
+string memo_tuple_str(const TupleT& tup) {
+    return tuple_str_memo<TupleT>()(tup);
+}
+
+// no arguments, one answer per T: a static is the whole cache
+template<typename T>
+const string& memo_type_str() {
+    static const string name = type_str<T>();
+    return name;
+}
+
+
+#endif //EFFECTIVECPP_SMART_SERIALIZE_H
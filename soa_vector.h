@@ -0,0 +1,336 @@
+#ifndef EFFECTIVECPP_SOA_VECTOR_H
+#define EFFECTIVECPP_SOA_VECTOR_H
+
+/*
+ * soa_vector<T>: struct-of-arrays storage for any hana Struct, i.e. a type declared
+ * with BOOST_HANA_DEFINE_STRUCT or adapted with BOOST_HANA_ADAPT_STRUCT.
+ *
+ *   soa_vector<Critter> zoo;
+ *   zoo.push_back(Critter{"nemo", 3, 0.2f});
+ *   zoo[0].get<1>() += 1;                          // proxy row, references into the columns
+ *   zoo[0][BOOST_HANA_STRING("age")] += 1;         // same, by member name
+ *   Critter c = zoo[0];                            // assembles a copy
+ *   for (int age : zoo.column<1>()) ...            // contiguous ints, nothing else loaded
+ *   zoo.for_each_column([](const char* name, auto col) { ... });
+ *
+ * Every member gets its own 64-byte aligned vector, the generalization of what
+ * PointCloud (point_cloud.h) does by hand for Point. bool members are rejected:
+ * vector<bool> packs bits and can't hand out references or a contiguous span.
+ */
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/hana.hpp>
+#include "aligned_allocator.h"
+
+namespace hana = boost::hana;
+
+
+// pointer + length over one column, the part of C++20 std::span needed here
+template<typename T>
+class column_span {
+public:
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+    // opt in to the vector operator<< in vector_like.h
+    using vector_like = std::true_type;
+
+    constexpr column_span() noexcept = default;
+    constexpr column_span(T* ptr, std::size_t n) noexcept
+    : ptr(ptr), n(n)
+    {}
+
+    constexpr T* data() const noexcept { return ptr; }
+    constexpr std::size_t size() const noexcept { return n; }
+    constexpr bool empty() const noexcept { return n == 0; }
+    constexpr T& operator[](std::size_t i) const noexcept { return ptr[i]; }
+    constexpr T* begin() const noexcept { return ptr; }
+    constexpr T* end() const noexcept { return ptr + n; }
+
+private:
+    T* ptr = nullptr;
+    std::size_t n = 0;
+};
+
+
+namespace soa_detail {
+    template<typename T, std::size_t I>
+    using accessor_t = std::decay_t<decltype(hana::at_c<I>(hana::accessors<T>()))>;
+
+    // type and compile-time name (a hana::string) of member I
+    template<typename T, std::size_t I>
+    using member_t = std::decay_t<decltype(hana::second(std::declval<accessor_t<T, I>>())(std::declval<T&>()))>;
+    template<typename T, std::size_t I>
+    using name_t = std::decay_t<decltype(hana::first(std::declval<accessor_t<T, I>>()))>;
+
+    template<typename T>
+    constexpr std::size_t member_count = decltype(hana::length(hana::accessors<T>()))::value;
+
+    template<typename M>
+    using column_t = std::vector<M, aligned_allocator<M, 64>>;
+
+    template<typename T, typename Seq = std::make_index_sequence<member_count<T>>>
+    struct columns;
+    template<typename T, std::size_t... I>
+    struct columns<T, std::index_sequence<I...>> {
+        using type = std::tuple<column_t<member_t<T, I>>...>;
+    };
+
+    // index of the member called Name, member_count<T> if there is none
+    template<typename T, typename Name, std::size_t... I>
+    constexpr std::size_t find_member(std::index_sequence<I...>) {
+        std::size_t found = sizeof...(I);
+        ((std::is_same_v<Name, name_t<T, I>> ? (found = I, true) : false) || ...);
+        return found;
+    }
+    template<typename T, typename Name>
+    constexpr std::size_t index_of = find_member<T, Name>(std::make_index_sequence<member_count<T>>{});
+}
+
+
+template<typename Soa>
+class soa_row;
+
+
+template<typename T>
+class soa_vector {
+    static_assert(hana::Struct<T>::value,
+                  "soa_vector needs BOOST_HANA_DEFINE_STRUCT or BOOST_HANA_ADAPT_STRUCT on T");
+
+    using storage_t = typename soa_detail::columns<T>::type;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = soa_row<soa_vector>;
+    using const_reference = soa_row<const soa_vector>;
+    static constexpr std::size_t num_members = soa_detail::member_count<T>;
+
+    template<std::size_t I>
+    using member_type = soa_detail::member_t<T, I>;
+
+    template<typename Name>
+    static constexpr std::size_t index_of(Name) noexcept {
+        constexpr std::size_t i = soa_detail::index_of<T, Name>;
+        static_assert(i < num_members, "T has no member with this name");
+        return i;
+    }
+
+    /***************** rows *****************/
+    size_type size() const noexcept { return std::get<0>(columns).size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    void reserve(size_type n) {
+        std::apply([n](auto&... cols) { (cols.reserve(n), ...); }, columns);
+    }
+    void clear() noexcept {
+        std::apply([](auto&... cols) { (cols.clear(), ...); }, columns);
+    }
+    void pop_back() {
+        std::apply([](auto&... cols) { (cols.pop_back(), ...); }, columns);
+    }
+
+    void push_back(const T& value) {
+        push_row(value, std::make_index_sequence<num_members>{});
+    }
+    void push_back(T&& value) {
+        push_row(std::move(value), std::make_index_sequence<num_members>{});
+    }
+
+    // proxy for row i: get<I>() and operator[](name) return references into the columns
+    reference operator[](size_type i) noexcept { return reference(*this, i); }
+    const_reference operator[](size_type i) const noexcept { return const_reference(*this, i); }
+
+    // a copy of row i as a T
+    T load(size_type i) const {
+        return load_row(i, std::make_index_sequence<num_members>{});
+    }
+    void store(size_type i, const T& value) {
+        store_row(i, value, std::make_index_sequence<num_members>{});
+    }
+
+    /***************** columns *****************/
+    template<std::size_t I>
+    column_span<member_type<I>> column() noexcept {
+        auto& col = std::get<I>(columns);
+        return {col.data(), col.size()};
+    }
+    template<std::size_t I>
+    column_span<const member_type<I>> column() const noexcept {
+        auto& col = std::get<I>(columns);
+        return {col.data(), col.size()};
+    }
+
+    // by name: zoo.column(BOOST_HANA_STRING("age"))
+    template<typename Name>
+    auto column(Name name) noexcept { return column<index_of(name)>(); }
+    template<typename Name>
+    auto column(Name name) const noexcept { return column<index_of(name)>(); }
+
+    // f(name, column_span) for every member in declaration order
+    template<typename F>
+    void for_each_column(F&& f) {
+        each_column(*this, f, std::make_index_sequence<num_members>{});
+    }
+    template<typename F>
+    void for_each_column(F&& f) const {
+        each_column(*this, f, std::make_index_sequence<num_members>{});
+    }
+
+    // bytes of the column arrays; heap memory the members own (string contents) is not counted
+    size_type memory_bytes() const noexcept {
+        return std::apply([](const auto&... cols) {
+            return (size_type{0} + ... + (cols.capacity() * sizeof(typename std::decay_t<decltype(cols)>::value_type)));
+        }, columns);
+    }
+
+    /***************** iteration *****************/
+    template<typename Soa>
+    class row_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = soa_row<Soa>;
+        using pointer = void;
+
+        row_iterator(Soa& soa, size_type i) noexcept
+        : soa(&soa), i(i)
+        {}
+
+        reference operator*() const noexcept { return reference(*soa, i); }
+        row_iterator& operator++() noexcept { ++i; return *this; }
+        row_iterator operator++(int) noexcept { auto old = *this; ++i; return old; }
+        bool operator==(const row_iterator& other) const noexcept { return i == other.i; }
+        bool operator!=(const row_iterator& other) const noexcept { return i != other.i; }
+
+    private:
+        Soa* soa;
+        size_type i;
+    };
+
+    row_iterator<soa_vector> begin() noexcept { return {*this, 0}; }
+    row_iterator<soa_vector> end() noexcept { return {*this, size()}; }
+    row_iterator<const soa_vector> begin() const noexcept { return {*this, 0}; }
+    row_iterator<const soa_vector> end() const noexcept { return {*this, size()}; }
+
+private:
+    template<typename Soa>
+    friend class soa_row;
+
+    template<std::size_t I>
+    static void check_member() {
+        static_assert(!std::is_same_v<member_type<I>, bool>, "bool members can't be stored as a column");
+    }
+
+    template<typename U, std::size_t... I>
+    void push_row(U&& value, std::index_sequence<I...>) {
+        (check_member<I>(), ...);
+        // a throwing member copy would leave the columns ragged, trim back to the old size
+        size_type old = size();
+        try {
+            (push_member<I>(std::forward<U>(value)), ...);
+        }
+        catch (...) {
+            ((std::get<I>(columns).size() > old ? std::get<I>(columns).pop_back() : void()), ...);
+            throw;
+        }
+    }
+
+    // moves the member out of an rvalue row, copies it otherwise
+    template<std::size_t I, typename U>
+    void push_member(U&& value) {
+        auto& member = hana::second(hana::at_c<I>(hana::accessors<T>()))(value);
+        if constexpr (std::is_rvalue_reference_v<U&&>) {
+            std::get<I>(columns).push_back(std::move(member));
+        }
+        else {
+            std::get<I>(columns).push_back(member);
+        }
+    }
+
+    template<std::size_t... I>
+    T load_row(size_type i, std::index_sequence<I...>) const {
+        T value {};
+        ((hana::second(hana::at_c<I>(hana::accessors<T>()))(value) = std::get<I>(columns)[i]), ...);
+        return value;
+    }
+
+    template<std::size_t... I>
+    void store_row(size_type i, const T& value, std::index_sequence<I...>) {
+        ((std::get<I>(columns)[i] = hana::second(hana::at_c<I>(hana::accessors<T>()))(value)), ...);
+    }
+
+    template<typename Self, typename F, std::size_t... I>
+    static void each_column(Self& self, F& f, std::index_sequence<I...>) {
+        (f(hana::to<const char*>(soa_detail::name_t<T, I>{}), self.template column<I>()), ...);
+    }
+
+    storage_t columns;
+};
+
+
+/*
+ * Row i of a soa_vector (or of a const one). Holds the container and the index,
+ * so it stays valid across push_back; converting to T copies the row out.
+ */
+template<typename Soa>
+class soa_row {
+    using vector_type = std::remove_const_t<Soa>;
+    using T = typename vector_type::value_type;
+    static constexpr bool is_const = std::is_const_v<Soa>;
+
+public:
+    soa_row(Soa& soa, std::size_t i) noexcept
+    : soa(&soa), i(i)
+    {}
+
+    std::size_t index() const noexcept { return i; }
+
+    template<std::size_t I>
+    decltype(auto) get() const noexcept { return std::get<I>(soa->columns)[i]; }
+
+    template<typename Name>
+    decltype(auto) operator[](Name name) const noexcept { return get<vector_type::index_of(name)>(); }
+
+    T load() const { return soa->load(i); }
+    operator T() const { return load(); }
+
+    template<bool C = is_const, typename = std::enable_if_t<!C>>
+    const soa_row& operator=(const T& value) const {
+        soa->store(i, value);
+        return *this;
+    }
+
+    // v[0] = v[1] copies the row, member by member; it doesn't rebind the proxy
+    const soa_row& operator=(const soa_row& other) const {
+        static_assert(!is_const, "rows of a const soa_vector can't be assigned to");
+        assign_row(other, std::make_index_sequence<vector_type::num_members>{});
+        return *this;
+    }
+    template<bool C = is_const, typename = std::enable_if_t<!C>>
+    const soa_row& operator=(const soa_row<const vector_type>& other) const {
+        assign_row(other, std::make_index_sequence<vector_type::num_members>{});
+        return *this;
+    }
+
+private:
+    template<typename Row, std::size_t... I>
+    void assign_row(const Row& other, std::index_sequence<I...>) const {
+        ((get<I>() = other.template get<I>()), ...);
+    }
+
+    Soa* soa;
+    std::size_t i;
+};
+
+template<std::size_t I, typename Soa>
+decltype(auto) get(const soa_row<Soa>& row) noexcept {
+    return row.template get<I>();
+}
+
+
+#endif //EFFECTIVECPP_SOA_VECTOR_H
@@ -0,0 +1,68 @@
+/*
+ * Layout report for the plain structs of the headers: size, member offsets,
+ * padding, and what packed<T> (struct_layout.h) saves by reordering.
+ * The Marker-derived fruits report themselves in ch4_smartpointers.
+ */
+#include "utils.h"
+#include <boost/hana.hpp>
+#include "animals.h"
+#include "pipeline.h"
+#include "struct_layout.h"
+
+BOOST_HANA_ADAPT_STRUCT(stage_stats, name, items, busy_ms, waits);
+BOOST_HANA_ADAPT_STRUCT(pipeline_stats, stages, items, wall_ms, mean_latency_us, max_latency_us);
+BOOST_HANA_ADAPT_STRUCT(pipeline_options, replicas, capacity, batch);
+BOOST_HANA_ADAPT_STRUCT(intern_pool::stats, strings, text_bytes, arena_bytes, index_bytes);
+BOOST_HANA_ADAPT_STRUCT(vec_summary, threshold, edge_items);
+BOOST_HANA_ADAPT_STRUCT(layout_report::field, name, index, offset, size, align);
+
+// a record the way it tends to get written: fields in the order they were thought of
+struct Order {
+    bool express;
+    double price;
+    int quantity;
+    char currency;
+    long id;
+    short warehouse;
+};
+BOOST_HANA_ADAPT_STRUCT(Order, express, price, quantity, currency, id, warehouse);
+
+
+int main() {
+    ptitle("animals.h");
+    cout << layout_of<Fish>() << endl;
+    cout << layout_of<Cat>() << endl;
+    cout << layout_of<Dog>() << endl;
+    cout << layout_of<IFish>() << endl;
+    cout << layout_of<ICat>() << endl;
+    cout << layout_of<IDog>() << endl;
+
+    ptitle("pipeline.h");
+    cout << layout_of<stage_stats>() << endl;
+    cout << layout_of<pipeline_stats>() << endl;
+    cout << layout_of<pipeline_options>() << endl;
+
+    ptitle("intern_pool.h, utils.h, struct_layout.h");
+    cout << layout_of<intern_pool::stats>() << endl;
+    cout << layout_of<vec_summary>() << endl;
+    cout << layout_of<layout_report::field>() << endl;
+
+    ptitle("reordering");
+    cout << layout_of<Order>() << endl;
+    Order o {true, 9.99, 3, 'E', 1001, 7};
+    packed<Order> p(o);
+    cout << "packed<Order>: " << sizeof(p) << " bytes, price at " << packed<Order>::offset_of<1>()
+         << ", express at " << packed<Order>::offset_of<0>() << endl;
+    p[BOOST_HANA_STRING("quantity")] += 2;
+    packed<Order> copy = p;
+    Order back = copy.load();
+    cout << "round trip: id " << back.id << " quantity " << back.quantity << " price " << back.price
+         << " currency " << back.currency << " express " << back.express << endl;
+
+    vector<packed<stage_stats>> stats(2);
+    stats[0].get<0>() = "dispatch";
+    stats.push_back(stats[0]);
+    cout << stats.size() << " packed stage_stats of " << sizeof(stats[0]) << " bytes, last "
+         << stats.back()[BOOST_HANA_STRING("name")] << endl;
+    return 0;
+}
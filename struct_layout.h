@@ -0,0 +1,307 @@
+#ifndef EFFECTIVECPP_STRUCT_LAYOUT_H
+#define EFFECTIVECPP_STRUCT_LAYOUT_H
+
+/*
+ * Layout of hana Structs: where every member sits, and how much is padding.
+ *
+ *   cout << layout_of<Apple>();                  // size, alignment, offsets, holes
+ *   packed<Apple> p(apple);                      // the members in a padding-free order
+ *   p.get<0>();  p[BOOST_HANA_STRING("id")];     // still by original index and name
+ *
+ * Sizes, alignments and the reordering are worked out at compile time. The
+ * offsets of T's own members are taken at run time, by applying the hana
+ * accessors to raw storage without constructing anything, which is how
+ * offsetof works and why it also handles classes with bases and virtual
+ * functions. The bytes before the first member (bases, the vptr) are reported
+ * as such: hana only sees the members that were adapted.
+ *
+ * packed<T> keeps the members in one aligned byte buffer, sorted by decreasing
+ * alignment, so only the tail can be padding. Members are constructed, copied,
+ * moved and destroyed one by one, in original order.
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/hana.hpp>
+#include <boost/type_index.hpp>
+#include "soa_vector.h"
+
+namespace hana = boost::hana;
+
+
+struct layout_report {
+    struct field {
+        std::string name;
+        std::size_t index;   // declaration order
+        std::size_t offset;
+        std::size_t size;
+        std::size_t align;
+    };
+
+    std::string type;
+    std::size_t size = 0;
+    std::size_t align = 0;
+    std::vector<field> fields;   // in offset order
+    std::size_t packed_size = 0; // the members alone, in the order packed<T> uses
+
+    // bytes before the first member: bases and the vptr
+    std::size_t leading() const noexcept { return fields.empty() ? size : fields.front().offset; }
+    std::size_t member_bytes() const noexcept {
+        std::size_t n = 0;
+        for (auto& f : fields) {
+            n += f.size;
+        }
+        return n;
+    }
+    // holes between members plus the tail
+    std::size_t padding() const noexcept { return size - leading() - member_bytes(); }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const layout_report& r) {
+    os << r.type << ": " << r.size << " bytes, align " << r.align << ", " << r.padding() << " bytes of padding\n";
+    char line[160];
+    std::size_t at = 0;
+    auto gap = [&](std::size_t to, const char* what) {
+        if (to > at) {
+            std::snprintf(line, sizeof(line), "  %4zu  [%zu bytes of %s]\n", at, to - at, what);
+            os << line;
+        }
+    };
+    for (auto& f : r.fields) {
+        gap(f.offset, at == 0 ? "bases / vptr" : "padding");
+        std::snprintf(line, sizeof(line), "  %4zu  %s: %zu bytes, align %zu\n",
+                      f.offset, f.name.c_str(), f.size, f.align);
+        os << line;
+        at = f.offset + f.size;
+    }
+    gap(r.size, r.fields.empty() ? "bases / vptr" : "padding");
+    std::size_t span = r.size - r.leading();
+    if (r.packed_size < span) {
+        return os << "  members reordered: " << r.packed_size << " bytes instead of " << span;
+    }
+    return os << "  members already packed";
+}
+
+
+namespace layout_detail {
+    using soa_detail::member_count;
+    using soa_detail::member_t;
+    using soa_detail::name_t;
+
+    constexpr std::size_t round_up(std::size_t n, std::size_t align) noexcept {
+        return (n + align - 1) / align * align;
+    }
+
+    template<typename T, std::size_t... I>
+    struct plan {
+        static constexpr std::size_t N = sizeof...(I);
+        static constexpr std::size_t sizes[N ? N : 1] = {sizeof(member_t<T, I>)...};
+        static constexpr std::size_t aligns[N ? N : 1] = {alignof(member_t<T, I>)...};
+
+        // member indices by decreasing alignment, declaration order among equals
+        static constexpr std::array<std::size_t, N> make_order() noexcept {
+            std::array<std::size_t, N> order {};
+            for (std::size_t i = 0; i < N; ++i) {
+                order[i] = i;
+            }
+            for (std::size_t i = 1; i < N; ++i) {
+                for (std::size_t j = i; j > 0 && aligns[order[j]] > aligns[order[j - 1]]; --j) {
+                    std::size_t tmp = order[j];
+                    order[j] = order[j - 1];
+                    order[j - 1] = tmp;
+                }
+            }
+            return order;
+        }
+        static constexpr std::array<std::size_t, N> order = make_order();
+
+        // offset of every member, by declaration index
+        static constexpr std::array<std::size_t, N> make_offsets() noexcept {
+            std::array<std::size_t, N> offsets {};
+            std::size_t at = 0;
+            for (std::size_t i : order) {
+                at = round_up(at, aligns[i]);
+                offsets[i] = at;
+                at += sizes[i];
+            }
+            return offsets;
+        }
+        static constexpr std::array<std::size_t, N> offsets = make_offsets();
+
+        static constexpr std::size_t ALIGN = std::max({std::size_t{1}, alignof(member_t<T, I>)...});
+        static constexpr std::size_t SIZE = N ? round_up(offsets[order[N - 1]] + sizes[order[N - 1]], ALIGN) : 1;
+    };
+
+    template<typename T, typename Seq = std::make_index_sequence<member_count<T>>>
+    struct plan_of;
+    template<typename T, std::size_t... I>
+    struct plan_of<T, std::index_sequence<I...>> {
+        using type = plan<T, I...>;
+    };
+}
+
+
+/*
+ * The members of T, reordered to leave no holes. Not a T: no bases, no virtual
+ * functions, just the data, reached by T's member indices and names.
+ */
+template<typename T>
+class packed {
+    static_assert(hana::Struct<T>::value, "packed needs BOOST_HANA_DEFINE_STRUCT or BOOST_HANA_ADAPT_STRUCT on T");
+
+    using plan = typename layout_detail::plan_of<T>::type;
+    using indices = std::make_index_sequence<plan::N>;
+
+public:
+    static constexpr std::size_t num_members = plan::N;
+
+    template<std::size_t I>
+    using member_type = layout_detail::member_t<T, I>;
+
+    template<typename Name>
+    static constexpr std::size_t index_of(Name) noexcept {
+        constexpr std::size_t i = soa_detail::index_of<T, Name>;
+        static_assert(i < num_members, "T has no member with this name");
+        return i;
+    }
+
+    template<std::size_t I>
+    static constexpr std::size_t offset_of() noexcept { return plan::offsets[I]; }
+
+    // members value-initialized
+    packed() {
+        construct(indices{}, [](auto i) { return member_type<decltype(i)::value>(); });
+    }
+    explicit packed(const T& x) {
+        construct(indices{}, [&x](auto i) { return member_type<decltype(i)::value>(member(x, i)); });
+    }
+    explicit packed(T&& x) {
+        construct(indices{}, [&x](auto i) { return member_type<decltype(i)::value>(std::move(member(x, i))); });
+    }
+    packed(const packed& other) {
+        construct(indices{}, [&other](auto i) { return member_type<decltype(i)::value>(other.get<i>()); });
+    }
+    packed(packed&& other) noexcept(all_nothrow_move(indices{})) {
+        construct(indices{}, [&other](auto i) {
+            return member_type<decltype(i)::value>(std::move(other.get<i>()));
+        });
+    }
+
+    packed& operator=(const packed& other) {
+        for_each_member([&](auto i) { get<i>() = other.get<i>(); });
+        return *this;
+    }
+    packed& operator=(packed&& other) noexcept(all_nothrow_move_assign(indices{})) {
+        for_each_member([&](auto i) { get<i>() = std::move(other.get<i>()); });
+        return *this;
+    }
+
+    ~packed() {
+        for_each_member([this](auto i) { std::destroy_at(&get<i>()); });
+    }
+
+    template<std::size_t I>
+    member_type<I>& get() noexcept {
+        return *std::launder(reinterpret_cast<member_type<I>*>(bytes + plan::offsets[I]));
+    }
+    template<std::size_t I>
+    const member_type<I>& get() const noexcept {
+        return *std::launder(reinterpret_cast<const member_type<I>*>(bytes + plan::offsets[I]));
+    }
+
+    template<typename Name>
+    decltype(auto) operator[](Name name) noexcept { return get<index_of(name)>(); }
+    template<typename Name>
+    decltype(auto) operator[](Name name) const noexcept { return get<index_of(name)>(); }
+
+    // copy the members back into x
+    void store(T& x) const {
+        for_each_member([&](auto i) { member(x, i) = get<i>(); });
+    }
+    // a default constructed T with the members copied in
+    T load() const {
+        T x {};
+        store(x);
+        return x;
+    }
+
+private:
+    template<typename U, typename I>
+    static decltype(auto) member(U& x, I) {
+        return hana::second(hana::at_c<I::value>(hana::accessors<T>()))(x);
+    }
+
+    template<typename F>
+    void for_each_member(F&& f) const {
+        for_each_member_impl(f, indices{});
+    }
+    template<typename F, std::size_t... I>
+    static void for_each_member_impl(F& f, std::index_sequence<I...>) {
+        (f(std::integral_constant<std::size_t, I>{}), ...);
+    }
+
+    // make(i) returns member i by value, constructed straight into place; if one
+    // throws, the members built before it are destroyed and the exception goes on
+    template<std::size_t... I, typename Make>
+    void construct(std::index_sequence<I...>, Make&& make) {
+        std::size_t built = 0;
+        try {
+            ((::new (static_cast<void*>(bytes + plan::offsets[I]))
+                member_type<I>(make(std::integral_constant<std::size_t, I>{})), ++built), ...);
+        }
+        catch (...) {
+            destroy_first(built, indices{});
+            throw;
+        }
+    }
+    template<std::size_t... I>
+    void destroy_first(std::size_t n, std::index_sequence<I...>) noexcept {
+        ((I < n ? std::destroy_at(&get<I>()) : void()), ...);
+    }
+
+    template<std::size_t... I>
+    static constexpr bool all_nothrow_move(std::index_sequence<I...>) noexcept {
+        return (std::is_nothrow_move_constructible_v<member_type<I>> && ...);
+    }
+    template<std::size_t... I>
+    static constexpr bool all_nothrow_move_assign(std::index_sequence<I...>) noexcept {
+        return (std::is_nothrow_move_assignable_v<member_type<I>> && ...);
+    }
+
+    alignas(plan::ALIGN) unsigned char bytes[plan::SIZE];
+};
+
+
+template<typename T>
+layout_report layout_of() {
+    static_assert(hana::Struct<T>::value, "layout_of needs BOOST_HANA_DEFINE_STRUCT or BOOST_HANA_ADAPT_STRUCT on T");
+    layout_report r;
+    r.type = boost::typeindex::type_id<T>().pretty_name();
+    r.size = sizeof(T);
+    r.align = alignof(T);
+    r.packed_size = sizeof(packed<T>);
+
+    // addresses only, nothing is read or constructed
+    alignas(T) unsigned char raw[sizeof(T)];
+    T& probe = *reinterpret_cast<T*>(raw);
+    std::size_t index = 0;
+    hana::for_each(hana::accessors<T>(), [&](auto acc) {
+        auto& m = hana::second(acc)(probe);
+        using M = std::decay_t<decltype(m)>;
+        auto offset = static_cast<std::size_t>(reinterpret_cast<const unsigned char*>(std::addressof(m)) - raw);
+        r.fields.push_back({hana::to<const char*>(hana::first(acc)), index++, offset, sizeof(M), alignof(M)});
+    });
+    std::sort(r.fields.begin(), r.fields.end(), [](auto& a, auto& b) { return a.offset < b.offset; });
+    return r;
+}
+
+
+#endif //EFFECTIVECPP_STRUCT_LAYOUT_H
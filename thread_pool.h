@@ -0,0 +1,285 @@
+#ifndef EFFECTIVECPP_THREAD_POOL_H
+#define EFFECTIVECPP_THREAD_POOL_H
+
+/*
+ * Work-stealing thread pool.
+ *
+ *   thread_pool pool;                                   // one worker per core
+ *   auto f = pool.submit([] { return 42; });            // std::future<int>
+ *   pool.parallel_for(0, n, [&](size_t i) { ... });
+ *   pool.parallel_transform(in.begin(), in.end(), out.begin(), fn);
+ *
+ * Every worker owns a deque: it pushes and pops its own tasks at the back (LIFO,
+ * cache-warm) and, when empty, steals from the front of the others (FIFO, the
+ * oldest and usually biggest pieces). Tasks submitted from outside the pool are
+ * dealt round-robin. A thread waiting in parallel_for runs queued tasks instead of
+ * blocking, so nested parallel_for calls from inside a task can't deadlock.
+ *
+ * Each deque has its own mutex rather than a lock-free Chase-Lev deque: tasks here
+ * are chunks of thousands of elements, so the lock is never the bottleneck.
+ *
+ * grain = 0 means auto-tune: the caller times the first few elements itself and
+ * sizes chunks to about CHUNK_TARGET of work each, with at least 4 chunks per worker.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+class thread_pool {
+public:
+    static constexpr std::chrono::microseconds CHUNK_TARGET {100};
+
+    explicit thread_pool(unsigned threads = std::thread::hardware_concurrency()) {
+        threads = std::max(1u, threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            queues.push_back(std::make_unique<worker_queue>());
+        }
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    // runs everything already queued, then joins
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> guard(sleep_mutex);
+            stopping = true;
+        }
+        wakeup.notify_all();
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    unsigned size() const noexcept { return static_cast<unsigned>(workers.size()); }
+
+    template<typename F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        std::packaged_task<R()> job(std::forward<F>(f));
+        auto result = job.get_future();
+        push(make_task(std::move(job)));
+        return result;
+    }
+
+    // f(i) for every i in [first, last)
+    template<typename Index, typename F>
+    void parallel_for(Index first, Index last, F&& f, std::size_t grain = 0) {
+        static_assert(std::is_integral_v<Index>, "parallel_for runs over an index range");
+        if (first >= last) {
+            return;
+        }
+        auto n = static_cast<std::size_t>(last - first);
+        std::size_t done = 0;
+        if (grain == 0) {
+            // probe on the calling thread, the probed elements count as done
+            std::size_t probe = std::min<std::size_t>(n, 16);
+            auto start = std::chrono::steady_clock::now();
+            for (; done < probe; ++done) {
+                f(first + static_cast<Index>(done));
+            }
+            grain = auto_grain(n - done, std::chrono::steady_clock::now() - start, probe);
+        }
+        tuned_grain.store(grain, std::memory_order_relaxed);
+
+        batch state;
+        for (std::size_t begin = done; begin < n; begin += grain) {
+            std::size_t end = std::min(n, begin + grain);
+            state.remaining.fetch_add(1, std::memory_order_relaxed);
+            push(make_task([&state, &f, first, begin, end] {
+                try {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        f(first + static_cast<Index>(i));
+                    }
+                }
+                catch (...) {
+                    state.fail(std::current_exception());
+                }
+                state.remaining.fetch_sub(1, std::memory_order_release);
+            }));
+        }
+        help_until([&state] { return state.remaining.load(std::memory_order_acquire) == 0; });
+        if (state.error) {
+            std::rethrow_exception(state.error);
+        }
+    }
+
+    // *(out + i) = f(*(first + i)), random access iterators, returns the end of the output
+    template<typename InIt, typename OutIt, typename F>
+    OutIt parallel_transform(InIt first, InIt last, OutIt out, F&& f, std::size_t grain = 0) {
+        static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                        typename std::iterator_traits<InIt>::iterator_category>,
+                      "parallel_transform needs random access input");
+        auto n = static_cast<std::size_t>(std::distance(first, last));
+        parallel_for(std::size_t{0}, n, [&](std::size_t i) {
+            out[static_cast<std::ptrdiff_t>(i)] = f(first[static_cast<std::ptrdiff_t>(i)]);
+        }, grain);
+        return out + static_cast<std::ptrdiff_t>(n);
+    }
+
+    // chunk size the last parallel_for picked, handy for printing the auto-tuned value
+    std::size_t last_grain() const noexcept { return tuned_grain.load(std::memory_order_relaxed); }
+
+private:
+    struct task {
+        virtual ~task() = default;
+        virtual void run() = 0;
+    };
+    using task_ptr = std::unique_ptr<task>;
+
+    template<typename F>
+    struct task_impl : task {
+        explicit task_impl(F f)
+        : f(std::move(f))
+        {}
+        void run() override { f(); }
+        F f;
+    };
+
+    template<typename F>
+    static task_ptr make_task(F&& f) {
+        return std::make_unique<task_impl<std::decay_t<F>>>(std::forward<F>(f));
+    }
+
+    struct worker_queue {
+        std::mutex mutex;
+        std::deque<task_ptr> tasks;
+    };
+
+    // one parallel_for call: chunks still running and the first exception thrown
+    struct batch {
+        std::atomic<std::size_t> remaining {0};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        void fail(std::exception_ptr e) {
+            std::lock_guard<std::mutex> guard(error_mutex);
+            if (!error) {
+                error = e;
+            }
+        }
+    };
+
+    std::size_t auto_grain(std::size_t left, std::chrono::steady_clock::duration probe_time,
+                           std::size_t probe) const {
+        if (left == 0) {
+            return 1;
+        }
+        double per_item = std::chrono::duration<double, std::nano>(probe_time).count() / probe;
+        double target = std::chrono::duration<double, std::nano>(CHUNK_TARGET).count();
+        auto by_cost = static_cast<std::size_t>(target / std::max(per_item, 1.0));
+        std::size_t by_balance = (left + 4 * size() - 1) / (4 * size());
+        return std::max<std::size_t>(1, std::min(by_cost, by_balance));
+    }
+
+    // index of the calling thread's own deque, or -1 outside this pool
+    int self_index() const noexcept {
+        return current_pool == this ? current_index : -1;
+    }
+
+    void push(task_ptr t) {
+        int self = self_index();
+        std::size_t qi = self >= 0 ? static_cast<std::size_t>(self)
+                                   : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        // count first: a thief may take the task before we return, it must never see pending == 0
+        pending.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> guard(queues[qi]->mutex);
+            queues[qi]->tasks.push_back(std::move(t));
+        }
+        {
+            std::lock_guard<std::mutex> guard(sleep_mutex);  // pairs with the predicate check in worker_loop
+        }
+        wakeup.notify_one();
+    }
+
+    // own deque from the back first, then steal from the front of the others
+    task_ptr take(int self) {
+        if (pending.load(std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+        std::size_t n = queues.size();
+        if (self >= 0) {
+            auto& own = *queues[static_cast<std::size_t>(self)];
+            std::lock_guard<std::mutex> guard(own.mutex);
+            if (!own.tasks.empty()) {
+                task_ptr t = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                return t;
+            }
+        }
+        std::size_t start = self >= 0 ? static_cast<std::size_t>(self) + 1 : 0;
+        for (std::size_t k = 0; k < n; ++k) {
+            auto& victim = *queues[(start + k) % n];
+            std::lock_guard<std::mutex> guard(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task_ptr t = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                return t;
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename Done>
+    void help_until(Done done) {
+        int self = self_index();
+        while (!done()) {
+            if (task_ptr t = take(self)) {
+                t->run();
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void worker_loop(unsigned index) {
+        current_pool = this;
+        current_index = static_cast<int>(index);
+        while (true) {
+            if (task_ptr t = take(static_cast<int>(index))) {
+                t->run();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            wakeup.wait(lock, [this] { return stopping || pending.load(std::memory_order_acquire) > 0; });
+            if (stopping && pending.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    static inline thread_local const thread_pool* current_pool = nullptr;
+    static inline thread_local int current_index = -1;
+
+    std::vector<std::unique_ptr<worker_queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> pending {0};
+    std::atomic<std::size_t> next_queue {0};
+    std::atomic<std::size_t> tuned_grain {0};
+    std::mutex sleep_mutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+};
+
+
+#endif //EFFECTIVECPP_THREAD_POOL_H
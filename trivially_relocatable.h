@@ -0,0 +1,50 @@
+#ifndef EFFECTIVECPP_TRIVIALLY_RELOCATABLE_H
+#define EFFECTIVECPP_TRIVIALLY_RELOCATABLE_H
+
+/*
+ * is_trivially_relocatable<T>: moving a T to a new address and destroying the old
+ * one is the same as memcpy'ing its bytes and forgetting the old copy.
+ * True by default for trivially copyable types; a class opts in with a member
+ *     using trivially_relocatable = std::true_type;
+ * (same idea as vector_like in vector_like.h) or by specializing the trait.
+ *
+ * Most types that own a heap pointer qualify: unique_ptr, shared_ptr, vector.
+ * libstdc++'s std::string does NOT: a short string points into its own SSO buffer,
+ * so a memcpy'd copy would point back into the old object. Structs holding a
+ * std::string (Marker, Fish) therefore stay on the per-element path.
+ */
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+template<typename T, typename = void>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+template<typename T>
+struct is_trivially_relocatable<T, std::void_t<typename T::trivially_relocatable>> : T::trivially_relocatable {};
+
+template<typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// for structs that are relocatable exactly when all their members are
+template<typename... Ts>
+inline constexpr bool all_trivially_relocatable_v = (is_trivially_relocatable_v<Ts> && ...);
+
+template<typename T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+template<typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+template<typename T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+template<typename A, typename B>
+struct is_trivially_relocatable<std::pair<A, B>>
+    : std::bool_constant<all_trivially_relocatable_v<A, B>> {};
+#if defined(__GLIBCXX__) || defined(_LIBCPP_VERSION)
+// three pointers in both, no self references
+template<typename T>
+struct is_trivially_relocatable<std::vector<T>> : std::true_type {};
+#endif
+
+
+#endif //EFFECTIVECPP_TRIVIALLY_RELOCATABLE_H
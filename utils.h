@@ -1,7 +1,16 @@
 #ifndef EFFECTIVECPP_UTILS_H
 #define EFFECTIVECPP_UTILS_H
 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <locale>
+#include <memory_resource>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -11,6 +20,8 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/fusion/adapted/std_tuple.hpp>
 #include <boost/fusion/algorithm/iteration/for_each.hpp>
+#include "vector_like.h"
+#include "logger.h"
 
 using namespace std;
 
@@ -20,29 +31,6 @@ using namespace std;
 // static_assert(dependent_false<T>::value, "error message");
 template<class T> struct dependent_false : std::false_type {};
 
-template <typename OstreamT, typename T>  // to work with both
-OstreamT& operator<<(OstreamT& oss, const vector<T>& vec) {
-    if constexpr (std::is_base_of_v<std::ostream, OstreamT>) {
-        oss << "[";
-        string delim = "";
-        for (auto& i : vec) {
-            oss << delim << i;
-            delim = ", ";
-        }
-        oss << "]";
-        return oss;
-    }
-    else {
-        /* test with this:
-         struct BadOstream {
-            int operator<<(int shit) {return 0;}
-         };
-         */
-        static_assert(dependent_false<T>::value, "vector must be written to ostream subclasses");
-    }
-}
-
-
 /*
  * Convert anything to string, just like python print
  */
@@ -112,7 +100,7 @@ string tuple_str(const TupleT& tup) {
 
 template<typename TupleT>
 void ptuple(const TupleT& tup) {
-    cout << tuple_str(tup) << endl;
+    LOG_INFO(tuple_str(tup));
 }
 
 template<typename T>
@@ -126,7 +114,7 @@ string type_str() {
  */
 template<typename T>
 void ptype() {
-    cout << "type= " << type_str<T>() << endl;
+    LOG_INFO("type= ", type_str<T>());
 }
 
 /**
@@ -135,12 +123,108 @@ void ptype() {
  */
 template<typename T>
 void ptype(const T& param) {
-    cout << "type= " << type_str<T>() << endl;
+    LOG_INFO("type= ", type_str<T>());
+}
+
+
+/*
+ * The same text in a std::pmr::string, with every allocation going to mr: a
+ * monotonic_buffer_resource over a stack buffer keeps short results off the
+ * global heap entirely.
+ *   char scratch[1024];
+ *   std::pmr::monotonic_buffer_resource arena(scratch, sizeof(scratch));
+ *   std::pmr::string s = any_str(&arena, "x=", x, " v=", vec);
+ * pmr_ostringstream writes straight into the string it returns, grown through mr.
+ */
+class pmr_ostringstream : public std::ostream {
+public:
+    explicit pmr_ostringstream(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+    : std::ostream(nullptr), buf(mr) {
+        rdbuf(&buf);
+    }
+
+    std::string_view view() const noexcept { return buf.view(); }
+    std::pmr::string str() const { return std::pmr::string(buf.view(), buf.resource()); }
+    // the text without a copy, the stream starts over empty
+    std::pmr::string release() { return buf.release(); }
+
+private:
+    // the put area is the string's own storage: no copy on the way out
+    class stringbuf : public std::streambuf {
+    public:
+        explicit stringbuf(std::pmr::memory_resource* mr) : text(mr) {}
+
+        std::string_view view() const noexcept { return {pbase(), static_cast<size_t>(pptr() - pbase())}; }
+        std::pmr::memory_resource* resource() const noexcept { return text.get_allocator().resource(); }
+
+        std::pmr::string release() {
+            text.resize(static_cast<size_t>(pptr() - pbase()));
+            setp(nullptr, nullptr);
+            std::pmr::string out(std::move(text));
+            text = std::pmr::string(out.get_allocator());
+            return out;
+        }
+
+    protected:
+        int_type overflow(int_type c) override {
+            if (traits_type::eq_int_type(c, traits_type::eof())) {
+                return traits_type::not_eof(c);
+            }
+            size_t used = static_cast<size_t>(pptr() - pbase());
+            // the spare capacity first (the short string buffer to begin with), then double
+            text.resize(used < text.capacity() ? text.capacity() : 2 * used);
+            setp(text.data(), text.data() + text.size());
+            pbump(static_cast<int>(used));
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+            return c;
+        }
+
+    private:
+        std::pmr::string text;  // [pbase, pptr) written so far, the rest is room
+    };
+
+    stringbuf buf;
+};
+
+template<typename R>
+using _enable_if_resource = std::enable_if_t<std::is_base_of_v<std::pmr::memory_resource, R>, int>;
+
+template<typename R, typename... Ts, _enable_if_resource<R> = 0>
+std::pmr::string any_str(R* mr, Ts&& ... args) {
+    pmr_ostringstream oss(mr);
+    ((oss << args), ...);
+    return oss.release();
+}
+
+template<typename R, typename... Ts, _enable_if_resource<R> = 0>
+std::pmr::string join_str(R* mr, std::string_view sep, Ts&& ... args) {
+    pmr_ostringstream oss(mr);
+    size_t i = 0;
+    ((oss << (i++ ? sep : std::string_view{}) << args), ...);
+    return oss.release();
+}
+
+// numbers get lexical_cast's precision, so the text matches tuple_str(tup)
+template<typename R, typename TupleT, _enable_if_resource<R> = 0>
+std::pmr::string tuple_str(R* mr, const TupleT& tup) {
+    pmr_ostringstream oss(mr);
+    oss << "tuple<";
+    boost::fusion::for_each(tup, [&oss](auto& s) {
+        using E = std::decay_t<decltype(s)>;
+        if constexpr (std::is_floating_point_v<E>) {
+            oss.precision(std::numeric_limits<E>::max_digits10);
+        }
+        oss << s << ", ";
+    });
+    std::pmr::string result = oss.release();
+    result.resize(result.size() - 2);
+    return result += ">";
 }
 
 
 void ptitle(string title) {
-    cout << "========== " << title << " ==========" << endl;
+    LOG_INFO("========== ", title, " ==========");
 }
 
 
@@ -152,25 +236,25 @@ public:
 
     Marker(const Marker& other) {
         if (print_enabled)
-            cout << "copy-ctor " << x << endl;
+            LOG_INFO("copy-ctor ", x);
         x = other.x;
     };
     Marker& operator=(const Marker& other) {
         if (print_enabled)
-            cout << "copy-assign " << x << endl;
+            LOG_INFO("copy-assign ", x);
         x = other.x;
         return *this;
     };
 
     Marker(Marker&& other) noexcept {
         if (print_enabled)
-            cout << "move-ctor " << x << endl;
+            LOG_INFO("move-ctor ", x);
         x = std::move(other.x);
         other.x = "__MOVE_DESTROYED__";
     };
     Marker& operator=(Marker&& other) noexcept {
         if (print_enabled)
-            cout << "move-assign " << x << endl;
+            LOG_INFO("move-assign ", x);
         x = std::move(other.x);
         other.x = "__MOVE_DESTROYED__";
         return *this;
@@ -178,7 +262,7 @@ public:
 
     ~Marker() {
         if (print_enabled)
-            cout << "dtor " << x << endl;
+            LOG_INFO("dtor ", x);
     };
 
     virtual string get() const { return x; }
@@ -0,0 +1,336 @@
+#ifndef EFFECTIVECPP_VALUE_SWITCH_H
+#define EFFECTIVECPP_VALUE_SWITCH_H
+
+/*
+ * value_switch: the switch_ of hana_switch.h, dispatching on runtime values
+ * instead of types.
+ *
+ *   using namespace value_switch_literals;
+ *   string r = value_switch(code)(
+ *       case_v<200>([] { return "ok"s; }),
+ *       case_v<404>([](int c) { return "missing " + to_string(c); }),   // handlers may take the value
+ *       default_([] { return "other"s; })
+ *   );
+ *   value_switch(method)(case_s("GET"_s)(on_get), case_s("POST"_s)(on_post), default_(on_other));
+ *
+ * Integer and enum cases are case_v<V>; string cases are case_s over a hana::string,
+ * because C++17 can't take a string literal as a template argument.
+ *
+ * The case set is known at compile time, so the lookup is planned there:
+ *   - integers spanning a range at most about twice the case count: a jump table,
+ *     x - min indexes an array of handler numbers
+ *   - sparse integers: binary search over the sorted case values
+ *   - strings: a perfect_hash over the case strings; one hash, one table load,
+ *     one string compare
+ * Either way that gives a case number, and a plain switch statement on it calls the
+ * handler, inlined.
+ * A switch with nothing but default_ calls it without looking at x.
+ * value_switch_kind_for<X>(cases...) tells which plan a case set gets.
+ */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <boost/hana.hpp>
+#include "hana_switch.h"
+#include "perfect_hash.h"
+
+namespace hana = boost::hana;
+
+
+template<auto V>
+struct value_key {
+    static constexpr auto value = V;
+};
+
+template<auto V>
+inline auto case_v = [](auto f) {
+    return hana::make_pair(value_key<V>{}, f);
+};
+
+template<char... cs>
+auto case_s(hana::string<cs...> s) {
+    return [s](auto f) { return hana::make_pair(s, f); };
+}
+
+// "GET"_s as a hana::string (a GNU extension, which GCC and Clang both accept)
+namespace value_switch_literals {
+    template<typename CharT, CharT... cs>
+    constexpr hana::string<cs...> operator""_s() {
+        static_assert(std::is_same_v<CharT, char>, "only narrow string cases");
+        return {};
+    }
+}
+
+
+enum class switch_kind { jump_table, binary_search, perfect_hash };
+
+
+namespace value_switch_detail {
+    template<typename Case>
+    using case_key_t = std::decay_t<decltype(hana::first(std::declval<Case>()))>;
+
+    template<typename Key>
+    struct is_value_key : std::false_type {};
+    template<auto V>
+    struct is_value_key<value_key<V>> : std::true_type {};
+
+    template<typename Key>
+    struct is_string_key : std::false_type {};
+    template<char... cs>
+    struct is_string_key<hana::string<cs...>> : std::true_type {
+        static constexpr char data[] = {cs..., '\0'};
+        static constexpr std::string_view view {data, sizeof...(cs)};
+    };
+
+    // call f(x) if f takes the value, f() otherwise
+    template<typename F, typename X>
+    decltype(auto) invoke_handler(F& f, const X& x) {
+        if constexpr (std::is_invocable_v<F&, const X&>) {
+            return f(x);
+        }
+        else {
+            return f();
+        }
+    }
+    template<typename F, typename X>
+    using handler_result_t = decltype(invoke_handler(std::declval<F&>(), std::declval<const X&>()));
+
+    /***************** integers *****************/
+    template<typename T>
+    using int_of_t = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>,
+                                                 std::common_type<T>>::type;
+
+    // two's complement distance, right for signed and unsigned alike
+    template<typename K>
+    constexpr std::uint64_t offset(K x, K base) noexcept {
+        return static_cast<std::uint64_t>(x) - static_cast<std::uint64_t>(base);
+    }
+
+    template<typename K, K... Vs>
+    struct int_plan {
+        static constexpr std::size_t N = sizeof...(Vs);
+        static constexpr K keys[] = {Vs...};
+
+        static constexpr K min_key() {
+            K m = keys[0];
+            for (K k : keys) {
+                m = k < m ? k : m;
+            }
+            return m;
+        }
+        static constexpr K max_key() {
+            K m = keys[0];
+            for (K k : keys) {
+                m = k > m ? k : m;
+            }
+            return m;
+        }
+        static constexpr K MIN = min_key();
+        // max - MIN, without the + 1 that wraps for a span of all 64-bit values
+        static constexpr std::uint64_t LAST = offset(max_key(), MIN);
+        static constexpr bool dense = LAST < 2 * N + 8 && LAST < 4096;
+        static constexpr std::uint64_t SPAN = dense ? LAST + 1 : 1;
+
+        // case number per value in [MIN, MIN + SPAN), N = no case
+        static constexpr auto make_table() {
+            std::array<std::uint16_t, SPAN> table {};
+            for (auto& t : table) {
+                t = static_cast<std::uint16_t>(N);
+            }
+            if constexpr (dense) {
+                for (std::size_t i = 0; i < N; ++i) {
+                    table[offset(keys[i], MIN)] = static_cast<std::uint16_t>(i);
+                }
+            }
+            return table;
+        }
+        static constexpr auto table = make_table();
+
+        // case values sorted, std::pair isn't constexpr assignable in C++17
+        struct entry {
+            K value;
+            std::size_t index;
+        };
+        static constexpr auto make_sorted() {
+            std::array<entry, N> sorted {};
+            for (std::size_t i = 0; i < N; ++i) {
+                sorted[i].value = keys[i];
+                sorted[i].index = i;
+            }
+            for (std::size_t i = 1; i < N; ++i) {
+                for (std::size_t j = i; j > 0 && sorted[j].value < sorted[j - 1].value; --j) {
+                    entry tmp = sorted[j];
+                    sorted[j] = sorted[j - 1];
+                    sorted[j - 1] = tmp;
+                }
+            }
+            return sorted;
+        }
+        static constexpr auto sorted = make_sorted();
+
+        static constexpr bool unique() {
+            for (std::size_t i = 1; i < N; ++i) {
+                if (sorted[i].value == sorted[i - 1].value) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        static_assert(unique(), "value_switch has a duplicate case");
+
+        static constexpr switch_kind kind = dense ? switch_kind::jump_table : switch_kind::binary_search;
+
+        static std::size_t find(K x) noexcept {
+            if constexpr (dense) {
+                std::uint64_t i = offset(x, MIN);
+                return i < SPAN ? table[i] : N;
+            }
+            else {
+                // without branches on the data: N is a constant, the loop unrolls into cmovs
+                const entry* base = sorted.data();
+                for (std::size_t n = N; n > 1; n -= n / 2) {
+                    base = base[n / 2].value <= x ? base + n / 2 : base;
+                }
+                return base->value == x ? base->index : N;
+            }
+        }
+    };
+
+    /***************** strings *****************/
+    template<typename... Keys>
+    struct string_plan {
+        static constexpr std::size_t N = sizeof...(Keys);
+        static constexpr perfect_hash<N> index {{is_string_key<Keys>::view...}};
+
+        static constexpr switch_kind kind = switch_kind::perfect_hash;
+
+        static std::size_t find(std::string_view x) noexcept { return index.find(x); }
+    };
+
+    /***************** planning *****************/
+    template<typename X, typename... Keys>
+    struct plan_for {
+        static constexpr bool strings = (is_string_key<Keys>::value && ...);
+        static_assert(strings || (is_value_key<Keys>::value && ...),
+                      "value_switch cases must be all case_v or all case_s");
+        static_assert(!strings || std::is_convertible_v<const X&, std::string_view>,
+                      "case_s needs a string-like switch value");
+
+        template<typename T, bool = strings>
+        struct pick {
+            using K = int_of_t<T>;
+            using type = int_plan<K, static_cast<K>(Keys::value)...>;
+        };
+        template<typename T>
+        struct pick<T, true> {
+            using type = string_plan<Keys...>;
+        };
+        using type = typename pick<X>::type;
+    };
+
+    // only a default: no lookup at all, whatever X is
+    struct default_plan {
+        static constexpr switch_kind kind = switch_kind::jump_table;
+    };
+    template<typename X>
+    struct plan_for<X> {
+        using type = default_plan;
+    };
+
+    template<std::size_t I, typename Cases, typename X>
+    decltype(auto) call_at(Cases& cases, const X& x) {
+        return invoke_handler(hana::second(std::get<I>(cases)), x);
+    }
+
+    // handler i, the default being the last one: a real switch statement for the first
+    // SWITCH_CASES handlers, so the compiler sees the same thing as a hand-written switch
+    // (and turns constant results into a lookup table), a compare chain after that
+    constexpr std::size_t SWITCH_CASES = 32;
+
+#define VALUE_SWITCH_CASE(n) \
+    case B + n: \
+        if constexpr (B + n < N) { \
+            return call_at<B + n>(cases, x); \
+        } \
+        [[fallthrough]];
+#define VALUE_SWITCH_CASES8(n) \
+    VALUE_SWITCH_CASE(n) VALUE_SWITCH_CASE(n + 1) VALUE_SWITCH_CASE(n + 2) VALUE_SWITCH_CASE(n + 3) \
+    VALUE_SWITCH_CASE(n + 4) VALUE_SWITCH_CASE(n + 5) VALUE_SWITCH_CASE(n + 6) VALUE_SWITCH_CASE(n + 7)
+
+    template<typename R, std::size_t B, typename Cases, typename X>
+    R call_case(std::size_t i, Cases& cases, const X& x) {
+        constexpr std::size_t N = std::tuple_size_v<Cases> - 1;
+        if constexpr (B + SWITCH_CASES < N) {
+            if (i >= B + SWITCH_CASES) {
+                return call_case<R, B + SWITCH_CASES>(i, cases, x);
+            }
+        }
+        switch (i) {
+            VALUE_SWITCH_CASES8(0)
+            VALUE_SWITCH_CASES8(8)
+            VALUE_SWITCH_CASES8(16)
+            VALUE_SWITCH_CASES8(24)
+            default:
+                return call_at<N>(cases, x);
+        }
+    }
+
+#undef VALUE_SWITCH_CASES8
+#undef VALUE_SWITCH_CASE
+
+    template<typename R, typename Plan, typename X, typename Cases>
+    R dispatch(const X& x, Cases& cases) {
+        std::size_t i;
+        if constexpr (Plan::kind == switch_kind::perfect_hash) {
+            i = Plan::find(std::string_view(x));
+        }
+        else {
+            i = Plan::find(static_cast<int_of_t<X>>(x));
+        }
+        return call_case<R, 0>(i, cases, x);
+    }
+}
+
+
+template<typename X, typename... Cases>
+constexpr switch_kind value_switch_kind_for(const Cases&...) {
+    return value_switch_detail::plan_for<X, value_switch_detail::case_key_t<Cases>...>::type::kind;
+}
+
+
+/*
+ * value_switch(x) returns a lambda taking the cases, exactly like switch_(arg)
+ */
+template<typename X>
+auto value_switch(const X& x) {
+    return [&x](auto... cases_) {
+        auto cases = hana::make_tuple(cases_...);
+        auto default_ = hana::find_if(cases, [](auto const& c) {
+            return hana::first(c) == hana::type_c<default_t>;
+        });
+        static_assert(!hana::is_nothing(default_), "value_switch is missing default case!");
+        auto rest = hana::filter(cases, [](auto const& c) {
+            return hana::first(c) != hana::type_c<default_t>;
+        });
+        if constexpr (decltype(hana::is_empty(rest))::value) {
+            return value_switch_detail::invoke_handler(hana::second(*default_), x);
+        }
+        else {
+            return hana::unpack(rest, [&](auto&... case_) {
+                using namespace value_switch_detail;
+                using Plan = typename plan_for<X, case_key_t<decltype(case_)>...>::type;
+                auto all = std::tie(case_..., *default_);
+                using R = std::common_type_t<handler_result_t<decltype(hana::second(case_)), X>...,
+                                             handler_result_t<decltype(hana::second(*default_)), X>>;
+                return dispatch<R, Plan>(x, all);
+            });
+        }
+    };
+}
+
+
+#endif //EFFECTIVECPP_VALUE_SWITCH_H
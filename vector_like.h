@@ -0,0 +1,248 @@
+#ifndef EFFECTIVECPP_VECTOR_LIKE_H
+#define EFFECTIVECPP_VECTOR_LIKE_H
+
+/*
+ * Which containers print like a python list through operator<<, and the operator itself.
+ * Anything vector-shaped can opt in with a member `using vector_like = std::true_type;`
+ *
+ * This lives outside utils.h so that logger.h can include it: a LOG_* template only
+ * finds a global operator<< for std::vector if it was declared before the template,
+ * whichever header is included first.
+ */
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <ios>
+#include <iterator>
+#include <locale>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+
+template<typename T, typename = void>
+struct is_vector_like : std::false_type {};
+template<typename T, typename Alloc>
+struct is_vector_like<std::vector<T, Alloc>> : std::true_type {};
+template<typename T>
+struct is_vector_like<T, std::void_t<typename T::vector_like>> : T::vector_like {};
+
+template <typename OstreamT, typename VecT,  // to work with both
+          typename = std::enable_if_t<is_vector_like<VecT>::value>>
+OstreamT& operator<<(OstreamT& oss, const VecT& vec);
+
+/*
+ * How vectors print, set per stream with manipulators (numpy's set_printoptions):
+ *   cout << vec_summary(1000, 3) << big;   // more than 1000 elements: [0, 1, 2, ..., 7, 8, 9]
+ *   cout << vec_full;                      // back to printing everything (the default)
+ *   cout << vec_shape << vec_stats;        // prefix "shape=(N,) min=.. max=.. mean=.. "
+ *   cout << vec_no_header;
+ * Numbers use the stream's precision and fixed/scientific flags, e.g. setprecision(3).
+ */
+inline const int _vec_flags_slot = std::ios_base::xalloc();
+inline const int _vec_threshold_slot = std::ios_base::xalloc();
+inline const int _vec_edge_slot = std::ios_base::xalloc();
+enum : long { _vec_summarize = 1, _vec_header_shape = 2, _vec_header_stats = 4 };
+
+struct vec_summary {
+    explicit vec_summary(size_t threshold = 1000, size_t edge_items = 3)
+    : threshold(threshold), edge_items(edge_items)
+    {}
+    size_t threshold;
+    size_t edge_items;
+};
+
+inline std::ostream& operator<<(std::ostream& os, vec_summary s) {
+    os.iword(_vec_flags_slot) |= _vec_summarize;
+    os.iword(_vec_threshold_slot) = static_cast<long>(s.threshold);
+    os.iword(_vec_edge_slot) = static_cast<long>(s.edge_items);
+    return os;
+}
+inline std::ostream& vec_full(std::ostream& os) {
+    os.iword(_vec_flags_slot) &= ~_vec_summarize;
+    return os;
+}
+inline std::ostream& vec_shape(std::ostream& os) {
+    os.iword(_vec_flags_slot) |= _vec_header_shape;
+    return os;
+}
+inline std::ostream& vec_stats(std::ostream& os) {
+    os.iword(_vec_flags_slot) |= _vec_header_stats;
+    return os;
+}
+inline std::ostream& vec_no_header(std::ostream& os) {
+    os.iword(_vec_flags_slot) &= ~(_vec_header_shape | _vec_header_stats);
+    return os;
+}
+
+// numbers that to_chars formats exactly like ostream does; bool and the char types print differently
+template<typename T>
+inline constexpr bool _is_fast_printable =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+     !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char> &&
+     !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>)
+    || std::is_floating_point_v<T>;
+
+/*
+ * Formats numbers with to_chars into a 4 KB buffer and hands it to the stream in
+ * chunks, instead of one virtual ostream call (plus sentry and locale lookup) per element.
+ * The buffer lives on the stack, so it is kept small enough for pool and pipeline workers.
+ */
+class _chunked_number_writer {
+public:
+    explicit _chunked_number_writer(std::ostream& os)
+    : os(os), precision(static_cast<int>(os.precision())) {
+        auto floatfield = os.flags() & std::ios_base::floatfield;
+        if (floatfield == std::ios_base::fixed) {
+            format = std::chars_format::fixed;
+        }
+        else if (floatfield == std::ios_base::scientific) {
+            format = std::chars_format::scientific;
+        }
+    }
+    ~_chunked_number_writer() { flush(); }
+
+    // false if the stream asks for something only ostream does: width, showpos, hex, a locale...
+    static bool usable(const std::ostream& os) {
+        auto flags = os.flags();
+        return os.width() == 0
+            && (flags & std::ios_base::basefield) == std::ios_base::dec
+            && (flags & std::ios_base::floatfield) != (std::ios_base::fixed | std::ios_base::scientific)
+            && !(flags & (std::ios_base::showpos | std::ios_base::showpoint | std::ios_base::uppercase))
+            && os.getloc() == std::locale::classic();
+    }
+
+    void put(std::string_view s) {
+        if (used + s.size() > sizeof(buf)) {
+            flush();
+        }
+        if (s.size() > sizeof(buf)) {
+            os.write(s.data(), static_cast<std::streamsize>(s.size()));
+            return;
+        }
+        std::memcpy(buf + used, s.data(), s.size());
+        used += s.size();
+    }
+
+    template<typename T>
+    void number(T value) {
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            std::to_chars_result res;
+            if constexpr (std::is_floating_point_v<T>) {
+                res = std::to_chars(buf + used, buf + sizeof(buf), value, format, precision);
+            }
+            else {
+                res = std::to_chars(buf + used, buf + sizeof(buf), value);
+            }
+            if (res.ec == std::errc()) {
+                used = static_cast<size_t>(res.ptr - buf);
+                return;
+            }
+            flush();  // the buffer was too full
+        }
+        os << value;  // longer than the whole buffer, e.g. a huge long double in fixed
+    }
+
+    void flush() {
+        os.write(buf, static_cast<std::streamsize>(used));
+        used = 0;
+    }
+
+private:
+    std::ostream& os;
+    int precision;
+    std::chars_format format = std::chars_format::general;
+    size_t used = 0;
+    char buf[1 << 12];
+};
+
+template<typename VecT>
+void _print_vector(std::ostream& os, const VecT& vec) {
+    using T = std::decay_t<decltype(*std::begin(vec))>;
+    const size_t n = static_cast<size_t>(std::distance(std::begin(vec), std::end(vec)));
+    const long flags = os.iword(_vec_flags_slot);
+
+    if (flags & (_vec_header_shape | _vec_header_stats)) {
+        if (flags & _vec_header_shape) {
+            os << "shape=(" << n << ",) ";
+        }
+        if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+            if ((flags & _vec_header_stats) && n > 0) {
+                T lo = *std::begin(vec), hi = lo;
+                long double total = 0;
+                for (const T& x : vec) {
+                    lo = x < lo ? x : lo;
+                    hi = hi < x ? x : hi;
+                    total += x;
+                }
+                os << "min=" << +lo << " max=" << +hi << " mean=" << static_cast<double>(total / n) << " ";
+            }
+        }
+    }
+
+    // [0, edge) and [n - edge, n) when summarizing, everything otherwise
+    size_t edge = n;
+    if ((flags & _vec_summarize) && n > static_cast<size_t>(os.iword(_vec_threshold_slot))) {
+        edge = std::min(n / 2, static_cast<size_t>(os.iword(_vec_edge_slot)));
+    }
+    auto skip_from = edge, skip_to = n - edge;
+
+    if constexpr (_is_fast_printable<T>) {
+        if (_chunked_number_writer::usable(os)) {
+            _chunked_number_writer out(os);
+            out.put("[");
+            size_t i = 0;
+            for (auto it = std::begin(vec); i < n; ++it, ++i) {
+                if (i == skip_from && skip_from < skip_to) {
+                    out.put(i ? ", ..." : "...");
+                    std::advance(it, skip_to - i);
+                    i = skip_to;
+                    if (i == n) {
+                        break;
+                    }
+                }
+                if (i) {
+                    out.put(", ");
+                }
+                out.number(*it);
+            }
+            out.put("]");
+            return;
+        }
+    }
+
+    os << "[";
+    const char* delim = "";
+    size_t i = 0;
+    for (auto it = std::begin(vec); i < n; ++it, ++i) {
+        if (i == skip_from && skip_from < skip_to) {
+            os << delim << "...";
+            std::advance(it, skip_to - i);
+            i = skip_to;
+            if (i == n) {
+                break;
+            }
+        }
+        os << delim << *it;
+        delim = ", ";
+    }
+    os << "]";
+}
+
+// declared above, so _print_vector finds it for nested vectors
+template <typename OstreamT, typename VecT, typename>
+OstreamT& operator<<(OstreamT& oss, const VecT& vec) {
+    /* test with this:
+     struct BadOstream {
+        int operator<<(int shit) {return 0;}
+     };
+     */
+    static_assert(std::is_base_of_v<std::ostream, OstreamT>, "vector must be written to ostream subclasses");
+    _print_vector(oss, vec);
+    return oss;
+}
+
+
+#endif //EFFECTIVECPP_VECTOR_LIKE_H
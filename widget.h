@@ -0,0 +1,93 @@
+#ifndef EFFECTIVECPP_WIDGET_H
+#define EFFECTIVECPP_WIDGET_H
+
+/*
+ * Widget and SubWidget from item 12 (reference qualifiers), shared by
+ * ch3_class_qualifier and bench_cow_widget.
+ *
+ * The values buffer is a copy-on-write handle (cow.h): copying a Widget or taking
+ * a snapshot() shares the buffer, and only mutable access through get() & detaches.
+ * The reference get() & returns stays writable, so from then on copies and
+ * snapshots of that Widget clone the buffer instead of sharing it.
+ */
+#include <iostream>
+#include <vector>
+#include "cow.h"
+
+
+class Widget {
+public:
+    using DataType = std::vector<double>;
+
+    Widget() = default;
+    explicit Widget(DataType values)
+    : values(std::move(values))
+    {}
+    // spelled out: the virtual destructor alone would turn every move into a copy
+    Widget(const Widget&) = default;
+    Widget(Widget&&) noexcept = default;
+    Widget& operator=(const Widget&) = default;
+    Widget& operator=(Widget&&) noexcept = default;
+    virtual ~Widget() = default;
+
+    // lvalue reference qualifier: mutable access, detaches a shared buffer first
+    // and keeps later copies from sharing it
+    virtual DataType& get() & {
+        if (print_enabled)
+            std::cout << "lvalue function" << std::endl;
+        return values.write();
+    }
+    // rvalue reference qualifier: the Widget is about to die, so really move the buffer out
+    virtual DataType get() && {
+        if (print_enabled)
+            std::cout << "rvalue function" << std::endl;
+        return std::move(values).take();
+    }
+    /*
+     * const rvalue: std::move(values) on a const member is a const&&, which binds to
+     * the copy ctor, so this always copied. Now it says so, and only const
+     * temporaries end up here.
+     */
+    virtual DataType get() const && {
+        if (print_enabled)
+            std::cout << "const rvalue function" << std::endl;
+        return values.read();
+    }
+
+    // read-only access, never copies
+    const DataType& view() const & { return values.read(); }
+    // shares the buffer until either side writes
+    cow<DataType> snapshot() const { return values; }
+
+    static inline bool print_enabled = true;
+
+protected:
+    cow<DataType> values;
+};
+
+
+class SubWidget : public Widget {
+public:
+    using Widget::Widget;
+
+    // lvalue reference qualifier
+    DataType& get() & override {
+        if (print_enabled)
+            std::cout << "sub lvalue function" << std::endl;
+        return values.write();
+    }
+    // rvalue reference qualifier
+    DataType get() && override {
+        if (print_enabled)
+            std::cout << "sub rvalue function" << std::endl;
+        return std::move(values).take();
+    }
+    DataType get() const && override {  // const qualifier must match superclass
+        if (print_enabled)
+            std::cout << "sub const rvalue function" << std::endl;
+        return values.read();
+    }
+};
+
+
+#endif //EFFECTIVECPP_WIDGET_H